@@ -0,0 +1,260 @@
+#include "async.h"
+#include "context.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pim{
+
+    /** The number of entries in the queue */
+    constexpr uint64_t ASYNC_QUEUE_SIZE = 1 << 14;
+    /** The number of polls of an empty (or full) queue before the waiting thread starts sleeping */
+    constexpr size_t ASYNC_SPIN_POLLS = 1 << 10;
+
+    /**
+     * A queued call of the simulator
+     */
+    struct QueueEntry {
+
+        /** The kinds of queued calls */
+        enum Kind { OPERATION, READ, BEGIN_ROUTINE, END_ROUTINE };
+        Kind kind;
+
+        /** The micro-operation, and the routine (for BEGIN_ROUTINE) */
+        otype operation;
+        Routine routine;
+
+        /** The promise of the result (for READ) */
+        std::promise<dtype> *result;
+
+    };
+
+    /** The queue, the index of the next entry to push (head), and the index of the next entry to perform (tail) */
+    std::vector<QueueEntry> queue;
+    std::atomic<uint64_t> queueHead(0), queueTail(0);
+
+    /** The executor thread, and whether the current thread is the executor thread */
+    std::thread executor;
+    thread_local bool onExecutor = false;
+    /** Whether the asynchronous mode is enabled */
+    bool asyncEnabled = false;
+
+    /** Whether the executor thread is stopping, or sleeping on the condition variable */
+    std::atomic<bool> executorStopping(false), executorSleeping(false);
+    std::mutex executorMutex;
+    std::condition_variable executorWakeup;
+
+    /** The first error of a queued call since the last drain (written by the executor thread) */
+    std::exception_ptr queueError;
+
+    /**
+     * Performs the given queued call on the executor thread
+     * @param entry
+     */
+    void performEntry(QueueEntry& entry){
+
+        // After an error, the remaining calls are discarded until the error is thrown by a drain, except for the mask
+        // updates (which the driver already recorded as its current masks when they were queued)
+        if(queueError){
+            if(entry.kind == QueueEntry::READ) entry.result->set_exception(queueError);
+            if(entry.kind == QueueEntry::OPERATION && (entry.operation & 0x3) == MicrooperationType::MASK){
+                try{
+                    perform(entry.operation);
+                } catch(...){}
+            }
+            return;
+        }
+
+        try{
+            switch(entry.kind){
+                case QueueEntry::OPERATION:
+                    perform(entry.operation);
+                    break;
+                case QueueEntry::READ:
+                    entry.result->set_value(perform(entry.operation));
+                    break;
+                case QueueEntry::BEGIN_ROUTINE:
+                    beginRoutine(entry.routine);
+                    break;
+                case QueueEntry::END_ROUTINE:
+                    endRoutine();
+                    break;
+            }
+        } catch(...){
+            queueError = std::current_exception();
+            if(entry.kind == QueueEntry::READ) entry.result->set_exception(queueError);
+        }
+
+    }
+
+    /**
+     * The loop of the executor thread
+     */
+    void executorLoop(){
+
+        onExecutor = true;
+        size_t polls = 0;
+        while(true){
+
+            uint64_t tail = queueTail.load(std::memory_order_relaxed);
+            if(tail == queueHead.load(std::memory_order_acquire)){
+                if(executorStopping.load()) return;
+                if(++polls < ASYNC_SPIN_POLLS){
+                    std::this_thread::yield();
+                    continue;
+                }
+                // Sleep until the next push (the flag is set before checking the queue, see push)
+                std::unique_lock<std::mutex> lock(executorMutex);
+                executorSleeping.store(true);
+                executorWakeup.wait(lock, [tail]{ return queueHead.load() != tail || executorStopping.load(); });
+                executorSleeping.store(false);
+                continue;
+            }
+            polls = 0;
+
+            QueueEntry& entry = queue[tail % ASYNC_QUEUE_SIZE];
+            performEntry(entry);
+            if(entry.kind == QueueEntry::READ) delete entry.result;
+
+            // Once the queue is empty, the buffered logic operations are started on the device (before the entry is
+            // completed, so that a drained queue implies an idle executor)
+            if(queueHead.load(std::memory_order_acquire) == tail + 1 && !queueError){
+                try{
+                    flushLogic();
+                } catch(...){
+                    queueError = std::current_exception();
+                }
+            }
+            queueTail.store(tail + 1, std::memory_order_release);
+
+        }
+
+    }
+
+    /**
+     * Pushes the given entry into the queue, waking the executor thread if it is sleeping
+     * @param entry
+     */
+    void push(const QueueEntry& entry){
+
+        uint64_t head = queueHead.load(std::memory_order_relaxed);
+        while(head - queueTail.load(std::memory_order_acquire) == ASYNC_QUEUE_SIZE) std::this_thread::yield();
+        queue[head % ASYNC_QUEUE_SIZE] = entry;
+        queueHead.store(head + 1);
+
+        if(executorSleeping.load()){
+            std::lock_guard<std::mutex> lock(executorMutex);
+            executorWakeup.notify_one();
+        }
+
+    }
+
+    /**
+     * Stops the executor thread (at exit)
+     */
+    void stopExecutor(){
+        if(!executor.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(executorMutex);
+            executorStopping.store(true);
+            executorWakeup.notify_one();
+        }
+        executor.join();
+        executorStopping.store(false);
+    }
+
+    void setAsync(bool enabled){
+
+        if(onExecutor || enabled == asyncEnabled) return;
+
+        if(enabled){
+            static bool registered = false;
+            if(!registered){
+                atexit(stopExecutor);
+                registered = true;
+            }
+            queue.resize(ASYNC_QUEUE_SIZE);
+            asyncEnabled = true;
+            executor = std::thread(executorLoop);
+        }
+        else{
+            // The error (if any) is thrown after the executor thread is stopped
+            try{
+                drainQueue();
+            } catch(...){
+                asyncEnabled = false;
+                stopExecutor();
+                throw;
+            }
+            asyncEnabled = false;
+            stopExecutor();
+        }
+
+    }
+
+    std::future<dtype> performAsync(otype operation){
+
+        if(queueActive()){
+            if((operation & 0x3) == MicrooperationType::READ) return enqueueRead(operation);
+            enqueueOperation(operation);
+        }
+        else{
+            dtype result = perform(operation);
+            std::promise<dtype> promise;
+            promise.set_value(result);
+            return promise.get_future();
+        }
+
+        std::promise<dtype> promise;
+        promise.set_value(0);
+        return promise.get_future();
+
+    }
+
+    bool queueActive(){
+        return asyncEnabled && !onExecutor && &getContext() == &processContext();
+    }
+
+    void enqueueOperation(otype operation){
+        push({QueueEntry::OPERATION, operation, {}, nullptr});
+    }
+
+    std::future<dtype> enqueueRead(otype operation){
+        auto *result = new std::promise<dtype>();
+        std::future<dtype> future = result->get_future();
+        push({QueueEntry::READ, operation, {}, result});
+        return future;
+    }
+
+    void enqueueBeginRoutine(const Routine& routine){
+        push({QueueEntry::BEGIN_ROUTINE, 0, routine, nullptr});
+    }
+
+    void enqueueEndRoutine(){
+        push({QueueEntry::END_ROUTINE, 0, {}, nullptr});
+    }
+
+    void drainQueue(){
+
+        if(!queueActive()) return;
+
+        uint64_t head = queueHead.load(std::memory_order_relaxed);
+        size_t polls = 0;
+        while(queueTail.load(std::memory_order_acquire) != head){
+            if(++polls < ASYNC_SPIN_POLLS) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+
+        if(queueError){
+            std::exception_ptr error = queueError;
+            queueError = nullptr;
+            std::rethrow_exception(error);
+        }
+
+    }
+
+}
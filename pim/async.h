@@ -0,0 +1,74 @@
+#ifndef CUDAPIM_ASYNC_H
+#define CUDAPIM_ASYNC_H
+
+#include <future>
+#include "constants.h"
+#include "simulator.cuh"
+
+namespace pim{
+
+    /**
+     * In the asynchronous mode, the micro-operations and routine markers are pushed into a single-producer
+     * single-consumer queue that is consumed by an executor thread, so that the host program continues (e.g., with
+     * host computation) while they are simulated. Reads through performAsync return futures that block only on use,
+     * while every other simulator function (e.g., synchronize) first waits for the queue to drain. Errors of queued
+     * micro-operations are thrown by the next read or drain.
+     */
+
+    /**
+     * Enables (or disables) the asynchronous mode, starting (or stopping) the executor thread
+     * @param enabled
+     */
+    void setAsync(bool enabled);
+
+    /**
+     * Performs the given micro-operation, returning a future of its result (resolved when it is performed)
+     * @param operation
+     * @return
+     */
+    std::future<dtype> performAsync(otype operation);
+
+    /**
+     * Whether the calls of the current thread are queued (the asynchronous mode is enabled, and the current thread is
+     * neither the executor thread nor in a context other than the process context)
+     * @return
+     */
+    bool queueActive();
+
+    /**
+     * Queues the given micro-operation (that is not a read)
+     * @param operation
+     */
+    void enqueueOperation(otype operation);
+
+    /**
+     * Queues the given read micro-operation
+     * @param operation
+     * @return a future of the result
+     */
+    std::future<dtype> enqueueRead(otype operation);
+
+    /**
+     * Queues the start of the given routine
+     * @param routine
+     */
+    void enqueueBeginRoutine(const Routine& routine);
+
+    /**
+     * Queues the end of the current routine
+     */
+    void enqueueEndRoutine();
+
+    /**
+     * Waits for the executor thread to perform every queued call, throwing the first error that it encountered
+     */
+    void drainQueue();
+
+    /**
+     * Flushes the buffered logic operations (used by the executor thread when the queue is empty)
+     */
+    void flushLogic();
+
+}
+
+#endif // CUDAPIM_ASYNC_H
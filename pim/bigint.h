@@ -0,0 +1,59 @@
+#ifndef CUDAPIM_BIGINT_H
+#define CUDAPIM_BIGINT_H
+
+#include <cstdint>
+#include <type_traits>
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * Unsigned integer of N bits (a power of two words), stored across N / 32 consecutive rows of a register in
+     * pim::vector<uint_t<N>> (see pim::RegisterRows), whose routines are performed per word and chain the carries
+     * across the rows of every element (see pim/generator.h). The arithmetic is modulo 2^N, as for uint32_t.
+     * @tparam N
+     */
+    template <uint32_t N>
+    struct uint_t {
+
+        static_assert(N % 32 == 0 && N >= 64 && N <= 32 * CROSSBAR_HEIGHT && ((N / 32) & (N / 32 - 1)) == 0,
+                "pim::uint_t: the width must be a power of two words, from two words to the height of a crossbar.");
+
+        /** The number of bits and of words */
+        static constexpr uint32_t bits = N, words = N / 32;
+
+        /** The words of the value (the least significant first) */
+        uint32_t word[N / 32] = {};
+
+        uint_t() = default;
+
+        uint_t(uint64_t x){
+            word[0] = (uint32_t) x;
+            word[1] = (uint32_t) (x >> 32);
+        }
+
+        friend bool operator==(const uint_t& a, const uint_t& b){
+            for(uint32_t k = 0; k < words; k++){
+                if(a.word[k] != b.word[k]) return false;
+            }
+            return true;
+        }
+
+        friend bool operator!=(const uint_t& a, const uint_t& b){
+            return !(a == b);
+        }
+
+    };
+
+    /**
+     * Whether the given type is a big integer type
+     * @tparam T
+     */
+    template <class T>
+    struct isBigInt : std::false_type {};
+    template <uint32_t N>
+    struct isBigInt<uint_t<N>> : std::true_type {};
+
+}
+
+#endif // CUDAPIM_BIGINT_H
@@ -90,6 +90,42 @@ namespace pim {
         /** The register address of the address */
         size_t reg;
 
+        /** The partition of the address within the register (for the elements of a single partition, e.g., pim::mask),
+         * or -1 for the whole register */
+        size_t partition = -1;
+
+    };
+
+    /**
+     * The two co-located registers that store the elements wider than a word (e.g., int64_t and double): the low words
+     * of the elements in low, and the high words in high
+     */
+    struct RegisterPair {
+        size_t low, high;
+    };
+
+    /**
+     * A single partition of a register, which stores an element of a single bit (e.g., pim::mask, whose vectors share
+     * the partitions of their registers)
+     */
+    struct RegisterBit {
+        size_t reg, partition;
+    };
+
+    /**
+     * The predicates of a single bit that are computed from a value (e.g., the difference of a comparison), scoped as
+     * their names are those of native operations
+     */
+    enum class Predicate{
+        NEGATIVE, ZERO, NON_POSITIVE
+    };
+
+    /**
+     * A register whose elements span several consecutive rows (e.g., pim::uint_t<N>): word k of element i (the least
+     * significant first) in row i * words + k, where words is a power of two (so that no element crosses crossbars)
+     */
+    struct RegisterRows {
+        size_t reg, words;
     };
 
 }
@@ -0,0 +1,37 @@
+#include "context.h"
+#include "simulator.cuh"
+
+namespace pim{
+
+    /** The current context of the thread (null for the process context) */
+    thread_local context *currentContext = nullptr;
+
+    context::context(size_t firstCrossbar, size_t numCrossbars) :
+            crossbars(firstCrossbar, firstCrossbar + numCrossbars - 1, 1),
+            handle(createSimulatorContext(firstCrossbar, numCrossbars)),
+            driverCrossbarMask(crossbars), driverRowMask(ALL_ROWS), lastCrossbar(firstCrossbar) {}
+
+    context::context() : crossbars(ALL_CROSSBARS), handle(0), driverCrossbarMask(ALL_CROSSBARS),
+            driverRowMask(ALL_ROWS), lastCrossbar(0) {}
+
+    context::~context(){
+        if(handle == 0) return;
+        if(currentContext == this) setContext(processContext());
+        destroySimulatorContext(handle);
+    }
+
+    context& processContext(){
+        static context process;
+        return process;
+    }
+
+    void setContext(context& ctx){
+        selectSimulatorContext(ctx.handle);
+        currentContext = &ctx == &processContext() ? nullptr : &ctx;
+    }
+
+    context& getContext(){
+        return currentContext ? *currentContext : processContext();
+    }
+
+}
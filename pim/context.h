@@ -0,0 +1,78 @@
+#ifndef CUDAPIM_CONTEXT_H
+#define CUDAPIM_CONTEXT_H
+
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * An execution context owns a partition of the crossbars, together with its own state in every layer: the masks
+     * and the buffer of logic operations of the simulator, the masks cached by the driver, and the allocation of
+     * vectors within the partition. Every host thread operates in its current context (initially, the process
+     * context that owns all crossbars), so that several threads may concurrently drive contexts of disjoint partitions.
+     * The micro-operations of the contexts are serialized in the simulator, which holds a single memory state.
+     */
+    class context {
+
+    public:
+
+        /**
+         * Creates a context owning the given crossbars (disjoint from the crossbars of the other contexts)
+         * @param firstCrossbar
+         * @param numCrossbars
+         */
+        context(size_t firstCrossbar, size_t numCrossbars);
+
+        /**
+         * Destroys the context, performing its buffered micro-operations. The context should not be current in any
+         * other thread.
+         */
+        ~context();
+
+        context(const context&) = delete;
+        context& operator=(const context&) = delete;
+
+        /** The crossbars owned by the context */
+        const RangeMask crossbars;
+
+        /** The handle of the simulator state of the context */
+        const size_t handle;
+
+        /** The latest crossbar mask and row mask set by the driver in the context */
+        RangeMask driverCrossbarMask, driverRowMask;
+
+        /** The crossbar from which the allocator searches for free registers (unused by the process context, whose
+         * position is part of the allocator state) */
+        size_t lastCrossbar;
+
+    private:
+
+        /**
+         * Creates the process context
+         */
+        context();
+        friend context& processContext();
+
+    };
+
+    /**
+     * Returns the process context, which owns all crossbars
+     * @return
+     */
+    context& processContext();
+
+    /**
+     * Selects the current context of the calling thread
+     * @param ctx
+     */
+    void setContext(context& ctx);
+
+    /**
+     * Returns the current context of the calling thread
+     * @return
+     */
+    context& getContext();
+
+}
+
+#endif // CUDAPIM_CONTEXT_H
@@ -1,26 +1,27 @@
+#include <string>
+#include <type_traits>
 #include "driver.h"
+#include "async.h"
+#include "bigint.h"
+#include "context.h"
+#include "fixed.h"
+#include "floating.h"
+#include "generator.h"
+#include "packed.h"
 #include "simulator.cuh"
 
 namespace pim{
 
-    /**
-     * The latest crossbar mask
-     */
-    RangeMask driverCrossbarMask = ALL_CROSSBARS;
-    /**
-     * The latest row mask
-     */
-    RangeMask driverRowMask = ALL_ROWS;
-
     /**
      * Updates the crossbar mask to the given mask
      * @param mask
      */
     void driverSetCrossbarMask(RangeMask mask) {
-        if(driverCrossbarMask != mask) {
+        context& ctx = getContext();
+        if(ctx.driverCrossbarMask != mask) {
             perform(((((((mask.step << LOG_NUM_CROSSBARS) | mask.stop) << LOG_NUM_CROSSBARS) | mask.start) << 1) << 2) |
                     MicrooperationType::MASK);
-            driverCrossbarMask = mask;
+            ctx.driverCrossbarMask = mask;
         }
     }
 
@@ -29,26 +30,86 @@ namespace pim{
      * @param mask
      */
     void driverSetRowMask(RangeMask mask) {
-        if(driverRowMask != mask) {
+        context& ctx = getContext();
+        if(ctx.driverRowMask != mask) {
             perform((((((((mask.step << LOG_CROSSBAR_HEIGHT) | mask.stop) << LOG_CROSSBAR_HEIGHT) | mask.start) << 1) |
                       1) << 2) | MicrooperationType::MASK);
-            driverRowMask = mask;
+            ctx.driverRowMask = mask;
         }
     }
 
+    /**
+     * Forgets the latest masks (of the current context), so that the next routine sets its masks explicitly
+     */
+    void driverResetMasks() {
+        context& ctx = getContext();
+        ctx.driverCrossbarMask = RangeMask(-1, -1, -1);
+        ctx.driverRowMask = RangeMask(-1, -1, -1);
+    }
+
+    void beginCapture(){
+        // The graph should set its masks explicitly, as they may differ when it is launched
+        driverResetMasks();
+        beginGraphCapture();
+    }
+
+    Graph endCapture(){
+        return endGraphCapture();
+    }
+
+    void launch(const Graph& graph, const std::map<size_t, size_t>& registers){
+        launchGraph(graph, registers, nullptr);
+        driverResetMasks();
+    }
+
+    void launch(const Graph& graph, const std::map<size_t, size_t>& registers, RangeMask crossbars){
+        launchGraph(graph, registers, &crossbars);
+        driverResetMasks();
+    }
+
     dtype read(size_t crossbar, size_t reg, size_t row){
 
+        // Mark the start of the routine
+        beginRoutine({"read", NativeOperation::NONE, false, reg, reg, reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask({crossbar, crossbar, 1});
+        driverSetRowMask({row, row, 1});
+
+        // Perform the read micro-operation
+        dtype result = perform((reg << 2) | MicrooperationType::READ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+        return result;
+
+    }
+
+    std::future<dtype> readAsync(size_t crossbar, size_t reg, size_t row){
+
+        // Mark the start of the routine
+        beginRoutine({"read", NativeOperation::NONE, false, reg, reg, reg});
+
         // Update the masks if necessary
         driverSetCrossbarMask({crossbar, crossbar, 1});
         driverSetRowMask({row, row, 1});
 
         // Perform the read micro-operation
-        return perform((reg << 2) | MicrooperationType::READ);
+        std::future<dtype> result = performAsync((reg << 2) | MicrooperationType::READ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+        return result;
 
     }
 
     void write(size_t crossbar, size_t reg, size_t row, dtype data){
 
+        // Mark the start of the routine
+        beginRoutine({"write", NativeOperation::NONE, false, reg, reg, reg});
+
         // Update the masks if necessary
         driverSetCrossbarMask({crossbar, crossbar, 1});
         driverSetRowMask({row, row, 1});
@@ -56,10 +117,16 @@ namespace pim{
         // Perform the write micro-operation
         perform(((reg | ((otype)(data) << LOG_CROSSBAR_R)) << 2) | MicrooperationType::WRITE);
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     void write(RangeMask crossbars, size_t reg, RangeMask rows, dtype data){
 
+        // Mark the start of the routine
+        beginRoutine({"write", NativeOperation::NONE, false, reg, reg, reg});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -67,11 +134,17 @@ namespace pim{
         // Perform the write micro-operation
         perform(((reg | ((otype)(data) << LOG_CROSSBAR_R)) << 2) | MicrooperationType::WRITE);
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void add<int>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"add<int>", NativeOperation::ADD, false, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -173,11 +246,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000e03ba | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void add<float>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"add<float>", NativeOperation::ADD, true, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1551,11 +1630,17 @@ namespace pim{
         perform(0x1b581fffff2 | (regZ << 25));
         perform(0x1ffc1fffff2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void negate<int>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"negate<int>", NativeOperation::NEGATE, false, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1647,11 +1732,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000d037a | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void negate<float>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"negate<float>", NativeOperation::NEGATE, true, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1663,11 +1754,17 @@ namespace pim{
         perform(0x1f0000f83f2 | (regZ << 25));
         perform(0x1ffc1f07c12 | (regX << 5) | (regX << 15) | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void absolute<int>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"absolute<int>", NativeOperation::ABSOLUTE, false, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1783,11 +1880,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000d037a | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void absolute<float>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"absolute<float>", NativeOperation::ABSOLUTE, true, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1799,11 +1902,17 @@ namespace pim{
         perform(0x1f0000f83f2 | (regZ << 25));
         perform(0x1ffc1f07c02 | (regZ << 5) | (regZ << 15) | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void subtract<int>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"subtract<int>", NativeOperation::SUBTRACT, false, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -1908,11 +2017,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000d839a | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void subtract<float>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows) {
 
+        // Mark the start of the routine
+        beginRoutine({"subtract<float>", NativeOperation::SUBTRACT, true, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -3291,11 +3406,17 @@ namespace pim{
         perform(0x1b581ff7fd2 | (regZ << 25));
         perform(0x1ffc1ff7fd2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void multiply<int>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"multiply<int>", NativeOperation::MULTIPLY, false, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -4458,11 +4579,17 @@ namespace pim{
         perform(0x2f03c1c877a);
         perform(0x2e87c2c8b7a);
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void multiply<float>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"multiply<float>", NativeOperation::MULTIPLY, true, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -6051,11 +6178,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000f83f2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void divide<int>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"divide<int>", NativeOperation::DIVIDE, false, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -10242,11 +10375,17 @@ namespace pim{
         perform(0x1f83e0f83ea);
         perform(0x1003c000012 | (regZ << 5) | (regZ << 15));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void divide<float>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"divide<float>", NativeOperation::DIVIDE, true, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -14391,11 +14530,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000f83f2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void modulo<int>(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
 
+        // Mark the start of the routine
+        beginRoutine({"modulo<int>", NativeOperation::MODULO, false, regX, regY, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -18690,11 +18835,17 @@ namespace pim{
         perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
         perform(0x1f8000d839a | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void sign<int>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows) {
 
+        // Mark the start of the routine
+        beginRoutine({"sign<int>", NativeOperation::SIGN, false, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -18715,11 +18866,17 @@ namespace pim{
         perform(0x2f87e000012 | (regZ << 5) | (regZ << 15));
         perform(0x2f8401f87f2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void sign<float>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows) {
 
+        // Mark the start of the routine
+        beginRoutine({"sign<float>", NativeOperation::SIGN, true, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -18740,11 +18897,17 @@ namespace pim{
         perform(0x2f87e000012 | (regZ << 5) | (regZ << 15));
         perform(0x2f8401f87f2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void zero<int>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows) {
 
+        // Mark the start of the routine
+        beginRoutine({"zero<int>", NativeOperation::ZERO, false, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -18780,11 +18943,17 @@ namespace pim{
         perform(0x2f87c000012 | (regZ << 5) | (regZ << 15));
         perform(0x2f8401f07d2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
     template <>
     void zero<float>(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows) {
 
+        // Mark the start of the routine
+        beginRoutine({"zero<float>", NativeOperation::ZERO, true, regX, regX, regZ});
+
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
@@ -18820,97 +18989,1255 @@ namespace pim{
         perform(0x2f87c000012 | (regZ << 5) | (regZ << 15));
         perform(0x2f8401f07d2 | (regZ << 25));
 
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
-    void bitwiseNot(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+    /**
+     * The element types whose routines are generated (see pim/generator.h) rather than hard-coded: the narrow integers
+     * (a single lane, stored extended to the register), the unsigned words, the packed integers (several lanes), the
+     * fixed-point types, the narrow floating-point types, the wide types (on register pairs), and the big integers (on
+     * the consecutive rows of a register)
+     */
+    template <class T>
+    struct GeneratedFormat;
+    template <>
+    struct GeneratedFormat<int8_t> {
+        static constexpr const char *name = "int8_t";
+        static constexpr IntegerFormat format = {8, 1, true};
+    };
+    template <>
+    struct GeneratedFormat<int16_t> {
+        static constexpr const char *name = "int16_t";
+        static constexpr IntegerFormat format = {16, 1, true};
+    };
+    template <>
+    struct GeneratedFormat<uint8_t> {
+        static constexpr const char *name = "uint8_t";
+        static constexpr IntegerFormat format = {8, 1, false};
+    };
+    template <>
+    struct GeneratedFormat<uint16_t> {
+        static constexpr const char *name = "uint16_t";
+        static constexpr IntegerFormat format = {16, 1, false};
+    };
+    template <>
+    struct GeneratedFormat<int> {
+        static constexpr const char *name = "int";
+        static constexpr IntegerFormat format = {32, 1, true};
+    };
+    template <>
+    struct GeneratedFormat<uint32_t> {
+        static constexpr const char *name = "uint32_t";
+        static constexpr IntegerFormat format = {32, 1, false};
+    };
+    template <>
+    struct GeneratedFormat<packed<int8_t, 4>> {
+        static constexpr const char *name = "packed<int8_t,4>";
+        static constexpr IntegerFormat format = {8, 4, true};
+    };
+    template <>
+    struct GeneratedFormat<packed<int16_t, 2>> {
+        static constexpr const char *name = "packed<int16_t,2>";
+        static constexpr IntegerFormat format = {16, 2, true};
+    };
+    template <>
+    struct GeneratedFormat<packed<uint8_t, 4>> {
+        static constexpr const char *name = "packed<uint8_t,4>";
+        static constexpr IntegerFormat format = {8, 4, false};
+    };
+    template <>
+    struct GeneratedFormat<packed<uint16_t, 2>> {
+        static constexpr const char *name = "packed<uint16_t,2>";
+        static constexpr IntegerFormat format = {16, 2, false};
+    };
+    template <uint32_t I, uint32_t F>
+    struct GeneratedFormat<fixed<I, F>> {
+        static inline const std::string name = "fixed<" + std::to_string(I) + "," + std::to_string(F) + ">";
+        static constexpr FixedFormat format = {I, F};
+    };
+    template <uint32_t E, uint32_t M>
+    struct GeneratedFormat<float_t<E, M>> {
+        static inline const std::string name = "float_t<" + std::to_string(E) + "," + std::to_string(M) + ">";
+        static constexpr FloatFormat format = {E, M};
+    };
+    template <>
+    struct GeneratedFormat<half> {
+        static constexpr const char *name = "half";
+        static constexpr FloatFormat format = {5, 10};
+    };
+    template <>
+    struct GeneratedFormat<bfloat16> {
+        static constexpr const char *name = "bfloat16";
+        static constexpr FloatFormat format = {8, 7};
+    };
+    template <>
+    struct GeneratedFormat<float> {
+        static constexpr const char *name = "float";
+        static constexpr FloatFormat format = {8, 23};
+    };
+    template <>
+    struct GeneratedFormat<int64_t> {
+        static constexpr const char *name = "int64_t";
+        static constexpr IntegerFormat format = {64, 1, true};
+    };
+    template <>
+    struct GeneratedFormat<double> {
+        static constexpr const char *name = "double";
+        static constexpr FloatFormat format = {11, 52};
+    };
+    template <uint32_t N>
+    struct GeneratedFormat<uint_t<N>> {
+        static inline const std::string name = "uint_t<" + std::to_string(N) + ">";
+        static constexpr IntegerFormat format = {N, 1, false};
+    };
+
+    template <class T>
+    void add(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("add<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
-        perform(0x1f800000012 | (regX << 5) | (regX << 15) | (regZ << 25));
+        // Perform the generated micro-operations
+        generateAdd(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    void bitwiseAnd(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+    template <class T>
+    void subtract(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("subtract<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0x1f83e0f83ea);
-        perform(0x1f83c0f03ca);
-        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
-        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
-        perform(0x1f83c000012 | (regY << 5) | (regY << 15));
-        perform(0x1f8000f03fa | (regZ << 25));
+        // Perform the generated micro-operations
+        generateSubtract(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    void bitwiseXor(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+    template <class T>
+    void multiply(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("multiply<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0x1f83e0f83ea);
-        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
-        perform(0x1f83c0f03ca);
-        perform(0x1f83c000012 | (regY << 5) | (regY << 15));
-        perform(0x1f83a0e83aa);
-        perform(0x1f83a00001a | (regX << 5) | (regY << 15));
-        perform(0x1f8380e038a);
-        perform(0x1f8380f03fa);
-        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
-        perform(0x1f8000e03ba | (regZ << 25));
+        // Perform the generated micro-operations
+        generateMultiply(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    void bitwiseOr(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+    template <class T>
+    void divide(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("divide<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0x1f83e0f83ea);
-        perform(0x1f83e00001a | (regX << 5) | (regY << 15));
-        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
-        perform(0x1f8000f83f2 | (regZ << 25));
+        // Perform the generated micro-operations
+        generateDivide(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    void copy(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+    template <class T>
+    void modulo(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("modulo<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
         driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0x1f83e0f83ea);
-        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
-        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
-        perform(0x1f8000f83f2 | (regZ << 25));
+        // Perform the generated micro-operations
+        generateModulo(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    void warpMove(size_t inputRow, size_t outputRow, size_t reg, RangeMask crossbars){
+    template <class T>
+    void multiplyHigh(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("multiplyHigh<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
 
         // Update the masks if necessary
         driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
 
-        // Perform the corresponding micro-operations
-        perform(0xE | (outputRow << 5) | (outputRow << 15) | (reg << 25));
-        perform(0x16 | (inputRow << 5) | (outputRow << 15) | (reg << 25));
+        // Perform the generated micro-operations
+        generateMultiplyHigh(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
 
     }
 
-    size_t warpSize(){
-        return CROSSBAR_HEIGHT;
+    template <class T>
+    void less(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("less<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateLess(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void negate(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("negate<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateNegate(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void absolute(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("absolute<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateAbsolute(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void sign(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("sign<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateSign(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void zero(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("zero<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateZero(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T, class S>
+    void convert(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("convert<") + GeneratedFormat<T>::name + "," +
+                GeneratedFormat<S>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateConvert(GeneratedFormat<S>::format, GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void add(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("add<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateAdd(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void subtract(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("subtract<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateSubtract(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void multiply(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("multiply<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMultiply(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void divide(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("divide<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateDivide(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void modulo(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("modulo<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateModulo(GeneratedFormat<T>::format, regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
     }
 
-}
\ No newline at end of file
+    template <class T>
+    void negate(RegisterPair regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("negate<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateNegate(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void absolute(RegisterPair regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("absolute<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.low, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateAbsolute(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void sign(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("sign<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.low, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateSign(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void zero(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("zero<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.low, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateZero(GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T, class S>
+    void convert(size_t regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("convert<") + GeneratedFormat<T>::name + "," +
+                GeneratedFormat<S>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ.low});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateConvert(GeneratedFormat<S>::format, GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T, class S>
+    void convert(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("convert<") + GeneratedFormat<T>::name + "," +
+                GeneratedFormat<S>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.low, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateConvert(GeneratedFormat<S>::format, GeneratedFormat<T>::format, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void add(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("add<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateAdd(GeneratedFormat<T>::format, regX, regY, regZ, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void subtract(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("subtract<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateSubtract(GeneratedFormat<T>::format, regX, regY, regZ, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void multiply(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("multiply<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateMultiply(GeneratedFormat<T>::format, regX, regY, regZ, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void zero(RegisterRows regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("zeroMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regX.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateZero(GeneratedFormat<T>::format, regX, regZ, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void predicate(Predicate predicate, size_t regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("predicate<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regX, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generatePredicate(GeneratedFormat<T>::format, predicate, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void predicate(Predicate predicate, RegisterPair regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("predicate<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regX.high, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generatePredicate(GeneratedFormat<T>::format, predicate, regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void less(size_t regX, size_t regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("lessMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateLess(GeneratedFormat<T>::format, regX, regY, regZ, negate);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void less(RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("lessMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateLess(GeneratedFormat<T>::format, regX, regY, regZ, negate);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void less(RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("lessMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateLess(GeneratedFormat<T>::format, regX, regY, regZ, negate, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void equal(size_t regX, size_t regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("equalMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX, regY, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateEqual(GeneratedFormat<T>::format, regX, regY, regZ, negate);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void equal(RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("equalMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.low, regY.low, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateEqual(GeneratedFormat<T>::format, regX, regY, regZ, negate);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    template <class T>
+    void equal(RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        static const std::string name = std::string("equalMask<") + GeneratedFormat<T>::name + ">";
+        beginRoutine({name.c_str(), NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations (which restore the row mask)
+        generateEqual(GeneratedFormat<T>::format, regX, regY, regZ, negate, rows);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void bitwiseNot(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"bitwiseNot", NativeOperation::BITWISE_NOT, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the corresponding micro-operations
+        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
+        perform(0x1f800000012 | (regX << 5) | (regX << 15) | (regZ << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void bitwiseAnd(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"bitwiseAnd", NativeOperation::BITWISE_AND, false, regX, regY, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the corresponding micro-operations
+        perform(0x1f83e0f83ea);
+        perform(0x1f83c0f03ca);
+        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
+        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
+        perform(0x1f83c000012 | (regY << 5) | (regY << 15));
+        perform(0x1f8000f03fa | (regZ << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void bitwiseXor(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"bitwiseXor", NativeOperation::BITWISE_XOR, false, regX, regY, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the corresponding micro-operations
+        perform(0x1f83e0f83ea);
+        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
+        perform(0x1f83c0f03ca);
+        perform(0x1f83c000012 | (regY << 5) | (regY << 15));
+        perform(0x1f83a0e83aa);
+        perform(0x1f83a00001a | (regX << 5) | (regY << 15));
+        perform(0x1f8380e038a);
+        perform(0x1f8380f03fa);
+        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
+        perform(0x1f8000e03ba | (regZ << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void bitwiseOr(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"bitwiseOr", NativeOperation::BITWISE_OR, false, regX, regY, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the corresponding micro-operations
+        perform(0x1f83e0f83ea);
+        perform(0x1f83e00001a | (regX << 5) | (regY << 15));
+        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
+        perform(0x1f8000f83f2 | (regZ << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void copy(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"copy", NativeOperation::COPY, false, regX, regX, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the corresponding micro-operations
+        perform(0x1f83e0f83ea);
+        perform(0x1f80000000a | (regZ << 5) | (regZ << 15) | (regZ << 25));
+        perform(0x1f83e000012 | (regX << 5) | (regX << 15));
+        perform(0x1f8000f83f2 | (regZ << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void warpMove(size_t inputRow, size_t outputRow, size_t reg, RangeMask crossbars){
+
+        // Mark the start of the routine
+        beginRoutine({"warpMove", NativeOperation::NONE, false, reg, reg, reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+
+        // Perform the corresponding micro-operations
+        perform(0xE | (outputRow << 5) | (outputRow << 15) | (reg << 25));
+        perform(0x16 | (inputRow << 5) | (outputRow << 15) | (reg << 25));
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    size_t warpSize(){
+        return CROSSBAR_HEIGHT;
+    }
+
+    void maskInit(RegisterBit regZ, bool value, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskInit", NativeOperation::NONE, false, regZ.reg, regZ.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskInit(regZ, value);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskCopy(RegisterBit regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskCopy", NativeOperation::NONE, false, regX.reg, regX.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskCopy(regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskNot(RegisterBit regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskNot", NativeOperation::NONE, false, regX.reg, regX.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskNot(regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskAnd(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskAnd", NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskAnd(regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskOr(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskOr", NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskOr(regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskXor(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskXor", NativeOperation::NONE, false, regX.reg, regY.reg, regZ.reg});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskXor(regX, regY, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    void maskExpand(RegisterBit regX, size_t regZ, RangeMask crossbars, RangeMask rows){
+
+        // Mark the start of the routine
+        beginRoutine({"maskExpand", NativeOperation::NONE, false, regX.reg, regX.reg, regZ});
+
+        // Update the masks if necessary
+        driverSetCrossbarMask(crossbars);
+        driverSetRowMask(rows);
+
+        // Perform the generated micro-operations
+        generateMaskExpand(regX, regZ);
+
+        // Mark the end of the routine
+        endRoutine();
+
+    }
+
+    // The routines of the narrow integer types
+    template void add<int8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<int8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<int8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<int8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void modulo<int8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<int8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<int8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<int8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<int8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void add<int16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<int16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<int16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<int16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void modulo<int16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<int16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<int16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<int16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<int16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void add<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void modulo<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<uint8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<uint8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<uint8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<uint8_t>(size_t, size_t, RangeMask, RangeMask);
+    template void add<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void modulo<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<uint16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<uint16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<uint16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<uint16_t>(size_t, size_t, RangeMask, RangeMask);
+    template void multiplyHigh<uint8_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiplyHigh<uint16_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the unsigned words (whose division and comparison differ from int)
+    template void add<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiplyHigh<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void modulo<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void less<uint32_t>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<uint32_t>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<uint32_t>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<uint32_t>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<uint32_t>(size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the packed integer types (division requires a single lane)
+    template void add<packed<int8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<packed<int8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<packed<int8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<packed<int8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<packed<int8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<packed<int8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<packed<int8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<packed<int16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<packed<int16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<packed<int16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<packed<int16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<packed<int16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<packed<int16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<packed<int16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<packed<uint8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<packed<uint8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<packed<uint8_t, 4>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<packed<uint8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<packed<uint8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<packed<uint8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<packed<uint8_t, 4>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<packed<uint16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<packed<uint16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<packed<uint16_t, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<packed<uint16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<packed<uint16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<packed<uint16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<packed<uint16_t, 2>>(size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the narrow floating-point types (float_t<5, 10> and float_t<8, 7>), and their conversions
+    template void add<half>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<half>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<half>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<half>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<half>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<half>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<half>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<half>(size_t, size_t, RangeMask, RangeMask);
+    template void add<bfloat16>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<bfloat16>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<bfloat16>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<bfloat16>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<bfloat16>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<bfloat16>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<bfloat16>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<bfloat16>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<half, float>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float, half>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<bfloat16, float>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float, bfloat16>(size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the fixed-point formats (the routines of any other fixed<I, F> are instantiated likewise): the
+    // fractional Q7 and Q15, and the 16-bit Q8.8
+    template void add<fixed<1, 7>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<fixed<1, 7>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<fixed<1, 7>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<fixed<1, 7>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<fixed<1, 7>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<fixed<1, 7>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<fixed<1, 7>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<fixed<1, 15>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<fixed<1, 15>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<fixed<1, 15>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<fixed<1, 15>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<fixed<1, 15>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<fixed<1, 15>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<fixed<1, 15>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<fixed<8, 8>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<fixed<8, 8>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<fixed<8, 8>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<fixed<8, 8>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<fixed<8, 8>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<fixed<8, 8>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<fixed<8, 8>>(size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the custom floating-point formats (the routines of any other float_t<E, M> are instantiated
+    // likewise): the 8-bit E4M3 and E5M2
+    template void add<float_t<4, 3>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<float_t<4, 3>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<float_t<4, 3>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<float_t<4, 3>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<float_t<4, 3>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<float_t<4, 3>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<float_t<4, 3>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<float_t<4, 3>>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float_t<4, 3>, float>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float, float_t<4, 3>>(size_t, size_t, RangeMask, RangeMask);
+    template void add<float_t<5, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void subtract<float_t<5, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void multiply<float_t<5, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void divide<float_t<5, 2>>(size_t, size_t, size_t, RangeMask, RangeMask);
+    template void negate<float_t<5, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void absolute<float_t<5, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void sign<float_t<5, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void zero<float_t<5, 2>>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float_t<5, 2>, float>(size_t, size_t, RangeMask, RangeMask);
+    template void convert<float, float_t<5, 2>>(size_t, size_t, RangeMask, RangeMask);
+
+    // The routines of the wide types (on register pairs), and their conversions
+    template void add<int64_t>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void subtract<int64_t>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void multiply<int64_t>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void divide<int64_t>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void modulo<int64_t>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void negate<int64_t>(RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void absolute<int64_t>(RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void sign<int64_t>(RegisterPair, size_t, RangeMask, RangeMask);
+    template void zero<int64_t>(RegisterPair, size_t, RangeMask, RangeMask);
+    template void add<double>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void subtract<double>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void multiply<double>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void divide<double>(RegisterPair, RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void negate<double>(RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void absolute<double>(RegisterPair, RegisterPair, RangeMask, RangeMask);
+    template void sign<double>(RegisterPair, size_t, RangeMask, RangeMask);
+    template void zero<double>(RegisterPair, size_t, RangeMask, RangeMask);
+    template void convert<double, float>(size_t, RegisterPair, RangeMask, RangeMask);
+    template void convert<float, double>(RegisterPair, size_t, RangeMask, RangeMask);
+
+    // The routines of the big integers (the routines of any other uint_t<N> are instantiated likewise): 128, 256 and
+    // 1024 bits
+    template void add<uint_t<128>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void subtract<uint_t<128>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void multiply<uint_t<128>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void zero<uint_t<128>>(RegisterRows, RegisterBit, RangeMask, RangeMask);
+    template void add<uint_t<256>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void subtract<uint_t<256>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void multiply<uint_t<256>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void zero<uint_t<256>>(RegisterRows, RegisterBit, RangeMask, RangeMask);
+    template void add<uint_t<1024>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void subtract<uint_t<1024>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void multiply<uint_t<1024>>(RegisterRows, RegisterRows, RegisterRows, RangeMask, RangeMask);
+    template void zero<uint_t<1024>>(RegisterRows, RegisterBit, RangeMask, RangeMask);
+
+    // The predicates of the values as masks
+    template void predicate<int>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<float>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<half>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<bfloat16>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<float_t<4, 3>>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<float_t<5, 2>>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void predicate<int64_t>(Predicate, RegisterPair, RegisterBit, RangeMask, RangeMask);
+    template void predicate<double>(Predicate, RegisterPair, RegisterBit, RangeMask, RangeMask);
+    template void predicate<uint32_t>(Predicate, size_t, RegisterBit, RangeMask, RangeMask);
+    template void less<uint32_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint32_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<uint_t<128>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint_t<128>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<uint_t<256>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint_t<256>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<uint_t<1024>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint_t<1024>>(RegisterRows, RegisterRows, RegisterBit, bool, RangeMask, RangeMask);
+
+    // The comparisons as masks (of the extensions of the narrow integers and the fixed-point numbers as int)
+    template void less<int>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<int>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<int8_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<int8_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<int16_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<int16_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<uint8_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint8_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<uint16_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<uint16_t>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<float>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<float>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<half>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<half>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<bfloat16>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<bfloat16>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<float_t<4, 3>>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<float_t<4, 3>>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<float_t<5, 2>>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<float_t<5, 2>>(size_t, size_t, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<int64_t>(RegisterPair, RegisterPair, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<int64_t>(RegisterPair, RegisterPair, RegisterBit, bool, RangeMask, RangeMask);
+    template void less<double>(RegisterPair, RegisterPair, RegisterBit, bool, RangeMask, RangeMask);
+    template void equal<double>(RegisterPair, RegisterPair, RegisterBit, bool, RangeMask, RangeMask);
+
+}
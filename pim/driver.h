@@ -1,7 +1,9 @@
 #ifndef CUDAPIM_DRIVER_H
 #define CUDAPIM_DRIVER_H
 
+#include <future>
 #include "constants.h"
+#include "simulator.cuh"
 
 namespace pim{
 
@@ -14,6 +16,16 @@ namespace pim{
      */
     dtype read(size_t crossbar, size_t reg, size_t row);
 
+    /**
+     * Read macro-instruction that returns a future of the result (resolved by the executor thread in the asynchronous
+     * mode, see pim/async.h)
+     * @param crossbar
+     * @param reg
+     * @param row
+     * @return
+     */
+    std::future<dtype> readAsync(size_t crossbar, size_t reg, size_t row);
+
     /**
      * Write macro-instruction
      * @param crossbar
@@ -108,6 +120,28 @@ namespace pim{
     template <class T>
     void modulo(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows);
 
+    /**
+     * Performs multiplication on the given registers, returning the high half of the (double-width) product
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void multiplyHigh(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the first register is less than the second (as the sign)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void less(size_t regX, size_t regY, size_t regZ, RangeMask crossbars, RangeMask rows);
+
     /**
      * Returns the sign of the given register
      * @param regX
@@ -128,6 +162,271 @@ namespace pim{
     template <class T>
     void zero(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows);
 
+    /**
+     * Converts the given register from type S to type T
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T, class S>
+    void convert(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs addition on the given register pairs (the elements wider than a word, see pim/constants.h)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void add(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs subtraction on the given register pairs
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void subtract(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs multiplication on the given register pairs
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void multiply(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs division on the given register pairs
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void divide(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs modulo division on the given register pairs
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void modulo(RegisterPair regX, RegisterPair regY, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs negation on the given register pair
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void negate(RegisterPair regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs absolute value on the given register pair
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void absolute(RegisterPair regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns the sign of the given register pair (as a mask in a single register)
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void sign(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the given register pair is all-zero (as a mask in a single register)
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void zero(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Converts the given register from type S to the wider type T
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T, class S>
+    void convert(size_t regX, RegisterPair regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Converts the given register pair from type S to the narrower type T
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T, class S>
+    void convert(RegisterPair regX, size_t regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs addition on the given big integers (whose elements span consecutive rows, see pim/constants.h), where
+     * the rows span whole elements
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void add(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs subtraction on the given big integers
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void subtract(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs multiplication on the given big integers (where the result is not one of the operands)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void multiply(RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the given big integers are zero as a mask (at the first row of every element)
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void zero(RegisterRows regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns the given predicate of the given register (e.g., of the difference of a comparison) as a mask
+     * @param predicate
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void predicate(Predicate predicate, size_t regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns the given predicate of the given register pair as a mask
+     * @param predicate
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void predicate(Predicate predicate, RegisterPair regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the first register is less than the second as a mask (or greater than or equal, if negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void less(size_t regX, size_t regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the first register pair is less than the second as a mask (or greater than or equal, if negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void less(RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the first big integer is less than the second as a mask at the first row of every element (or
+     * greater than or equal, if negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void less(RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the given registers are equal as a mask (or not equal, if negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void equal(size_t regX, size_t regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the given register pairs are equal as a mask (or not equal, if negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void equal(RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Returns whether the given big integers are equal as a mask at the first row of every element (or not equal, if
+     * negated)
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param crossbars
+     * @param rows
+     */
+    template <class T>
+    void equal(RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate, RangeMask crossbars, RangeMask rows);
+
     /**
      * Performs bitwise NOT on the given register
      * @param regX
@@ -176,6 +475,72 @@ namespace pim{
      */
     void copy(size_t regX, size_t regZ, RangeMask crossbars, RangeMask rows);
 
+    /**
+     * Initializes the given mask to the given value
+     * @param regZ
+     * @param value
+     * @param crossbars
+     * @param rows
+     */
+    void maskInit(RegisterBit regZ, bool value, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs copy on the given masks
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskCopy(RegisterBit regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs NOT on the given mask
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskNot(RegisterBit regX, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs AND on the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskAnd(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs OR on the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskOr(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs XOR on the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskXor(RegisterBit regX, RegisterBit regY, RegisterBit regZ, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Expands the given mask to a register (all-one if set, and zero otherwise)
+     * @param regX
+     * @param regZ
+     * @param crossbars
+     * @param rows
+     */
+    void maskExpand(RegisterBit regX, size_t regZ, RangeMask crossbars, RangeMask rows);
+
     /**
      * Intra-warp warp-parallel NOT move
      * @param inputRow
@@ -191,6 +556,32 @@ namespace pim{
      */
     size_t warpSize();
 
+    /**
+     * Starts capturing the subsequent routines into a graph (the routines are also performed)
+     */
+    void beginCapture();
+
+    /**
+     * Ends the capture, returning the captured graph
+     * @return
+     */
+    Graph endCapture();
+
+    /**
+     * Launches the given graph with the given register binding
+     * @param graph
+     * @param registers maps registers of the graph to the registers to use instead (other registers are unchanged)
+     */
+    void launch(const Graph& graph, const std::map<size_t, size_t>& registers = {});
+
+    /**
+     * Launches the given graph with the given register binding, replacing every crossbar mask of the graph
+     * @param graph
+     * @param registers maps registers of the graph to the registers to use instead (other registers are unchanged)
+     * @param crossbars
+     */
+    void launch(const Graph& graph, const std::map<size_t, size_t>& registers, RangeMask crossbars);
+
 }
 
 #endif // CUDAPIM_DRIVER_H
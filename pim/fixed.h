@@ -0,0 +1,59 @@
+#ifndef CUDAPIM_FIXED_H
+#define CUDAPIM_FIXED_H
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * Signed fixed-point number of I integer bits (including the sign) and F fractional bits, whose value is raw / 2^F,
+     * stored sign-extended in the words of pim::vector<fixed<I, F>> as the narrow integers. Its routines reuse the
+     * generated integer routines (see pim/generator.h): the products are rescaled by an arithmetic shift (rounding
+     * towards negative infinity), and the results that overflow saturate to the extreme values.
+     * @tparam I
+     * @tparam F
+     */
+    template <uint32_t I, uint32_t F>
+    struct fixed {
+
+        static_assert(I >= 1 && F >= 1 && I + F <= 16,
+                "pim::fixed: the format must have a sign bit, a fractional bit, and at most 16 bits.");
+
+        /** The widths of the integer and the fractional parts */
+        static constexpr uint32_t integer = I, fraction = F;
+
+        /** The extreme raw values */
+        static constexpr int32_t minRaw = -(1 << (I + F - 1)), maxRaw = (1 << (I + F - 1)) - 1;
+
+        /** The raw (scaled) value */
+        typename std::conditional<I + F <= 8, int8_t, int16_t>::type raw = 0;
+
+        fixed() = default;
+
+        /** Rounds the given float to nearest (ties to even), saturating */
+        fixed(float x){
+            float scaled = std::nearbyint(std::ldexp(x, F));
+            raw = (decltype(raw)) (scaled < minRaw ? minRaw : (scaled > maxRaw ? maxRaw : scaled));
+        }
+
+        operator float() const{
+            return std::ldexp((float) raw, -(int) F);
+        }
+
+    };
+
+    /**
+     * Whether the given type is a fixed-point type
+     * @tparam T
+     */
+    template <class T>
+    struct isFixed : std::false_type {};
+    template <uint32_t I, uint32_t F>
+    struct isFixed<fixed<I, F>> : std::true_type {};
+
+}
+
+#endif // CUDAPIM_FIXED_H
@@ -0,0 +1,110 @@
+#ifndef CUDAPIM_FLOATING_H
+#define CUDAPIM_FLOATING_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * Rounds the given float to the floating-point format of E exponent bits and M mantissa bits (at most those of
+     * float), as the generated routines: to nearest (ties to even), where results below the smallest normal number
+     * (before rounding) are flushed to (positive) zero and overflows become infinity
+     * @param x
+     * @param E
+     * @param M
+     * @return the bits of the result
+     */
+    inline uint32_t encodeFloat(float x, uint32_t E, uint32_t M){
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        uint32_t sign = bits >> 31, e = (bits >> 23) & 0xFF, m = bits & 0x7FFFFF;
+        uint32_t maxExponent = (1u << E) - 1;
+        if(e == 0xFF) return (sign << (E + M)) | (maxExponent << M) | (m ? 1u << (M - 1) : 0);
+        if(e == 0) return 0;
+        // The exponent in the target bias, and the mantissa rounded to M bits
+        int32_t exponent = (int32_t) e - 127 + (int32_t) (maxExponent >> 1);
+        if(exponent < 1) return 0;
+        uint32_t shift = 23 - M, mantissa = m >> shift;
+        if(shift){
+            uint32_t rest = m & ((1u << shift) - 1), tie = 1u << (shift - 1);
+            if(rest > tie || (rest == tie && (mantissa & 1))) mantissa++;
+        }
+        if(mantissa >> M){
+            mantissa = 0;
+            exponent++;
+        }
+        if(exponent >= (int32_t) maxExponent) return (sign << (E + M)) | (maxExponent << M);
+        return (sign << (E + M)) | ((uint32_t) exponent << M) | mantissa;
+    }
+
+    /**
+     * Returns the float of the given bits of the floating-point format of E exponent bits and M mantissa bits (at most
+     * those of float), where subnormals are flushed to zero
+     * @param bits
+     * @param E
+     * @param M
+     * @return
+     */
+    inline float decodeFloat(uint32_t bits, uint32_t E, uint32_t M){
+        uint32_t sign = (bits >> (E + M)) & 1, e = (bits >> M) & ((1u << E) - 1), m = bits & ((1u << M) - 1);
+        uint32_t maxExponent = (1u << E) - 1, result = sign << 31;
+        if(e == maxExponent) result |= (0xFFu << 23) | (m << (23 - M));
+        else if(e != 0) result |= ((e - (maxExponent >> 1) + 127) << 23) | (m << (23 - M));
+        float x;
+        std::memcpy(&x, &result, sizeof(x));
+        return x;
+    }
+
+    /**
+     * Floating-point number of E exponent bits and M mantissa bits (narrower than float, e.g., E4M3 or E5M2), stored
+     * zero-extended in the words of pim::vector<float_t<E, M>>, whose routines are generated for the format (see
+     * pim/generator.h). It is encoded as IEEE 754 (with the maximal exponent for infinity and NaN), and its routines
+     * round as IEEE 754 except that subnormals are flushed to zero, while results that overflow become infinity.
+     * Infinities and NaN are not supported as operands: they are not propagated (e.g., NaN + 1 is infinity), and
+     * division by zero returns zero rather than infinity.
+     * @tparam E
+     * @tparam M
+     */
+    template <uint32_t E, uint32_t M>
+    struct float_t {
+
+        static_assert(E >= 2 && E <= 8 && M >= 1 && M <= 23 && E + M < 31,
+                "pim::float_t: the format must be narrower than float.");
+
+        /** The widths of the exponent and the mantissa */
+        static constexpr uint32_t exponent = E, mantissa = M;
+
+        /** The bits of the number */
+        typename std::conditional<E + M < 8, uint8_t,
+                typename std::conditional<E + M < 16, uint16_t, uint32_t>::type>::type bits = 0;
+
+        float_t() = default;
+        float_t(float x) : bits(encodeFloat(x, E, M)) {}
+
+        operator float() const{
+            return decodeFloat(bits, E, M);
+        }
+
+    };
+
+    /** IEEE 754 half-precision floating-point number (5 exponent bits and 10 mantissa bits) */
+    typedef float_t<5, 10> half;
+
+    /** Brain floating-point number (8 exponent bits and 7 mantissa bits, the upper half of float) */
+    typedef float_t<8, 7> bfloat16;
+
+    /**
+     * Whether the given type is a narrow floating-point type
+     * @tparam T
+     */
+    template <class T>
+    struct isNarrowFloat : std::false_type {};
+    template <uint32_t E, uint32_t M>
+    struct isNarrowFloat<float_t<E, M>> : std::true_type {};
+
+}
+
+#endif // CUDAPIM_FLOATING_H
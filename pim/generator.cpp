@@ -0,0 +1,3299 @@
+#include "generator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "simulator.cuh"
+
+namespace pim{
+
+    /** The first scratch register of the generated routines (as of the driver routines) */
+    constexpr size_t FIRST_SCRATCH_REGISTER = 18;
+
+    /**
+     * The scratch registers that are available to a generated routine
+     */
+    class Scratch {
+
+        /** The free registers */
+        std::vector<size_t> free;
+
+    public:
+
+        Scratch(){
+            for(size_t reg = FIRST_SCRATCH_REGISTER; reg < CROSSBAR_R; reg++) free.push_back(reg);
+        }
+
+        /**
+         * Takes a free register (the highest first)
+         * @return
+         */
+        size_t take(){
+            if(free.empty()) throw std::runtime_error("Generator: out of scratch registers.");
+            size_t reg = free.back();
+            free.pop_back();
+            return reg;
+        }
+
+        /**
+         * Returns the given register to the free registers
+         * @param reg
+         */
+        void give(size_t reg){
+            free.push_back(reg);
+        }
+
+    };
+
+    /**
+     * A group of equally-sized lanes within a register: lane k occupies partitions [base + k * width,
+     * base + (k + 1) * width)
+     */
+    struct Lanes {
+
+        size_t base, width, count;
+
+        /** All partitions of the lanes */
+        RangeMask all() const { return {base, base + width * count - 1, 1}; }
+
+        /** The partitions of the lanes from bit i (inclusive) of the first lane */
+        RangeMask from(size_t i) const { return {base + i, base + width * count - 1, 1}; }
+
+        /** The partition of bit i in every lane (the step of a single lane is arbitrary, as it may exceed the
+         * encoding of the micro-operations) */
+        RangeMask bit(size_t i) const { return {base + i, base + i + width * (count - 1), count > 1 ? width : 1}; }
+
+    };
+
+    /**
+     * The carry into every lane of an addition: a constant (if reg is -1), or the first partition of every lane of reg
+     * (and its complement in inv)
+     */
+    struct Carry {
+        bool value;
+        size_t reg, inv;
+    };
+    const Carry CARRY_ZERO = {false, -1, -1};
+    const Carry CARRY_ONE = {true, -1, -1};
+
+    /**
+     * Performs a horizontal logic micro-operation on the output partitions p, where the inputs are aligned to the
+     * output (partition p.start of the output reads partition pA of input A and partition pB of input B)
+     * @param gate
+     * @param inA
+     * @param pA
+     * @param inB
+     * @param pB
+     * @param out
+     * @param p
+     */
+    void horizontal(GateType gate, size_t inA, size_t pA, size_t inB, size_t pB, size_t out, RangeMask p){
+
+        // The gates are symmetric, while the micro-operation requires input A to be the left input
+        if(pA > pB){
+            std::swap(inA, inB);
+            std::swap(pA, pB);
+        }
+
+        // Align the end of the pattern to its step
+        size_t pEnd = p.start + ((p.stop - p.start) / p.step) * p.step;
+
+        otype operation = p.step;
+        operation = (operation << LOG_CROSSBAR_N) | pEnd;
+        operation = (operation << LOG_CROSSBAR_N) | p.start;
+        operation = (operation << LOG_CROSSBAR_R) | out;
+        operation = (operation << LOG_CROSSBAR_N) | pB;
+        operation = (operation << LOG_CROSSBAR_R) | inB;
+        operation = (operation << LOG_CROSSBAR_N) | pA;
+        operation = (operation << LOG_CROSSBAR_R) | inA;
+        perform((((((operation << 2) | gate) << 1) | 0) << 2) | MicrooperationType::LOGIC);
+
+    }
+
+    /**
+     * Initializes the partitions p of the given register to the given value
+     * @param reg
+     * @param p
+     * @param value
+     */
+    void gateInit(size_t reg, RangeMask p, bool value){
+        horizontal(value ? GateType::INIT1 : GateType::INIT0, reg, p.start, reg, p.start, reg, p);
+    }
+
+    /**
+     * out[p] &= ~in[p - p.start + pIn] for the partitions p
+     * @param in
+     * @param pIn
+     * @param out
+     * @param p
+     */
+    void gateNot(size_t in, size_t pIn, size_t out, RangeMask p){
+        horizontal(GateType::NOT, in, pIn, in, pIn, out, p);
+    }
+
+    /**
+     * out[p] &= ~(a[p - p.start + pA] | b[p - p.start + pB]) for the partitions p
+     * @param a
+     * @param pA
+     * @param b
+     * @param pB
+     * @param out
+     * @param p
+     */
+    void gateNor(size_t a, size_t pA, size_t b, size_t pB, size_t out, RangeMask p){
+        horizontal(GateType::NOR, a, pA, b, pB, out, p);
+    }
+
+    /**
+     * out[p] = ~in[p - p.start + pIn] for the partitions p
+     * @param in
+     * @param pIn
+     * @param out
+     * @param p
+     */
+    void computeNot(size_t in, size_t pIn, size_t out, RangeMask p){
+        gateInit(out, p, true);
+        gateNot(in, pIn, out, p);
+    }
+
+    /**
+     * out[p] = ~(a[p - p.start + pA] | b[p - p.start + pB]) for the partitions p
+     * @param a
+     * @param pA
+     * @param b
+     * @param pB
+     * @param out
+     * @param p
+     */
+    void computeNor(size_t a, size_t pA, size_t b, size_t pB, size_t out, RangeMask p){
+        gateInit(out, p, true);
+        gateNor(a, pA, b, pB, out, p);
+    }
+
+    /**
+     * Returns the register that holds partition p of a value of a single register (the register itself, as for the
+     * register pairs below)
+     * @param reg
+     * @param p
+     * @return
+     */
+    size_t wordOf(size_t reg, size_t /* p */){
+        return reg;
+    }
+
+    /**
+     * Returns the register of the given pair that holds partition p of a wide value (whose partitions [0, CROSSBAR_N)
+     * are those of the low register, and the following partitions are those of the high register)
+     * @param pair
+     * @param p
+     * @return
+     */
+    size_t wordOf(RegisterPair pair, size_t p){
+        return p < CROSSBAR_N ? pair.low : pair.high;
+    }
+
+    /**
+     * Returns a pair that stands for a single register on both sides: a register of which only the partitions of a
+     * single half are used, or a register that is uniform across its partitions (e.g., a broadcast)
+     * @param reg
+     * @return
+     */
+    RegisterPair pairOf(size_t reg){
+        return {reg, reg};
+    }
+
+    /**
+     * Performs a horizontal logic micro-operation on the contiguous partitions p of wide values (register pairs, aligned
+     * as in the horizontal micro-operation of registers), split where the output or the inputs cross between their
+     * registers
+     * @param gate
+     * @param inA
+     * @param pA
+     * @param inB
+     * @param pB
+     * @param out
+     * @param p
+     */
+    template <class R>
+    void horizontal(GateType gate, R inA, size_t pA, R inB, size_t pB, R out, RangeMask p){
+        constexpr size_t last = CROSSBAR_N - 1;
+        for(size_t s = p.start; s <= p.stop;){
+            size_t a = pA + s - p.start, b = pB + s - p.start;
+            size_t e = std::min({p.stop, s | last, s + ((a | last) - a), s + ((b | last) - b)});
+            horizontal(gate, wordOf(inA, a), a % CROSSBAR_N, wordOf(inB, b), b % CROSSBAR_N, wordOf(out, s),
+                       {s % CROSSBAR_N, e % CROSSBAR_N, 1});
+            s = e + 1;
+        }
+    }
+
+    /** The gates and computations of wide values (as those of registers above) */
+    template <class R>
+    void gateInit(R reg, RangeMask p, bool value){
+        horizontal(value ? GateType::INIT1 : GateType::INIT0, reg, p.start, reg, p.start, reg, p);
+    }
+
+    template <class R>
+    void gateNot(R in, size_t pIn, R out, RangeMask p){
+        horizontal(GateType::NOT, in, pIn, in, pIn, out, p);
+    }
+
+    template <class R>
+    void gateNor(R a, size_t pA, R b, size_t pB, R out, RangeMask p){
+        horizontal(GateType::NOR, a, pA, b, pB, out, p);
+    }
+
+    template <class R>
+    void computeNot(R in, size_t pIn, R out, RangeMask p){
+        gateInit(out, p, true);
+        gateNot(in, pIn, out, p);
+    }
+
+    template <class R>
+    void computeNor(R a, size_t pA, R b, size_t pB, R out, RangeMask p){
+        gateInit(out, p, true);
+        gateNor(a, pA, b, pB, out, p);
+    }
+
+    /**
+     * out[p] = ~(a[p] ^ b[p]) for the partitions p (all aligned)
+     * @param a
+     * @param b
+     * @param out
+     * @param p
+     * @param scratch
+     */
+    void computeXnor(size_t a, size_t b, size_t out, RangeMask p, Scratch& scratch){
+        size_t t = scratch.take(), u = scratch.take(), v = scratch.take();
+        computeNor(a, p.start, b, p.start, t, p);
+        computeNor(a, p.start, t, p.start, u, p);
+        computeNor(b, p.start, t, p.start, v, p);
+        computeNor(u, p.start, v, p.start, out, p);
+        scratch.give(v); scratch.give(u); scratch.give(t);
+    }
+
+    /**
+     * Broadcasts src[pSrc] to the contiguous partitions p of pos, and its complement to the partitions p of neg (by
+     * doubling the broadcast partitions of both registers in turn). The complement is only completed if required.
+     * @param src
+     * @param pSrc
+     * @param pos
+     * @param neg
+     * @param p
+     * @param complement
+     */
+    void broadcast(size_t src, size_t pSrc, size_t pos, size_t neg, RangeMask p, bool complement){
+        size_t length = p.stop - p.start + 1;
+        gateInit(neg, p, true);
+        gateNot(src, pSrc, neg, {p.start, p.start, 1});
+        gateInit(pos, p, true);
+        gateNot(neg, p.start, pos, {p.start, p.start, 1});
+        for(size_t filled = 1; filled < length; filled *= 2){
+            size_t count = std::min(filled, length - filled);
+            RangeMask next(p.start + filled, p.start + filled + count - 1, 1);
+            gateNot(neg, p.start, pos, next);
+            if(complement || filled + count < length) gateNot(pos, p.start, neg, next);
+        }
+    }
+
+    /**
+     * Broadcasts bit i of every lane of src to the lane of pos, and its complement to the lane of neg. A single lane is
+     * broadcast by doubling, while several lanes are broadcast by a strided gate per bit of the lanes.
+     * @param lanes
+     * @param src
+     * @param i
+     * @param pos
+     * @param neg
+     * @param complement
+     */
+    void broadcastLanes(Lanes lanes, size_t src, size_t i, size_t pos, size_t neg, bool complement){
+        if(lanes.count == 1){
+            broadcast(src, lanes.base + i, pos, neg, lanes.all(), complement);
+            return;
+        }
+        gateInit(neg, lanes.all(), true);
+        gateNot(src, lanes.base + i, neg, lanes.bit(0));
+        gateInit(pos, lanes.all(), true);
+        for(size_t j = 0; j < lanes.width; j++) gateNot(neg, lanes.base, pos, lanes.bit(j));
+        if(complement){
+            for(size_t j = 1; j < lanes.width; j++) gateNot(pos, lanes.base, neg, lanes.bit(j));
+        }
+    }
+
+    /**
+     * Adds the given operands (each given in both polarities) with a parallel-prefix (Kogge-Stone) adder, where the
+     * lanes are isolated by blocking the propagation into the first bit of every lane. z may be one of the operands.
+     * @param lanes
+     * @param a
+     * @param na
+     * @param b
+     * @param nb
+     * @param carry
+     * @param z
+     * @param scratch
+     * @return a scratch register holding the complement of the carry out of every bit (the caller gives it back)
+     */
+    size_t add(Lanes lanes, size_t a, size_t na, size_t b, size_t nb, Carry carry, size_t z, Scratch& scratch){
+
+        RangeMask all = lanes.all(), starts = lanes.bit(0);
+        size_t base = lanes.base, width = lanes.width;
+        size_t nP = scratch.take(), P = scratch.take(), G = scratch.take(), nG = scratch.take(), H = scratch.take();
+
+        // Propagate (P = a | b), generate (G = a & b) and half sum (H = a ^ b)
+        computeNor(a, base, b, base, nP, all);
+        computeNot(nP, base, P, all);
+        computeNor(na, base, nb, base, G, all);
+        computeNot(G, base, nG, all);
+        computeNor(G, base, nP, base, H, all);
+
+        // Include the carry into the generate of the first bit of every lane (G is reused for temporaries)
+        if(carry.reg == -1){
+            if(carry.value) gateNot(P, base, nG, starts);
+        }
+        else{
+            computeNor(nP, base, carry.inv, base, G, starts);
+            gateNot(G, base, nG, starts);
+        }
+
+        // Isolate the lanes
+        if(lanes.count > 1){
+            gateInit(P, starts, false);
+            gateInit(nP, starts, true);
+        }
+
+        // Prefix stages: G[p] |= P[p] & G[p - s] and P[p] &= P[p - s]
+        for(size_t s = 1; s < width; s *= 2){
+            RangeMask p = lanes.from(s);
+            computeNor(nG, base, nP, base + s, G, p);
+            gateNot(G, base + s, nG, p);
+            if(2 * s < width){
+                gateNot(nP, base, P, p);
+                computeNot(P, base + s, nP, p);
+            }
+        }
+
+        // The carry into every bit (C[p] = G[p - 1], reusing P), and its complement (reusing nP)
+        size_t C = P, nC = nP;
+        gateInit(C, all, true);
+        if(all.stop > all.start) gateNot(nG, base, C, lanes.from(1));
+        if(carry.reg == -1){
+            if(!carry.value || lanes.count > 1) gateInit(C, starts, carry.value);
+        }
+        else{
+            gateInit(C, starts, true);
+            gateNot(carry.inv, base, C, starts);
+        }
+        computeNot(C, base, nC, all);
+
+        // z = H ^ C = ~(H ^ nC)
+        size_t t = G;
+        computeNor(H, base, nC, base, t, all);
+        size_t u = C;
+        computeNor(H, base, t, base, u, all);
+        size_t v = H;
+        computeNor(nC, base, t, base, v, all);
+        computeNor(u, base, v, base, z, all);
+
+        scratch.give(H); scratch.give(G); scratch.give(P); scratch.give(nP);
+        return nG;
+
+    }
+
+    /**
+     * Adds the given wide operands over the partitions [0, width) by chaining the adder over their registers, where the
+     * carry out of the low register is carried into the high register. The second operand is b ^ flip, where flip is a
+     * register that is uniform across its partitions (or -1 for none), and is complemented if invert. The complements
+     * of the operands are computed per register (rather than given). z may be one of the operands.
+     * @param width
+     * @param a
+     * @param b
+     * @param flip
+     * @param invert
+     * @param carry
+     * @param z
+     * @param scratch
+     * @return a scratch register holding the complement of the carry out of every bit of the last register (the caller
+     * gives it back)
+     */
+    template <class R>
+    size_t addWide(size_t width, R a, R b, size_t flip, bool invert, Carry carry, R z, Scratch& scratch){
+
+        size_t nG = -1;
+        RangeMask first(0, 0, 1);
+
+        for(size_t base = 0; base < width; base += CROSSBAR_N){
+
+            RangeMask all(0, std::min(width - base, CROSSBAR_N) - 1, 1);
+            size_t A = wordOf(a, base), B = wordOf(b, base);
+
+            // The carry out of the previous register (moved to the first partition, as its complement)
+            if(nG != -1){
+                size_t c = scratch.take();
+                computeNot(nG, CROSSBAR_N - 1, c, first);
+                computeNot(c, 0, nG, first);
+                scratch.give(c);
+                carry = {false, nG, nG};
+            }
+
+            // The second operand (y) and its complement (ny), computed into t (and u)
+            size_t na = scratch.take(), t = scratch.take(), u = -1, y, ny;
+            computeNot(A, 0, na, all);
+            if(flip == -1){
+                computeNot(B, 0, t, all);
+                y = invert ? t : B;
+                ny = invert ? B : t;
+            }
+            else{
+                u = scratch.take();
+                computeXnor(B, flip, t, all, scratch);
+                computeNot(t, 0, u, all);
+                y = invert ? t : u;
+                ny = invert ? u : t;
+            }
+
+            size_t next = add({0, all.stop + 1, 1}, A, na, y, ny, carry, wordOf(z, base), scratch);
+            if(u != -1) scratch.give(u);
+            scratch.give(t); scratch.give(na);
+            if(nG != -1) scratch.give(nG);
+            nG = next;
+
+        }
+
+        return nG;
+
+    }
+
+    /**
+     * Extends the single lane of the given register to the full register (if narrower than the register)
+     * @param format
+     * @param reg
+     * @param scratch
+     */
+    void extend(IntegerFormat format, size_t reg, Scratch& scratch){
+        if(format.lanes != 1 || format.width >= CROSSBAR_N) return;
+        RangeMask upper(format.width, CROSSBAR_N - 1, 1);
+        if(format.isSigned){
+            size_t t = scratch.take();
+            broadcast(reg, format.width - 1, reg, t, upper, false);
+            scratch.give(t);
+        }
+        else{
+            gateInit(reg, upper, false);
+        }
+    }
+
+    /**
+     * Negates every lane of src whose sign is set (given by a bit of the lane in a register), into dst
+     * @param lanes
+     * @param src
+     * @param sign the register holding the sign
+     * @param pSign the bit of the sign within every lane
+     * @param inverted whether the register holds the complement of the sign
+     * @param dst
+     * @param scratch
+     */
+    void conditionalNegate(Lanes lanes, size_t src, size_t sign, size_t pSign, bool inverted, size_t dst, Scratch& scratch){
+
+        RangeMask all = lanes.all();
+        size_t base = lanes.base;
+
+        // The sign broadcast to every lane (m), and its complement (nm)
+        size_t m = scratch.take(), nm = scratch.take();
+        if(inverted) broadcastLanes(lanes, sign, pSign, nm, m, true);
+        else broadcastLanes(lanes, sign, pSign, m, nm, true);
+
+        // a = src ^ m = ~(~(src | m) | ~(~src | ~m))
+        size_t ns = scratch.take(), t = scratch.take(), w = scratch.take(), a = scratch.take();
+        computeNot(src, base, ns, all);
+        computeNor(src, base, m, base, t, all);
+        computeNor(ns, base, nm, base, w, all);
+        computeNor(t, base, w, base, a, all);
+        size_t na = t;
+        computeNot(a, base, na, all);
+
+        // dst = a + 0 + sign
+        size_t zero = ns, ones = w;
+        gateInit(zero, all, false);
+        gateInit(ones, all, true);
+        scratch.give(add(lanes, a, na, zero, ones, {false, m, nm}, dst, scratch));
+
+        scratch.give(a); scratch.give(w); scratch.give(t); scratch.give(ns); scratch.give(nm); scratch.give(m);
+
+    }
+
+    void generateAdd(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+        size_t nx = scratch.take(), ny = scratch.take();
+        computeNot(regX, 0, nx, lanes.all());
+        computeNot(regY, 0, ny, lanes.all());
+        scratch.give(add(lanes, regX, nx, regY, ny, CARRY_ZERO, regZ, scratch));
+        scratch.give(ny); scratch.give(nx);
+        extend(format, regZ, scratch);
+    }
+
+    void generateSubtract(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+        size_t nx = scratch.take(), ny = scratch.take();
+        computeNot(regX, 0, nx, lanes.all());
+        computeNot(regY, 0, ny, lanes.all());
+        scratch.give(add(lanes, regX, nx, ny, regY, CARRY_ONE, regZ, scratch));
+        scratch.give(ny); scratch.give(nx);
+        extend(format, regZ, scratch);
+    }
+
+    void generateNegate(IntegerFormat format, size_t regX, size_t regZ){
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+        size_t zero = scratch.take(), ones = scratch.take(), nx = scratch.take();
+        gateInit(zero, lanes.all(), false);
+        gateInit(ones, lanes.all(), true);
+        computeNot(regX, 0, nx, lanes.all());
+        scratch.give(add(lanes, zero, ones, nx, regX, CARRY_ONE, regZ, scratch));
+        scratch.give(nx); scratch.give(ones); scratch.give(zero);
+        extend(format, regZ, scratch);
+    }
+
+    void generateAbsolute(IntegerFormat format, size_t regX, size_t regZ){
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+        if(format.isSigned){
+            conditionalNegate(lanes, regX, regX, format.width - 1, false, regZ, scratch);
+        }
+        else{
+            size_t t = scratch.take();
+            computeNot(regX, 0, t, lanes.all());
+            computeNot(t, 0, regZ, lanes.all());
+            scratch.give(t);
+        }
+        extend(format, regZ, scratch);
+    }
+
+    /**
+     * Multiplies the given registers (the low bits of the product in every lane), where only the first bits of y are
+     * set. z may not be one of the operands.
+     * @param lanes
+     * @param bits the number of (possibly) set bits of y in every lane
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param scratch
+     */
+    void multiply(Lanes lanes, size_t bits, size_t regX, size_t regY, size_t regZ, Scratch& scratch){
+
+        size_t width = lanes.width, end = lanes.all().stop;
+        RangeMask all = lanes.all();
+
+        // The product is accumulated in carry-save form (S + C) over the partial products x << i & y[i]
+        size_t nx = scratch.take(), S = scratch.take(), C = scratch.take(), nb = scratch.take(), B = scratch.take();
+        size_t pp = scratch.take(), nMask = -1;
+        computeNot(regX, 0, nx, all);
+        if(lanes.count > 1){
+            // The complement of the mask of the partitions below bit i of every lane (whose partial products and
+            // carries are contaminated by the previous lane)
+            nMask = scratch.take();
+            gateInit(nMask, all, false);
+        }
+
+        for(size_t i = 0; i < bits; i++){
+
+            // nb = ~y[i], broadcast from bit i to the following bits of every lane (by OR-doubling, where the
+            // partitions beyond the lane are masked)
+            RangeMask p = lanes.from(i);
+            gateInit(nb, p, true);
+            gateNot(regY, i, nb, lanes.bit(i));
+            for(size_t k = 1; k < width - i; k *= 2){
+                computeNot(nb, i, B, p);
+                gateNot(B, i, nb, lanes.from(i + k));
+            }
+
+            if(i == 0){
+                // (S, C) = (x & y[0], 0)
+                computeNor(nx, 0, nb, 0, S, all);
+                gateInit(C, all, false);
+                if(lanes.count > 1) gateInit(nMask, lanes.bit(0), true);
+                continue;
+            }
+
+            // pp = (x << i) & y[i]
+            computeNor(nx, 0, nb, i, pp, p);
+            if(lanes.count > 1) gateNot(nMask, i, pp, p);
+
+            // Full adder (S, C) + pp, where the carries are shifted into the following bits
+            size_t t1 = scratch.take(), t2 = scratch.take(), t3 = scratch.take(), t4 = scratch.take(), t5 = scratch.take();
+            computeNor(S, i, C, i, t1, p);
+            computeNor(S, i, t1, i, t2, p);
+            computeNor(C, i, t1, i, t3, p);
+            computeNor(t2, i, t3, i, t4, p);
+            computeNor(t4, i, pp, i, t5, p);
+            computeNor(t4, i, t5, i, t2, p);
+            computeNor(pp, i, t5, i, t3, p);
+            computeNor(t2, i, t3, i, S, p);
+            if(i + 1 <= end) computeNor(t1, i, t5, i, C, lanes.from(i + 1));
+            scratch.give(t5); scratch.give(t4); scratch.give(t3); scratch.give(t2); scratch.give(t1);
+
+            // The carry into bit i was consumed (and the carries shifted into the next lane are discarded)
+            if(lanes.count > 1){
+                gateInit(nMask, lanes.bit(i), true);
+                gateNot(nMask, 0, C, all);
+            }
+            else{
+                gateInit(C, lanes.bit(i), false);
+            }
+
+        }
+
+        // z = S + C
+        size_t nS = nb, nC = B;
+        computeNot(S, 0, nS, all);
+        computeNot(C, 0, nC, all);
+        scratch.give(add(lanes, S, nS, C, nC, CARRY_ZERO, regZ, scratch));
+
+        if(nMask != -1) scratch.give(nMask);
+        scratch.give(pp); scratch.give(B); scratch.give(nb); scratch.give(C); scratch.give(S); scratch.give(nx);
+
+    }
+
+    void generateMultiply(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+        Scratch scratch;
+        multiply({0, format.width, format.lanes}, format.width, regX, regY, regZ, scratch);
+        extend(format, regZ, scratch);
+    }
+
+    /**
+     * Divides the unsigned single-lane registers (restoring division), where the divisor is given by its complement.
+     * Requires the dividend to be less than the divisor shifted by the width of the quotient, unless the divisor bits
+     * beyond the dividend are given (by their suffix OR), in which case the subtractions that they overflow are skipped.
+     * @param width the width of the quotient
+     * @param F the width of the dividend
+     * @param R the dividend (F bits), replaced with the remainder
+     * @param nd the complement of the divisor (extended with ones to F bits)
+     * @param Q the quotient (width bits)
+     * @param high the OR of the divisor bits [k, F) at every partition k (or -1 if F >= 2 * width - 1)
+     * @param scratch
+     */
+    void divide(size_t width, size_t F, size_t R, size_t nd, size_t Q, size_t high, Scratch& scratch){
+
+        // Every iteration subtracts the divisor shifted by i from the bits [i, F) of the remainder
+        gateInit(Q, {0, width - 1, 1}, true);
+        size_t nR = scratch.take(), Y = scratch.take(), nY = scratch.take(), D = scratch.take();
+
+        for(size_t i = width; i-- > 0;){
+
+            Lanes lanes = {i, F - i, 1};
+            RangeMask p = lanes.all();
+
+            // D = R - (d << i), with the carry out (no borrow) at the last bit
+            computeNot(R, i, nR, p);
+            computeNot(nd, 0, Y, p);
+            computeNot(Y, i, nY, p);
+            size_t nG = add(lanes, R, nR, nY, Y, CARRY_ONE, D, scratch);
+
+            // The subtraction is skipped if the divisor bits [F - i, F) are set (as d << i exceeds the remainder)
+            if(high != -1 && i > 0){
+                size_t c = Y;
+                computeNor(nG, F - 1, high, F - i, c, {F - 1, F - 1, 1});
+                computeNot(c, F - 1, nG, {F - 1, F - 1, 1});
+            }
+
+            // Q[i] = carry, and R = carry ? D : R
+            gateNot(nG, F - 1, Q, {i, i, 1});
+            size_t m = nR, nm = nY;
+            broadcast(nG, F - 1, nm, m, p, true);
+            size_t t = Y;
+            computeNor(D, i, nm, i, t, p);
+            computeNor(R, i, m, i, nG, p);
+            computeNor(t, i, nG, i, R, p);
+            scratch.give(nG);
+
+        }
+
+        scratch.give(D); scratch.give(nY); scratch.give(Y); scratch.give(nR);
+
+    }
+
+    /**
+     * Generates division or modulo division of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param remainder
+     */
+    void generateDivision(IntegerFormat format, size_t regX, size_t regY, size_t regZ, bool remainder){
+
+        if(format.lanes != 1 || (format.isSigned && 2 * format.width > CROSSBAR_N)){
+            throw std::runtime_error("Generator: signed division requires a single lane of at most half of the register.");
+        }
+
+        // Unsigned operands are divided within their width, where the divisor bits beyond the remainder are given by
+        // their suffix OR (rather than by extending the dividend), which also supports the full register
+        Scratch scratch;
+        size_t width = format.width, F = format.isSigned ? 2 * width - 1 : width;
+        Lanes lanes = {0, width, 1};
+        RangeMask low(0, width - 1, 1), high(width, F - 1, 1);
+
+        // The magnitudes of the operands: the dividend in R, and the complement of the divisor in nd
+        size_t R = scratch.take(), nd = scratch.take(), Q = scratch.take();
+        if(format.isSigned){
+            conditionalNegate(lanes, regX, regX, width - 1, false, R, scratch);
+            conditionalNegate(lanes, regY, regY, width - 1, false, Q, scratch);
+            computeNot(Q, 0, nd, low);
+        }
+        else{
+            computeNot(regX, 0, nd, low);
+            computeNot(nd, 0, R, low);
+            computeNot(regY, 0, nd, low);
+        }
+        if(F > width){
+            gateInit(R, high, false);
+            gateInit(nd, high, true);
+        }
+
+        // The suffix OR of the divisor bits (S[k] = d[k] | ... | d[F - 1]), by doubling, where nS = ~S
+        size_t S = -1;
+        if(!format.isSigned){
+            S = scratch.take();
+            size_t nS = scratch.take();
+            computeNot(nd, 0, S, low);
+            computeNot(S, 0, nS, low);
+            for(size_t s = 1; s < width; s *= 2){
+                RangeMask p(0, width - 1 - s, 1);
+                computeNor(S, 0, S, s, nS, p);
+                computeNot(nS, 0, S, p);
+            }
+            scratch.give(nS);
+        }
+
+        divide(width, F, R, nd, Q, S, scratch);
+        if(S != -1) scratch.give(S);
+        size_t result = remainder ? R : Q;
+
+        // The sign of the result (of the dividend for the remainder, and the XOR of the signs for the quotient)
+        if(format.isSigned){
+            size_t ns = nd;
+            RangeMask top(width - 1, width - 1, 1);
+            if(remainder) computeNot(regX, width - 1, ns, top);
+            else computeXnor(regX, regY, ns, top, scratch);
+            conditionalNegate(lanes, result, ns, width - 1, true, regZ, scratch);
+        }
+        else{
+            size_t t = nd;
+            computeNot(result, 0, t, low);
+            computeNot(t, 0, regZ, low);
+        }
+
+        scratch.give(Q); scratch.give(nd); scratch.give(R);
+        extend(format, regZ, scratch);
+
+    }
+
+    void generateDivide(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+        generateDivision(format, regX, regY, regZ, false);
+    }
+
+    void generateModulo(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+        generateDivision(format, regX, regY, regZ, true);
+    }
+
+    void generateSign(IntegerFormat format, size_t regX, size_t regZ){
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+        RangeMask result = format.lanes == 1 ? RangeMask(0, CROSSBAR_N - 1, 1) : lanes.all();
+        if(format.isSigned){
+            size_t t = scratch.take();
+            if(format.lanes == 1) broadcast(regX, format.width - 1, regZ, t, result, false);
+            else broadcastLanes(lanes, regX, format.width - 1, regZ, t, false);
+            scratch.give(t);
+        }
+        else{
+            gateInit(regZ, result, false);
+        }
+    }
+
+    void generateZero(IntegerFormat format, size_t regX, size_t regZ){
+
+        Scratch scratch;
+        Lanes lanes = {0, format.width, format.lanes};
+
+        // OR-reduce the bits of every lane into its first partition by folding the upper half onto the lower half
+        // (nR = ~R). Several lanes are folded together across the register, which requires a power-of-two width (so
+        // that the first partition of every lane only accumulates its own lane).
+        bool several = format.lanes > 1;
+        if(several && (format.width & (format.width - 1)))
+            throw std::runtime_error("Generator: zero of several lanes requires a power-of-two width.");
+        size_t R = scratch.take(), nR = scratch.take();
+        size_t length = format.width, src = regX;
+        computeNot(regX, 0, nR, {0, (several ? lanes.all().stop : length - 1), 1});
+        while(length > 1){
+            size_t half = (length + 1) / 2, stop = several ? lanes.all().stop : length - 1;
+            if(src == R) computeNot(nR, 0, R, {0, stop, 1});
+            gateNot(src, half, nR, {0, stop - half, 1});
+            src = R;
+            length = half;
+        }
+
+        // Broadcast the result to the element (extended as the all-one element of the format)
+        size_t t = R;
+        if(several) broadcastLanes(lanes, nR, 0, regZ, t, false);
+        else broadcast(nR, 0, regZ, t, {0, format.isSigned ? CROSSBAR_N - 1 : format.width - 1, 1}, false);
+        scratch.give(nR); scratch.give(R);
+        if(!format.isSigned) extend(format, regZ, scratch);
+
+    }
+
+    /**
+     * Computes whether the first register is less than the second into partition width - 1 of a scratch register, from
+     * the borrow of their subtraction (which never overflows)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param scratch
+     * @return the scratch register (the caller gives it back)
+     */
+    size_t less(IntegerFormat format, size_t regX, size_t regY, Scratch& scratch){
+
+        if(format.lanes != 1) throw std::runtime_error("Generator: comparison requires a single lane.");
+
+        size_t width = format.width, top = width - 1;
+        Lanes lanes = {0, width, 1};
+        RangeMask all = lanes.all(), last(top, top, 1);
+
+        // x < y (unsigned) iff x - y = x + ~y + 1 borrows, i.e., the carry out of the top bit is clear
+        size_t nx = scratch.take(), ny = scratch.take(), z = scratch.take();
+        computeNot(regX, 0, nx, all);
+        computeNot(regY, 0, ny, all);
+        size_t nG = add(lanes, regX, nx, ny, regY, CARRY_ONE, z, scratch);
+
+        // Signed operands are compared as unsigned with their sign bits flipped, which flips the borrow if the signs
+        // differ: lt = nG ^ x ^ y = ~(nG ^ ~(x ^ y))
+        if(format.isSigned){
+            computeXnor(regX, regY, z, last, scratch);
+            computeXnor(nG, z, nx, last, scratch);
+            std::swap(nG, nx);
+        }
+        scratch.give(z); scratch.give(ny); scratch.give(nx);
+        return nG;
+
+    }
+
+    void generateLess(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+
+        Scratch scratch;
+        size_t lt = less(format, regX, regY, scratch), t = scratch.take();
+
+        // Broadcast the result to the element (as the masks of sign)
+        broadcast(lt, format.width - 1, regZ, t, {0, CROSSBAR_N - 1, 1}, false);
+        scratch.give(t); scratch.give(lt);
+
+    }
+
+    /**
+     * Multiplies the given single-lane registers of the given width (the high half of the double-width product)
+     * @param width
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param scratch
+     */
+    void multiplyHigh(size_t width, size_t regX, size_t regY, size_t regZ, Scratch& scratch){
+
+        Lanes lanes = {0, width, 1};
+        RangeMask all = lanes.all(), shifted(0, width - 2, 1), last(width - 1, width - 1, 1);
+
+        // The product is accumulated in carry-save form (S + C) shifted right by a bit per partial product
+        // x & y[i], so that the carries remain in place while the low bits of the sum leave (exactly, as the carries
+        // never reach them)
+        size_t nx = scratch.take(), ny = scratch.take(), S = scratch.take(), C = scratch.take();
+        size_t nb = scratch.take(), B = scratch.take(), pp = scratch.take();
+        computeNot(regX, 0, nx, all);
+        computeNot(regY, 0, ny, all);
+
+        for(size_t i = 0; i < width; i++){
+
+            // nb = ~y[i], broadcast to the element
+            broadcast(ny, i, nb, B, all, false);
+
+            if(i == 0){
+                // (S, C) = ((x & y[0]) >> 1, 0)
+                gateInit(S, last, false);
+                if(width > 1) computeNor(nx, 1, nb, 1, S, shifted);
+                gateInit(C, all, false);
+                continue;
+            }
+
+            // pp = x & y[i]
+            computeNor(nx, 0, nb, 0, pp, all);
+
+            // Full adder (S, C) + pp, where the sum is shifted into the previous bits
+            size_t t1 = scratch.take(), t2 = scratch.take(), t3 = scratch.take(), t4 = scratch.take(), t5 = scratch.take();
+            computeNor(S, 0, C, 0, t1, all);
+            computeNor(S, 0, t1, 0, t2, all);
+            computeNor(C, 0, t1, 0, t3, all);
+            computeNor(t2, 0, t3, 0, t4, all);
+            computeNor(t4, 0, pp, 0, t5, all);
+            computeNor(t4, 0, t5, 0, t2, all);
+            computeNor(pp, 0, t5, 0, t3, all);
+            gateInit(S, last, false);
+            if(width > 1) computeNor(t2, 1, t3, 1, S, shifted);
+            computeNor(t1, 0, t5, 0, C, all);
+            scratch.give(t5); scratch.give(t4); scratch.give(t3); scratch.give(t2); scratch.give(t1);
+
+        }
+
+        // z = S + C (which does not overflow)
+        size_t nS = nb, nC = B;
+        computeNot(S, 0, nS, all);
+        computeNot(C, 0, nC, all);
+        scratch.give(add(lanes, S, nS, C, nC, CARRY_ZERO, regZ, scratch));
+
+        scratch.give(pp); scratch.give(B); scratch.give(nb); scratch.give(C); scratch.give(S); scratch.give(ny); scratch.give(nx);
+
+    }
+
+    void generateMultiplyHigh(IntegerFormat format, size_t regX, size_t regY, size_t regZ){
+
+        if(format.lanes != 1 || format.isSigned){
+            throw std::runtime_error("Generator: the high half of the product requires a single unsigned lane.");
+        }
+
+        Scratch scratch;
+        multiplyHigh(format.width, regX, regY, regZ, scratch);
+        extend(format, regZ, scratch);
+
+    }
+
+    /**
+     * Replaces the single lane of reg (of the given width) with its extreme value where the overflow bit ov[pOv] is set
+     * (the minimum if the sign bit sign[pSign] is set, and the maximum otherwise), and extends it
+     * @param width
+     * @param reg
+     * @param ov
+     * @param pOv
+     * @param sign
+     * @param pSign
+     * @param inverted whether the register holds the complement of the sign
+     * @param scratch
+     */
+    void saturate(size_t width, size_t reg, size_t ov, size_t pOv, size_t sign, size_t pSign, bool inverted,
+                  Scratch& scratch){
+
+        RangeMask all(0, width - 1, 1), low(0, width - 2, 1), top(width - 1, width - 1, 1);
+
+        // The overflow (m) and the sign (s) broadcast to the lane, and their complements
+        size_t m = scratch.take(), nm = scratch.take(), s = scratch.take(), ns = scratch.take();
+        broadcast(ov, pOv, m, nm, all, true);
+        if(inverted) broadcast(sign, pSign, ns, s, all, true);
+        else broadcast(sign, pSign, s, ns, all, true);
+
+        // reg = ~(a | b), where a = ~(reg | m) and b = m & ~extreme (the extreme value is ns below the sign bit and s
+        // at it)
+        size_t a = scratch.take(), b = scratch.take();
+        computeNor(reg, 0, m, 0, a, all);
+        computeNor(nm, 0, ns, 0, b, low);
+        computeNor(nm, width - 1, s, width - 1, b, top);
+        computeNor(a, 0, b, 0, reg, all);
+
+        scratch.give(b); scratch.give(a); scratch.give(ns); scratch.give(s); scratch.give(nm); scratch.give(m);
+        extend({width, 1, true}, reg, scratch);
+
+    }
+
+    /**
+     * Generates saturating fixed-point addition or subtraction of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param subtract
+     */
+    void fixedAdd(FixedFormat format, size_t regX, size_t regY, size_t regZ, bool subtract){
+
+        Scratch scratch;
+        size_t width = format.integer + format.fraction, top = width - 1;
+        Lanes lanes = {0, width, 1};
+        RangeMask last(top, top, 1);
+
+        // Whether the signs of the operands differ (of x and ~y for subtraction), before z may overwrite them
+        size_t nx = scratch.take(), ny = scratch.take(), ne = scratch.take();
+        computeNot(regX, 0, nx, lanes.all());
+        computeNot(regY, 0, ny, lanes.all());
+        computeXnor(regX, subtract ? regY : ny, ne, last, scratch);
+
+        if(subtract) scratch.give(add(lanes, regX, nx, ny, regY, CARRY_ONE, regZ, scratch));
+        else scratch.give(add(lanes, regX, nx, regY, ny, CARRY_ZERO, regZ, scratch));
+
+        // The sum overflows if the signs of the operands agree and differ from its sign: ov = ~ne & d, where
+        // d = z ^ x = ~(z ^ nx)
+        size_t d = scratch.take(), nd = ny, ov = scratch.take();
+        computeXnor(regZ, nx, d, last, scratch);
+        computeNot(d, top, nd, last);
+        computeNor(ne, top, nd, top, ov, last);
+        saturate(width, regZ, ov, top, nx, top, true, scratch);
+
+        scratch.give(ov); scratch.give(d); scratch.give(ne); scratch.give(ny); scratch.give(nx);
+
+    }
+
+    void generateAdd(FixedFormat format, size_t regX, size_t regY, size_t regZ){
+        fixedAdd(format, regX, regY, regZ, false);
+    }
+
+    void generateSubtract(FixedFormat format, size_t regX, size_t regY, size_t regZ){
+        fixedAdd(format, regX, regY, regZ, true);
+    }
+
+    void generateNegate(FixedFormat format, size_t regX, size_t regZ){
+
+        Scratch scratch;
+        size_t width = format.integer + format.fraction, top = width - 1;
+        Lanes lanes = {0, width, 1};
+        RangeMask last(top, top, 1);
+
+        size_t zero = scratch.take(), ones = scratch.take(), nx = scratch.take();
+        gateInit(zero, lanes.all(), false);
+        gateInit(ones, lanes.all(), true);
+        computeNot(regX, 0, nx, lanes.all());
+        scratch.give(add(lanes, zero, ones, nx, regX, CARRY_ONE, regZ, scratch));
+
+        // Only the minimum overflows (into itself), saturating to the maximum: ov = x & z at the sign bit
+        size_t nz = zero, ov = ones;
+        computeNot(regZ, top, nz, last);
+        computeNor(nx, top, nz, top, ov, last);
+        saturate(width, regZ, ov, top, nx, top, false, scratch);
+
+        scratch.give(nx); scratch.give(ones); scratch.give(zero);
+
+    }
+
+    void generateAbsolute(FixedFormat format, size_t regX, size_t regZ){
+
+        Scratch scratch;
+        size_t width = format.integer + format.fraction, top = width - 1;
+        Lanes lanes = {0, width, 1};
+
+        // Only the absolute value of the minimum is negative, saturating to the maximum
+        conditionalNegate(lanes, regX, regX, top, false, regZ, scratch);
+        saturate(width, regZ, regZ, top, regZ, top, true, scratch);
+
+    }
+
+    void generateMultiply(FixedFormat format, size_t regX, size_t regY, size_t regZ){
+
+        Scratch scratch;
+        size_t F = format.fraction, width = format.integer + F, D = 2 * width;
+        RangeMask all(0, width - 1, 1);
+
+        // The exact product of the (extended) operands over 2 * width bits
+        size_t P = scratch.take();
+        multiply({0, D, 1}, D, regX, regY, P, scratch);
+
+        // The rescaled product P >> F overflows unless the bits [F + width - 1, D) agree: every adjacent pair of them
+        // agrees unless u | v, where u = P[p] & ~P[p + 1] and v = ~P[p] & P[p + 1]
+        RangeMask pairs(F + width - 1, D - 2, 1), first(0, 0, 1);
+        size_t t = scratch.take(), u = scratch.take(), v = scratch.take();
+        computeNor(P, pairs.start, P, pairs.start + 1, t, pairs);
+        computeNor(P, pairs.start + 1, t, pairs.start, u, pairs);
+        computeNor(P, pairs.start, t, pairs.start, v, pairs);
+        size_t fits = t, ov = scratch.take();
+        gateInit(fits, first, true);
+        for(size_t p = pairs.start; p <= pairs.stop; p++) gateNor(u, p, v, p, fits, first);
+        computeNot(fits, 0, ov, first);
+
+        // z = P >> F, saturated with the sign of the product
+        computeNot(P, F, u, all);
+        computeNot(u, 0, regZ, all);
+        saturate(width, regZ, ov, 0, P, D - 1, false, scratch);
+
+        scratch.give(ov); scratch.give(v); scratch.give(u); scratch.give(t); scratch.give(P);
+
+    }
+
+    void generateSign(FixedFormat format, size_t regX, size_t regZ){
+        generateSign({format.integer + format.fraction, 1, true}, regX, regZ);
+    }
+
+    void generateZero(FixedFormat format, size_t regX, size_t regZ){
+        generateZero({format.integer + format.fraction, 1, true}, regX, regZ);
+    }
+
+    /**
+     * out[pOut] = ~(src[start] | ... | src[start + length - 1]), reducing two bits per gate
+     * @param src
+     * @param start
+     * @param length
+     * @param out
+     * @param pOut
+     */
+    void reduceNor(size_t src, size_t start, size_t length, size_t out, size_t pOut){
+        RangeMask p(pOut, pOut, 1);
+        gateInit(out, p, true);
+        for(size_t j = 0; j + 1 < length; j += 2) gateNor(src, start + j, src, start + j + 1, out, p);
+        if(length % 2) gateNot(src, start + length - 1, out, p);
+    }
+
+    /**
+     * Checks that the given floating-point format is supported by the generated routines
+     * @param format
+     * @param partitions the number of partitions required by the routine (e.g., by its aligned significands)
+     */
+    void checkFormat(FloatFormat format, size_t partitions){
+        if(format.exponent < 2 || format.mantissa < 1 || format.mantissa + format.exponent + 1 > CROSSBAR_N ||
+                partitions > CROSSBAR_N)
+            throw std::runtime_error("Generator: unsupported floating-point format.");
+    }
+
+    /**
+     * Computes whether to round up (to nearest, ties to even) the significand of R whose guard bit is at partition
+     * guard (where the bits below are sticky), into partition 0 of RU and its complement nRU
+     * @param R
+     * @param nR the complement of R
+     * @param guard
+     * @param RU
+     * @param nRU
+     */
+    void roundUp(size_t R, size_t nR, size_t guard, size_t RU, size_t nRU){
+        RangeMask first(0, 0, 1);
+        // nRU = ~(sticky | lsb)
+        reduceNor(R, 0, guard, nRU, 0);
+        gateNot(R, guard + 1, nRU, first);
+        // RU = guard & (sticky | lsb)
+        gateInit(RU, first, true);
+        gateNot(nR, guard, RU, first);
+        gateNot(nRU, 0, RU, first);
+        computeNot(RU, 0, nRU, first);
+    }
+
+    /**
+     * Rounds and packs a floating-point result into regZ. P holds the mantissa (without the hidden bit) at [0, M) and
+     * the exponent minus one, as a two's complement number of X bits, at [M, M + X). The rounding increment is added
+     * to both at once (as a carry of the mantissa may increment the exponent), and results that overflow are replaced
+     * with infinity. The result is kept if partition 0 of K is set and its exponent is positive, and is otherwise
+     * flushed to zero.
+     * @param format
+     * @param P
+     * @param X
+     * @param RU the rounding increment (partition 0)
+     * @param nRU the complement of the rounding increment (partition 0)
+     * @param K
+     * @param nSign the complement of the sign (partition M + E)
+     * @param regZ
+     * @param scratch
+     */
+    void roundPack(FloatFormat format, size_t P, size_t X, size_t RU, size_t nRU, size_t K, size_t nSign, size_t regZ,
+                   Scratch& scratch){
+
+        size_t M = format.mantissa, E = format.exponent, S = M + E, end = M + X - 1;
+        RangeMask frame(0, end, 1), first(0, 0, 1), mantissa(0, M - 1, 1), exponent(M, S - 1, 1);
+
+        // Flush on underflow (a negative exponent minus one)
+        gateNot(P, end, K, first);
+
+        // P += (1 << M) + RU
+        size_t nP = scratch.take(), C = scratch.take(), nC = scratch.take();
+        computeNot(P, 0, nP, frame);
+        gateInit(C, frame, false);
+        gateInit(C, {M, M, 1}, true);
+        gateInit(nC, frame, true);
+        gateInit(nC, {M, M, 1}, false);
+        scratch.give(add({0, M + X, 1}, P, nP, C, nC, {false, RU, nRU}, P, scratch));
+        computeNot(P, 0, nP, frame);
+
+        // The overflow (an exponent of all-ones or beyond), broadcast to the mantissa and exponent
+        size_t nOv = C, ov = nC, t = scratch.take();
+        reduceNor(nP, M, E, t, M);
+        gateInit(nOv, {M, M, 1}, true);
+        gateNot(t, M, nOv, {M, M, 1});
+        for(size_t b = S; b < end; b++) gateNot(P, b, nOv, {M, M, 1});
+        broadcast(nOv, M, t, ov, {0, S - 1, 1}, true);
+
+        // The kept results, broadcast to the entire word (as the complement nk)
+        size_t k = nOv, nk = t;
+        broadcast(K, 0, k, nk, {0, S, 1}, true);
+
+        // z = keep ? (overflow ? infinity : P) : 0
+        size_t u = k;
+        computeNor(P, M, ov, M, u, exponent);
+        gateInit(regZ, {0, S, 1}, true);
+        gateNor(nP, 0, ov, 0, regZ, mantissa);
+        gateNot(u, M, regZ, exponent);
+        gateNot(nSign, S, regZ, {S, S, 1});
+        gateNot(nk, 0, regZ, {0, S, 1});
+        if(S + 1 < CROSSBAR_N) gateInit(regZ, {S + 1, CROSSBAR_N - 1, 1}, false);
+
+        scratch.give(t); scratch.give(nC); scratch.give(C); scratch.give(nP);
+
+    }
+
+    /**
+     * Generates floating-point addition of the given registers, or subtraction if y is negated
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void floatAdd(FloatFormat format, size_t regX, size_t regY, size_t regZ, bool negate){
+
+        // The significands are aligned within L partitions: the carry at M + 4, the hidden bit at M + 3, and the
+        // guard, round and sticky bits at [0, 3)
+        size_t M = format.mantissa, E = format.exponent, S = M + E, X = E + 2, L = M + 5;
+        checkFormat(format, std::max(L, M + X));
+        size_t K = 0;
+        while((1 << K) < L) K++;
+        if(L - 1 >= (1 << (E + 1))) throw std::runtime_error("Generator: unsupported floating-point format.");
+
+        Scratch scratch;
+        RangeMask word(0, S, 1), significand(0, L - 1, 1), first(0, 0, 1), frame(M, M + X - 1, 1);
+
+        // The complements of the operands, where y is negated for subtraction
+        size_t nx = scratch.take(), ny = scratch.take(), Y = regY;
+        computeNot(regX, 0, nx, word);
+        computeNot(regY, 0, ny, word);
+        if(negate){
+            Y = scratch.take();
+            gateInit(Y, word, true);
+            gateNot(ny, 0, Y, {0, S - 1, 1});
+            gateNot(regY, S, Y, {S, S, 1});
+            gateInit(ny, {S, S, 1}, true);
+            gateNot(Y, S, ny, {S, S, 1});
+        }
+
+        // Whether |x| < |y| (no carry out of |x| + ~|y| + 1), broadcast to the word
+        size_t sw = scratch.take(), nsw = scratch.take();
+        size_t nG = add({0, S, 1}, regX, nx, ny, Y, CARRY_ONE, sw, scratch);
+        broadcast(nG, S - 1, sw, nsw, word, true);
+        scratch.give(nG);
+
+        // B is the operand of the larger magnitude, and A is the other
+        size_t B = scratch.take(), nB = scratch.take(), A = scratch.take(), nA = scratch.take();
+        size_t t1 = scratch.take(), t2 = scratch.take();
+        computeNor(nx, 0, sw, 0, t1, word);
+        computeNor(ny, 0, nsw, 0, t2, word);
+        computeNor(t1, 0, t2, 0, nB, word);
+        computeNot(nB, 0, B, word);
+        computeNor(nx, 0, nsw, 0, t1, word);
+        computeNor(ny, 0, sw, 0, t2, word);
+        computeNor(t1, 0, t2, 0, nA, word);
+        computeNot(nA, 0, A, word);
+        scratch.give(t2); scratch.give(t1); scratch.give(nsw); scratch.give(sw);
+        if(negate) scratch.give(Y);
+        scratch.give(ny); scratch.give(nx);
+
+        // The flags: whether the result is kept (partition 0), and whether the operation is an effective subtraction
+        // (partition 1)
+        size_t FL = scratch.take(), T = scratch.take();
+        computeNor(B, S, A, S, T, {1, 1, 1});
+        size_t w = scratch.take();
+        computeNor(nB, S, nA, S, w, {1, 1, 1});
+        computeNor(T, 1, w, 1, FL, {1, 1, 1});
+        scratch.give(w);
+
+        // The significands (GB of B, and GA of A), where the hidden bit is set for non-zero exponents (as zero
+        // exponents represent zeros)
+        size_t GB = scratch.take(), GA = scratch.take();
+        gateInit(GB, significand, false);
+        gateInit(GB, {3, M + 3, 1}, true);
+        gateNot(nB, 0, GB, {3, M + 2, 1});
+        reduceNor(B, M, E, T, M + 3);
+        gateNot(T, M + 3, GB, {M + 3, M + 3, 1});
+        gateInit(FL, first, true);
+        gateNot(T, M + 3, FL, first);
+        gateInit(GA, significand, false);
+        gateInit(GA, {3, M + 3, 1}, true);
+        gateNot(nA, 0, GA, {3, M + 2, 1});
+        reduceNor(A, M, E, T, M + 3);
+        gateNot(T, M + 3, GA, {M + 3, M + 3, 1});
+
+        // d = eB - eA
+        size_t Dd = scratch.take();
+        scratch.give(add({M, E, 1}, B, nB, nA, A, CARRY_ONE, Dd, scratch));
+        scratch.give(nA); scratch.give(A); scratch.give(nB);
+
+        // A far operand (a zero, or a distance of at least 2^K) is entirely shifted into the sticky bit
+        size_t sel = scratch.take(), nsel = scratch.take(), nGA = scratch.take();
+        t1 = scratch.take(); t2 = scratch.take();
+        gateInit(t1, first, true);
+        gateNot(T, M + 3, t1, first);
+        for(size_t b = M + K; b < M + E; b++) gateNot(Dd, b, t1, first);
+        broadcast(t1, 0, nsel, sel, significand, true);
+        gateNot(sel, 0, GA, significand);
+        gateInit(GA, first, true);
+        gateNor(nsel, 0, T, M + 3, GA, first);
+        computeNot(GA, 0, nGA, significand);
+
+        // Shift GA right by the bits of d, where the shifted-out bits are accumulated into the sticky bit
+        for(size_t k = 0; k < std::min(K, E); k++){
+            size_t s = 1 << k;
+            broadcast(Dd, M + k, sel, nsel, significand, true);
+            // t1 = (GA >> s) & sel, and t2 = GA & ~sel
+            reduceNor(GA, 0, s + 1, t2, 0);
+            gateInit(t1, {0, L - s - 1, 1}, true);
+            if(L - s - 1 >= 1) gateNor(nGA, s + 1, nsel, 1, t1, {1, L - s - 1, 1});
+            gateNor(t2, 0, nsel, 0, t1, first);
+            gateInit(t1, {L - s, L - 1, 1}, false);
+            computeNor(nGA, 0, sel, 0, t2, significand);
+            computeNor(t1, 0, t2, 0, nGA, significand);
+            computeNot(nGA, 0, GA, significand);
+        }
+        scratch.give(Dd);
+
+        // R = GB + (GA ^ sub) + sub (in place of GB)
+        size_t m = sel, nm = nsel;
+        broadcast(FL, 1, m, nm, significand, true);
+        computeNor(GA, 0, m, 0, t1, significand);
+        computeNor(nGA, 0, nm, 0, t2, significand);
+        computeNor(t1, 0, t2, 0, GA, significand);
+        computeNot(GA, 0, nGA, significand);
+        computeNot(GB, 0, t1, significand);
+        scratch.give(t2);
+        scratch.give(add({0, L, 1}, GB, t1, GA, nGA, {false, m, nm}, GB, scratch));
+        t2 = scratch.take();
+        size_t R = GB, nR = t1;
+        computeNot(R, 0, nR, significand);
+
+        // Normalize R (the leading one to L - 1) by shifting left by the bits of the number of leading zeros, whose
+        // complement is accumulated in NZ
+        size_t NZ = GA, u1 = nGA, u2 = t2;
+        gateInit(NZ, frame, true);
+        for(size_t k = K; k-- > 0;){
+            size_t s = 1 << k;
+            reduceNor(R, L - s, s, T, L - s);
+            gateNot(T, L - s, NZ, {M + k, M + k, 1});
+            broadcast(T, L - s, sel, nsel, significand, true);
+            // u1 = (R << s) & sel, and u2 = R & ~sel
+            gateInit(u1, {s, L - 1, 1}, true);
+            gateNor(nR, 0, nsel, s, u1, {s, L - 1, 1});
+            gateInit(u1, {0, s - 1, 1}, false);
+            computeNor(nR, 0, sel, 0, u2, significand);
+            computeNor(u1, 0, u2, 0, nR, significand);
+            computeNot(nR, 0, R, significand);
+        }
+        scratch.give(nsel); scratch.give(sel);
+
+        // The result is zero if R is zero
+        gateNot(nR, L - 1, FL, first);
+
+        // The exponent minus one: eB - z (where the carry into L - 1 is included as the normalization is by one more)
+        size_t EB = u1, nEB = u2, Zc = scratch.take();
+        computeNot(B, M, nEB, {M, S - 1, 1});
+        gateInit(nEB, {S, M + X - 1, 1}, true);
+        computeNot(nEB, M, EB, frame);
+        computeNot(NZ, M, Zc, frame);
+        scratch.give(add({M, X, 1}, EB, nEB, NZ, Zc, CARRY_ONE, EB, scratch));
+        scratch.give(Zc);
+
+        // Round and pack (the mantissa follows the hidden bit at L - 1, with the guard bit at 3), with the sign of B
+        gateInit(EB, {0, M - 1, 1}, true);
+        gateNot(nR, 4, EB, {0, M - 1, 1});
+        size_t RU = NZ, nRU = nEB;
+        roundUp(R, nR, 3, RU, nRU);
+        computeNot(B, S, T, {S, S, 1});
+        scratch.give(t1); scratch.give(GB); scratch.give(B);
+        roundPack(format, EB, X, RU, nRU, FL, T, regZ, scratch);
+
+        scratch.give(nGA); scratch.give(GA); scratch.give(t2); scratch.give(T); scratch.give(FL);
+
+    }
+
+    void generateAdd(FloatFormat format, size_t regX, size_t regY, size_t regZ){
+        floatAdd(format, regX, regY, regZ, false);
+    }
+
+    void generateSubtract(FloatFormat format, size_t regX, size_t regY, size_t regZ){
+        floatAdd(format, regX, regY, regZ, true);
+    }
+
+    /**
+     * Computes the significand of the given register (the mantissa with the hidden bit, which is set for non-zero
+     * exponents) at [pos, pos + M], and zeros in the remainder of the range p
+     * @param format
+     * @param reg
+     * @param pos
+     * @param dst
+     * @param p
+     * @param t a temporary register
+     */
+    void significand(FloatFormat format, size_t reg, size_t pos, size_t dst, RangeMask p, size_t t){
+        size_t M = format.mantissa;
+        RangeMask mantissa(pos, pos + M - 1, 1), hidden(pos + M, pos + M, 1);
+        computeNot(reg, 0, t, mantissa);
+        gateInit(dst, p, false);
+        gateInit(dst, {pos, pos + M, 1}, true);
+        gateNot(t, pos, dst, mantissa);
+        reduceNor(reg, M, format.exponent, t, pos + M);
+        gateNot(t, pos + M, dst, hidden);
+    }
+
+    /**
+     * Sets partition 0 of K to whether the exponents of the given registers are non-zero (both are zero-flushed)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param K
+     * @param t a temporary register
+     */
+    void nonZero(FloatFormat format, size_t regX, size_t regY, size_t K, size_t t){
+        RangeMask first(0, 0, 1);
+        gateInit(K, first, true);
+        reduceNor(regX, format.mantissa, format.exponent, t, 0);
+        gateNot(t, 0, K, first);
+        reduceNor(regY, format.mantissa, format.exponent, t, 0);
+        gateNot(t, 0, K, first);
+    }
+
+    void generateMultiply(FloatFormat format, size_t regX, size_t regY, size_t regZ){
+
+        // The product of the significands occupies 2M + 2 partitions, with the guard bit at M after normalization
+        size_t M = format.mantissa, E = format.exponent, S = M + E, X = E + 2, W = 2 * M + 2;
+        checkFormat(format, std::max(W, M + X));
+
+        Scratch scratch;
+        RangeMask product(0, W - 1, 1), frame(M, M + X - 1, 1), first(0, 0, 1);
+
+        size_t SX = scratch.take(), SY = scratch.take(), T = scratch.take();
+        significand(format, regX, 0, SX, product, T);
+        significand(format, regY, 0, SY, product, T);
+        scratch.give(T);
+        size_t P = scratch.take();
+        multiply({0, W, 1}, M + 1, SX, SY, P, scratch);
+        scratch.give(SY); scratch.give(SX);
+
+        // Normalize the product (in [1, 4)) by shifting left by one if its top bit (t) is clear
+        size_t nP = scratch.take(), sel = scratch.take(), nsel = scratch.take();
+        size_t t1 = scratch.take(), t2 = scratch.take();
+        computeNot(P, 0, nP, product);
+        broadcast(P, W - 1, sel, nsel, product, true);
+        gateInit(t1, product, true);
+        gateNor(nP, 0, sel, 1, t1, {1, W - 1, 1});
+        gateInit(t1, first, false);
+        computeNor(nP, 0, nsel, 0, t2, product);
+        computeNor(t1, 0, t2, 0, nP, product);
+        computeNot(nP, 0, P, product);
+
+        // The exponent minus one: (ex - 2^(E - 1)) + ey + t, where ex - 2^(E - 1) is ex with its top bit flipped and
+        // sign-extended
+        size_t EX = t1, nEX = t2, EY = scratch.take(), nEY = scratch.take();
+        T = scratch.take();
+        computeNot(regX, S - 1, T, {S - 1, S - 1, 1});
+        gateInit(nEX, frame, true);
+        gateNot(regX, M, nEX, {M, S - 2, 1});
+        for(size_t b = S - 1; b < M + X; b++) gateNot(T, S - 1, nEX, {b, b, 1});
+        computeNot(nEX, M, EX, frame);
+        gateInit(nEY, frame, true);
+        gateNot(regY, M, nEY, {M, S - 1, 1});
+        computeNot(nEY, M, EY, frame);
+        scratch.give(T);
+        scratch.give(add({M, X, 1}, EX, nEX, EY, nEY, {false, sel, nsel}, EX, scratch));
+        scratch.give(nEY); scratch.give(EY); scratch.give(nsel); scratch.give(sel); scratch.give(nEX);
+
+        // Round and pack (the mantissa follows the hidden bit at 2M + 1), where zero operands are flushed
+        size_t K = scratch.take(), RU = scratch.take(), nRU = scratch.take();
+        T = scratch.take();
+        nonZero(format, regX, regY, K, T);
+        gateInit(EX, {0, M - 1, 1}, true);
+        gateNot(nP, M + 1, EX, {0, M - 1, 1});
+        roundUp(P, nP, M, RU, nRU);
+        scratch.give(nP); scratch.give(P);
+        computeXnor(regX, regY, T, {S, S, 1}, scratch);
+        roundPack(format, EX, X, RU, nRU, K, T, regZ, scratch);
+
+        scratch.give(T); scratch.give(nRU); scratch.give(RU); scratch.give(K); scratch.give(EX);
+
+    }
+
+    void generateDivide(FloatFormat format, size_t regX, size_t regY, size_t regZ){
+
+        // The quotient of the significands (the dividend shifted by M + 2) has M + 3 bits, with the guard bit at 1 and
+        // the sticky bit at 0 after normalization
+        size_t M = format.mantissa, E = format.exponent, S = M + E, X = E + 2, F = 2 * M + 3, QW = M + 3;
+        checkFormat(format, std::max(F, M + X));
+
+        Scratch scratch;
+        RangeMask dividend(0, F - 1, 1), quotient(0, QW - 1, 1), frame(M, M + X - 1, 1), first(0, 0, 1);
+
+        size_t R = scratch.take(), nd = scratch.take(), Q = scratch.take(), K = scratch.take(), T = scratch.take();
+        significand(format, regX, M + 2, R, dividend, T);
+        gateInit(nd, dividend, true);
+        gateNot(regY, 0, nd, {0, M - 1, 1});
+        reduceNor(regY, M, E, nd, M);
+        nonZero(format, regX, regY, K, T);
+        divide(QW, F, R, nd, Q, -1, scratch);
+
+        // Whether the remainder (less than the divisor) is non-zero
+        size_t nz = nd;
+        reduceNor(R, 0, M + 1, T, 0);
+        computeNot(T, 0, nz, first);
+        scratch.give(R);
+
+        // Normalize the quotient (in (1/2, 2)) by shifting left by one if its top bit (t) is clear, and include the
+        // remainder in the sticky bit
+        size_t nQ = scratch.take(), sel = scratch.take(), nsel = scratch.take();
+        size_t t1 = scratch.take(), t2 = scratch.take();
+        computeNot(Q, 0, nQ, quotient);
+        broadcast(Q, QW - 1, sel, nsel, quotient, true);
+        gateInit(t1, quotient, true);
+        gateNor(nQ, 0, sel, 1, t1, {1, QW - 1, 1});
+        gateInit(t1, first, false);
+        computeNor(nQ, 0, nsel, 0, t2, quotient);
+        computeNor(t1, 0, t2, 0, nQ, quotient);
+        gateNot(nz, 0, nQ, first);
+        computeNot(nQ, 0, Q, quotient);
+        scratch.give(nd);
+
+        // The exponent minus one: ex + (bias - ey) - 2 + t, where bias - ey is ~ey with its top bit flipped and
+        // sign-extended. The operands are first reduced to two in carry-save form, with t as the carry into the first
+        // bit (where the bits of -2 are zero at the first bit, and one at the following bits).
+        size_t EX = t1, nEX = t2, Y = scratch.take(), nY = scratch.take();
+        computeNot(regY, S - 1, T, {S - 1, S - 1, 1});
+        gateInit(nEX, frame, true);
+        gateNot(regX, M, nEX, {M, S - 1, 1});
+        computeNot(nEX, M, EX, frame);
+        gateInit(Y, frame, true);
+        gateNot(regY, M, Y, {M, S - 2, 1});
+        for(size_t b = S - 1; b < M + X; b++) gateNot(T, S - 1, Y, {b, b, 1});
+        computeNot(Y, M, nY, frame);
+        size_t o = scratch.take(), a = scratch.take();
+        computeNor(EX, M, Y, M, o, frame);
+        computeNor(nEX, M, nY, M, a, frame);
+        size_t C = T;
+        gateInit(C, frame, true);
+        gateNot(nsel, M, C, {M, M, 1});
+        gateNor(nEX, M, nY, M, C, {M + 1, M + 1, 1});
+        gateNot(o, M + 1, C, {M + 2, M + X - 1, 1});
+        scratch.give(nsel); scratch.give(sel);
+
+        // The sum bits: x ^ y at the first bit, and ~(x ^ y) at the following bits
+        size_t xo = EX, nxo = nEX, Sm = Y, nSm = nY, nC = o;
+        computeNor(o, M, a, M, xo, frame);
+        computeNot(xo, M, nxo, frame);
+        scratch.give(a);
+        gateInit(Sm, frame, true);
+        gateNot(nxo, M, Sm, {M, M, 1});
+        gateNot(xo, M + 1, Sm, {M + 1, M + X - 1, 1});
+        computeNot(Sm, M, nSm, frame);
+        computeNot(C, M, nC, frame);
+        scratch.give(add({M, X, 1}, Sm, nSm, C, nC, CARRY_ZERO, Sm, scratch));
+        scratch.give(nSm);
+
+        // Round and pack (the mantissa follows the hidden bit at M + 2)
+        size_t RU = xo, nRU = nxo;
+        gateInit(Sm, {0, M - 1, 1}, true);
+        gateNot(nQ, 2, Sm, {0, M - 1, 1});
+        roundUp(Q, nQ, 1, RU, nRU);
+        scratch.give(nQ); scratch.give(Q);
+        computeXnor(regX, regY, T, {S, S, 1}, scratch);
+        roundPack(format, Sm, X, RU, nRU, K, T, regZ, scratch);
+
+        scratch.give(nC); scratch.give(Sm); scratch.give(nxo); scratch.give(xo); scratch.give(T); scratch.give(K);
+
+    }
+
+    /**
+     * Copies the given register to regZ with its sign flipped (or cleared)
+     * @param format
+     * @param regX
+     * @param regZ
+     * @param flip
+     */
+    void replaceSign(FloatFormat format, size_t regX, size_t regZ, bool flip){
+        Scratch scratch;
+        size_t S = format.mantissa + format.exponent;
+        size_t t = scratch.take();
+        computeNot(regX, 0, t, {0, S, 1});
+        gateInit(regZ, {0, S, 1}, true);
+        gateNot(t, 0, regZ, {0, S - 1, 1});
+        if(flip) gateNot(regX, S, regZ, {S, S, 1});
+        else gateInit(regZ, {S, S, 1}, false);
+        if(S + 1 < CROSSBAR_N) gateInit(regZ, {S + 1, CROSSBAR_N - 1, 1}, false);
+        scratch.give(t);
+    }
+
+    void generateNegate(FloatFormat format, size_t regX, size_t regZ){
+        replaceSign(format, regX, regZ, true);
+    }
+
+    void generateAbsolute(FloatFormat format, size_t regX, size_t regZ){
+        replaceSign(format, regX, regZ, false);
+    }
+
+    void generateSign(FloatFormat format, size_t regX, size_t regZ){
+        generateSign(IntegerFormat{format.mantissa + format.exponent + 1, 1, true}, regX, regZ);
+    }
+
+    void generateZero(FloatFormat format, size_t regX, size_t regZ){
+        generateZero(IntegerFormat{format.mantissa + format.exponent + 1, 1, true}, regX, regZ);
+    }
+
+    void generateConvert(FloatFormat from, FloatFormat to, size_t regX, size_t regZ){
+
+        size_t M1 = from.mantissa, E1 = from.exponent, S1 = M1 + E1;
+        size_t M2 = to.mantissa, E2 = to.exponent, S2 = M2 + E2;
+        bool widening = E2 >= E1 && M2 >= M1;
+        size_t X = std::max(E1, E2) + 2;
+        checkFormat(from, 0);
+        checkFormat(to, 0);
+        if(!widening && (M2 > M1 || M2 + X > CROSSBAR_N))
+            throw std::runtime_error("Generator: unsupported floating-point conversion.");
+
+        Scratch scratch;
+        RangeMask word(0, S2, 1), first(0, 0, 1);
+
+        // Zero exponents (zeros and subnormals) are flushed
+        size_t nx = scratch.take(), K = scratch.take(), T = scratch.take();
+        computeNot(regX, 0, nx, {0, S1, 1});
+        gateInit(K, first, true);
+        reduceNor(regX, M1, E1, T, 0);
+        gateNot(T, 0, K, first);
+
+        if(widening){
+
+            // Widening is exact: the mantissa is extended with zeros, and the exponent is rebiased by repeating the
+            // complement of its top bit (e - bias1 + bias2), except for infinities that remain all-one
+            RangeMask exponent(M2, S2 - 1, 1);
+            size_t Z = scratch.take(), nk = scratch.take(), inf = scratch.take(), u = scratch.take();
+            broadcast(K, 0, Z, nk, word, true);
+            reduceNor(nx, M1, E1, T, M2);
+            broadcast(T, M2, inf, u, exponent, false);
+
+            gateInit(Z, word, true);
+            if(M2 > M1) gateInit(Z, {0, M2 - M1 - 1, 1}, false);
+            gateNot(nx, 0, Z, {M2 - M1, M2 - 1, 1});
+            gateNot(nx, M1, Z, {M2, M2 + E1 - 2, 1});
+            for(size_t b = M2 + E1 - 1; b < S2 - 1; b++) gateNot(regX, S1 - 1, Z, {b, b, 1});
+            gateNot(nx, S1 - 1, Z, {S2 - 1, S2 - 1, 1});
+            gateNot(nx, S1, Z, {S2, S2, 1});
+            gateNot(nk, 0, Z, word);
+
+            // z = Z, where infinities are ORed into the exponent
+            computeNot(Z, 0, u, word);
+            gateNot(inf, M2, u, exponent);
+            gateInit(regZ, word, true);
+            gateNot(u, 0, regZ, word);
+            if(S2 + 1 < CROSSBAR_N) gateInit(regZ, {S2 + 1, CROSSBAR_N - 1, 1}, false);
+            scratch.give(u); scratch.give(inf); scratch.give(nk); scratch.give(Z);
+
+        }
+        else{
+
+            // The mantissa is rounded to the leading bits, and the exponent minus one is (e - 2^(E1 - 1)) + bias2, where
+            // e - 2^(E1 - 1) is e with its top bit flipped and sign-extended
+            RangeMask frame(M2, M2 + X - 1, 1);
+            size_t P = scratch.take(), nA = scratch.take(), C = scratch.take(), nC = scratch.take();
+            gateInit(P, {0, M2 + X - 1, 1}, true);
+            gateNot(nx, M1 - M2, P, {0, M2 - 1, 1});
+            gateNot(nx, M1, P, {M2, M2 + E1 - 2, 1});
+            for(size_t b = M2 + E1 - 1; b < M2 + X; b++) gateNot(regX, S1 - 1, P, {b, b, 1});
+            computeNot(P, M2, nA, frame);
+            gateInit(C, frame, false);
+            gateInit(C, {M2, M2 + E2 - 2, 1}, true);
+            gateInit(nC, frame, true);
+            gateInit(nC, {M2, M2 + E2 - 2, 1}, false);
+            scratch.give(add({M2, X, 1}, P, nA, C, nC, CARRY_ZERO, P, scratch));
+            scratch.give(nA);
+
+            size_t RU = C, nRU = nC;
+            if(M1 > M2) roundUp(regX, nx, M1 - M2 - 1, RU, nRU);
+            else{
+                gateInit(RU, first, false);
+                gateInit(nRU, first, true);
+            }
+            computeNot(regX, S1, T, {S2, S2, 1});
+            roundPack(to, P, X, RU, nRU, K, T, regZ, scratch);
+            scratch.give(nC); scratch.give(C); scratch.give(P);
+
+        }
+
+        scratch.give(T); scratch.give(K); scratch.give(nx);
+
+    }
+
+
+    /**
+     * out[pOut] = ~(src[start] | ... | src[start + length - 1]) for a wide source, reducing two bits per gate
+     * @param src
+     * @param start
+     * @param length
+     * @param out
+     * @param pOut
+     */
+    void reduceNor(RegisterPair src, size_t start, size_t length, size_t out, size_t pOut){
+        RangeMask p(pOut, pOut, 1);
+        gateInit(out, p, true);
+        for(size_t j = 0; j + 1 < length; j += 2) gateNor(src, start + j, src, start + j + 1, pairOf(out), p);
+        if(length % 2) gateNot(src, start + length - 1, pairOf(out), p);
+    }
+
+    /**
+     * dst[p] = src[p - p.start + pSrc] for the contiguous partitions p of wide values, where dst may be src (e.g., to
+     * shift in place, as the registers are copied in the order of the shift)
+     * @param src
+     * @param pSrc
+     * @param dst
+     * @param p
+     * @param scratch
+     */
+    void copy(RegisterPair src, size_t pSrc, RegisterPair dst, RangeMask p, Scratch& scratch){
+        size_t t = scratch.take();
+        for(size_t k = 0; k < 2; k++){
+            size_t base = (pSrc >= p.start) == (k == 0) ? 0 : CROSSBAR_N;
+            size_t lo = std::max(p.start, base), hi = std::min(p.stop, base + CROSSBAR_N - 1);
+            if(lo > hi) continue;
+            computeNot(src, pSrc + lo - p.start, pairOf(t), {lo, hi, 1});
+            computeNot(pairOf(t), lo, dst, {lo, hi, 1});
+        }
+        scratch.give(t);
+    }
+
+    /**
+     * out[p] = c ? P[p - p.start + pP] : Q[p - p.start + pQ] for the contiguous partitions p of wide values, where c
+     * is uniform across its partitions and nc is its complement (as out = ~(~(P | nc) | ~(Q | c)))
+     * @param P
+     * @param pP
+     * @param Q
+     * @param pQ
+     * @param c
+     * @param nc
+     * @param out
+     * @param p
+     * @param scratch
+     */
+    void select(RegisterPair P, size_t pP, RegisterPair Q, size_t pQ, size_t c, size_t nc, RegisterPair out, RangeMask p,
+                Scratch& scratch){
+        size_t u = scratch.take(), w = scratch.take();
+        for(size_t base = 0; base < 2 * CROSSBAR_N; base += CROSSBAR_N){
+            size_t lo = std::max(p.start, base), hi = std::min(p.stop, base + CROSSBAR_N - 1);
+            if(lo > hi) continue;
+            RangeMask q(lo, hi, 1);
+            computeNor(P, pP + lo - p.start, pairOf(nc), lo, pairOf(u), q);
+            computeNor(Q, pQ + lo - p.start, pairOf(c), lo, pairOf(w), q);
+            computeNor(pairOf(u), lo, pairOf(w), lo, out, q);
+        }
+        scratch.give(w); scratch.give(u);
+    }
+
+    /**
+     * reg[p] = sel ? reg[p + s] : reg[p] for the partitions p in [start, length) of a wide value (where s may be
+     * negative), in place, where the partitions beyond [0, length) are zeros. sel is uniform across its partitions and
+     * nsel is its complement.
+     * @param reg
+     * @param start
+     * @param length
+     * @param s
+     * @param sel
+     * @param nsel
+     * @param scratch
+     */
+    void shiftSelect(RegisterPair reg, size_t start, size_t length, size_t s, size_t sel, size_t nsel, Scratch& scratch){
+        size_t u = scratch.take(), w = scratch.take();
+        for(size_t k = 0; k < 2; k++){
+            size_t base = (s >= 0) == (k == 0) ? 0 : CROSSBAR_N;
+            size_t lo = std::max(start, base), hi = std::min(length - 1, base + CROSSBAR_N - 1);
+            if(lo > hi) continue;
+            RangeMask q(lo, hi, 1);
+            // u = sel & ~reg[p + s], and w = ~sel & ~reg[p]
+            size_t vLo = std::max(lo, -s), vHi = std::min(hi, length - 1 - s);
+            computeNot(pairOf(nsel), lo, pairOf(u), q);
+            if(vLo <= vHi) gateNot(reg, vLo + s, pairOf(u), {vLo, vHi, 1});
+            computeNor(reg, lo, pairOf(sel), lo, pairOf(w), q);
+            computeNor(pairOf(u), lo, pairOf(w), lo, reg, q);
+        }
+        scratch.give(w); scratch.give(u);
+    }
+
+    /**
+     * Checks that the given integer format is supported by the wide generated routines
+     * @param format
+     */
+    void checkWide(IntegerFormat format){
+        if(format.width != 2 * CROSSBAR_N || format.lanes != 1)
+            throw std::runtime_error("Generator: wide integers require a single lane of two registers.");
+    }
+
+    void generateAdd(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        checkWide(format);
+        Scratch scratch;
+        scratch.give(addWide(format.width, regX, regY, -1, false, CARRY_ZERO, regZ, scratch));
+    }
+
+    void generateSubtract(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        checkWide(format);
+        Scratch scratch;
+        scratch.give(addWide(format.width, regX, regY, -1, true, CARRY_ONE, regZ, scratch));
+    }
+
+    void generateNegate(IntegerFormat format, RegisterPair regX, RegisterPair regZ){
+        checkWide(format);
+        Scratch scratch;
+        size_t zero = scratch.take();
+        gateInit(zero, {0, CROSSBAR_N - 1, 1}, false);
+        scratch.give(addWide(format.width, pairOf(zero), regX, -1, true, CARRY_ONE, regZ, scratch));
+        scratch.give(zero);
+    }
+
+    /**
+     * Negates the given wide value if its sign is set (given by a partition of a register), into dst
+     * @param src
+     * @param sign the register holding the sign
+     * @param pSign the partition of the sign
+     * @param inverted whether the register holds the complement of the sign
+     * @param dst
+     * @param scratch
+     */
+    void conditionalNegate(RegisterPair src, size_t sign, size_t pSign, bool inverted, RegisterPair dst,
+                           Scratch& scratch){
+        RangeMask word(0, CROSSBAR_N - 1, 1);
+        size_t m = scratch.take(), nm = scratch.take(), zero = scratch.take();
+        if(inverted) broadcast(sign, pSign, nm, m, word, true);
+        else broadcast(sign, pSign, m, nm, word, true);
+        // dst = 0 + (src ^ m) + sign
+        gateInit(zero, word, false);
+        scratch.give(addWide(2 * CROSSBAR_N, pairOf(zero), src, m, false, {false, m, nm}, dst, scratch));
+        scratch.give(zero); scratch.give(nm); scratch.give(m);
+    }
+
+    void generateAbsolute(IntegerFormat format, RegisterPair regX, RegisterPair regZ){
+        checkWide(format);
+        Scratch scratch;
+        if(format.isSigned) conditionalNegate(regX, regX.high, CROSSBAR_N - 1, false, regZ, scratch);
+        else copy(regX, 0, regZ, {0, format.width - 1, 1}, scratch);
+    }
+
+    void generateMultiply(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+
+        checkWide(format);
+        Scratch scratch;
+        size_t width = format.width;
+        RangeMask all(0, width - 1, 1), word(0, CROSSBAR_N - 1, 1);
+
+        // The product is accumulated in carry-save form (S + C, where S is regZ) over the partial products
+        // x << i & y[i]
+        RegisterPair nx = {scratch.take(), scratch.take()}, C = {scratch.take(), scratch.take()}, S = regZ;
+        size_t B = scratch.take(), nb = scratch.take();
+        computeNot(regX, 0, nx, all);
+
+        for(size_t i = 0; i < width; i++){
+
+            broadcast(wordOf(regY, i), i % CROSSBAR_N, B, nb, word, true);
+
+            if(i == 0){
+                // (S, C) = (x & y[0], 0)
+                computeNor(nx, 0, pairOf(nb), 0, S, all);
+                gateInit(C, all, false);
+                continue;
+            }
+
+            // The registers of the partitions [i, width) in turn, where the carries are shifted into the following
+            // bits (the high register first, as its carries are not read by the low register)
+            for(size_t base = CROSSBAR_N; base >= 0; base -= CROSSBAR_N){
+
+                size_t lo = std::max(i, base), hi = base + CROSSBAR_N - 1;
+                if(lo > hi) continue;
+                RangeMask q(lo, hi, 1);
+
+                // pp = (x << i) & y[i], and the full adder (S, C) + pp
+                size_t pp = scratch.take(), t1 = scratch.take(), t2 = scratch.take(), t3 = scratch.take();
+                size_t t4 = scratch.take(), t5 = scratch.take();
+                computeNor(nx, lo - i, pairOf(nb), lo, pairOf(pp), q);
+                computeNor(S, lo, C, lo, pairOf(t1), q);
+                computeNor(S, lo, pairOf(t1), lo, pairOf(t2), q);
+                computeNor(C, lo, pairOf(t1), lo, pairOf(t3), q);
+                computeNor(pairOf(t2), lo, pairOf(t3), lo, pairOf(t4), q);
+                computeNor(pairOf(t4), lo, pairOf(pp), lo, pairOf(t5), q);
+                computeNor(pairOf(t4), lo, pairOf(t5), lo, pairOf(t2), q);
+                computeNor(pairOf(pp), lo, pairOf(t5), lo, pairOf(t3), q);
+                computeNor(pairOf(t2), lo, pairOf(t3), lo, S, q);
+                if(lo + 1 < width) computeNor(pairOf(t1), lo, pairOf(t5), lo, C, {lo + 1, std::min(hi + 1, width - 1), 1});
+                scratch.give(t5); scratch.give(t4); scratch.give(t3); scratch.give(t2); scratch.give(t1); scratch.give(pp);
+
+            }
+
+            // The carry into bit i was consumed
+            gateInit(C, {i, i, 1}, false);
+
+        }
+        scratch.give(nb); scratch.give(B); scratch.give(nx.high); scratch.give(nx.low);
+
+        // z = S + C
+        scratch.give(addWide(width, S, C, -1, false, CARRY_ZERO, regZ, scratch));
+        scratch.give(C.high); scratch.give(C.low);
+
+    }
+
+    /**
+     * Generates division or modulo division of the given wide registers (non-restoring division of the magnitudes,
+     * where the quotient replaces the dividend in regZ bit by bit)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param remainder
+     */
+    void generateDivision(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ, bool remainder){
+
+        checkWide(format);
+        Scratch scratch;
+        size_t width = format.width, top = CROSSBAR_N - 1;
+        RangeMask all(0, width - 1, 1), word(0, top, 1), first(0, 0, 1);
+
+        // The magnitudes of the operands: the dividend in regZ, and the divisor in D (which are at most 2^(width - 1),
+        // so that the remainder fits the width)
+        if(!format.isSigned) throw std::runtime_error("Generator: division of wide integers requires a signed format.");
+        RegisterPair D = {scratch.take(), scratch.take()};
+        conditionalNegate(regX, regX.high, top, false, regZ, scratch);
+        conditionalNegate(regY, regY.high, top, false, D, scratch);
+
+        // Every iteration shifts the next bit of the dividend into the (signed) remainder R, and subtracts the divisor
+        // if R is non-negative (or adds it otherwise). The bit of the quotient is whether the result is non-negative.
+        RegisterPair R = {scratch.take(), scratch.take()};
+        size_t m = scratch.take();
+        gateInit(R, all, false);
+        gateInit(m, word, false);
+        for(size_t i = width; i-- > 0;){
+
+            if(i != width - 1){
+                size_t nm = scratch.take();
+                broadcast(R.high, top, m, nm, word, false);
+                scratch.give(nm);
+            }
+            size_t t = scratch.take();
+            copy(R, 0, R, {1, width - 1, 1}, scratch);
+            computeNot(regZ, i, pairOf(t), {0, 0, 1});
+            computeNot(pairOf(t), 0, R, {0, 0, 1});
+            scratch.give(t);
+
+            // R = R + (m ? d : ~d + 1)
+            scratch.give(addWide(width, R, D, m, true, {false, m, m}, R, scratch));
+            gateInit(regZ, {i, i, 1}, true);
+            gateNot(R, width - 1, regZ, {i, i, 1});
+
+        }
+        scratch.give(m);
+
+        if(remainder){
+            // The remainder is R, corrected by the divisor if negative, with the sign of the dividend
+            m = scratch.take();
+            size_t nm = scratch.take();
+            broadcast(R.high, top, m, nm, word, true);
+            select(D, 0, pairOf(m), 0, m, nm, D, all, scratch);
+            scratch.give(nm); scratch.give(m);
+            scratch.give(addWide(width, R, D, -1, false, CARRY_ZERO, R, scratch));
+            scratch.give(D.high); scratch.give(D.low);
+            conditionalNegate(R, regX.high, top, false, regZ, scratch);
+            scratch.give(R.high); scratch.give(R.low);
+        }
+        else{
+            // The sign of the quotient is the XOR of the signs
+            scratch.give(R.high); scratch.give(R.low); scratch.give(D.high); scratch.give(D.low);
+            size_t ns = scratch.take();
+            computeXnor(regX.high, regY.high, ns, {top, top, 1}, scratch);
+            conditionalNegate(regZ, ns, top, true, regZ, scratch);
+            scratch.give(ns);
+        }
+
+    }
+
+    void generateDivide(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        generateDivision(format, regX, regY, regZ, false);
+    }
+
+    void generateModulo(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        generateDivision(format, regX, regY, regZ, true);
+    }
+
+    void generateSign(IntegerFormat format, RegisterPair regX, size_t regZ){
+        checkWide(format);
+        Scratch scratch;
+        RangeMask word(0, CROSSBAR_N - 1, 1);
+        if(format.isSigned){
+            size_t t = scratch.take();
+            broadcast(regX.high, CROSSBAR_N - 1, regZ, t, word, false);
+            scratch.give(t);
+        }
+        else{
+            gateInit(regZ, word, false);
+        }
+    }
+
+    void generateZero(IntegerFormat format, RegisterPair regX, size_t regZ){
+
+        checkWide(format);
+        Scratch scratch;
+
+        // OR the registers together, and then OR-reduce the register into its first partition by folding (nR = ~R)
+        size_t R = scratch.take(), nR = scratch.take();
+        computeNor(regX.low, 0, regX.high, 0, nR, {0, CROSSBAR_N - 1, 1});
+        for(size_t length = CROSSBAR_N; length > 1; length /= 2){
+            computeNot(nR, 0, R, {0, length - 1, 1});
+            gateNot(R, length / 2, nR, {0, length / 2 - 1, 1});
+        }
+
+        broadcast(nR, 0, regZ, R, {0, CROSSBAR_N - 1, 1}, false);
+        scratch.give(nR); scratch.give(R);
+
+    }
+
+    /**
+     * Checks that the given floating-point format is supported by the wide generated routines: the mantissa fills the
+     * low register, and the exponent and the sign are at the top of the high register
+     * @param format
+     * @param partitions the number of partitions required by the routine (e.g., by its aligned significands)
+     */
+    void checkWide(FloatFormat format, size_t partitions){
+        if(format.mantissa < CROSSBAR_N || format.mantissa + format.exponent + 1 != 2 * CROSSBAR_N ||
+                format.exponent + 2 > CROSSBAR_N || partitions > 2 * CROSSBAR_N)
+            throw std::runtime_error("Generator: unsupported wide floating-point format.");
+    }
+
+    /**
+     * Rounds and packs a floating-point result into regZ (a pair, or a single register for formats that fit a word).
+     * P holds the mantissa (without the hidden bit) at [0, M), and EX holds the exponent minus one as a two's
+     * complement number of X bits. The rounding increment is added to the mantissa, whose carry increments the
+     * exponent, and results that overflow are replaced with infinity. The result is kept if partition 1 of F is set
+     * and its exponent is positive, and is otherwise flushed to zero.
+     * @param format
+     * @param P
+     * @param EX
+     * @param X
+     * @param F the flags: the complement of the rounding increment (partition 0), whether the result is kept
+     * (partition 1), and the sign (partition pSign)
+     * @param pSign
+     * @param regZ
+     * @param scratch
+     */
+    void roundPack(FloatFormat format, RegisterPair P, size_t EX, size_t X, size_t F, size_t pSign, RegisterPair regZ,
+                   Scratch& scratch){
+
+        size_t M = format.mantissa, E = format.exponent, S = M + E;
+        size_t top = S < CROSSBAR_N ? CROSSBAR_N - 1 : 2 * CROSSBAR_N - 1;
+        RangeMask frame(0, X - 1, 1), first(0, 0, 1), word(0, CROSSBAR_N - 1, 1);
+
+        // Flush on underflow (a negative exponent minus one)
+        gateNot(EX, X - 1, F, {1, 1, 1});
+
+        // P += RU, with the carry out (moved to the first partition of nG, as its complement)
+        size_t one = scratch.take();
+        gateInit(one, word, false);
+        size_t nG = addWide(M, P, pairOf(one), -1, false, {false, F, F}, P, scratch);
+        size_t nOne = scratch.take();
+        computeNot(nG, (M - 1) % CROSSBAR_N, nOne, first);
+        computeNot(nOne, 0, nG, first);
+
+        // EX += 1 + carry
+        size_t nEX = scratch.take();
+        gateInit(one, first, true);
+        computeNot(one, 0, nOne, frame);
+        computeNot(EX, 0, nEX, frame);
+        scratch.give(add({0, X, 1}, EX, nEX, one, nOne, {false, nG, nG}, EX, scratch));
+        scratch.give(nG);
+        computeNot(EX, 0, nEX, frame);
+
+        // The overflow (an exponent of all-ones or beyond), broadcast to the word
+        size_t nOv = nOne, ov = nEX, t = one;
+        reduceNor(nEX, 0, E, t, 0);
+        gateInit(nOv, first, true);
+        gateNot(t, 0, nOv, first);
+        for(size_t b = E; b < X - 1; b++) gateNot(EX, b, nOv, first);
+        broadcast(nOv, 0, nOv, ov, word, true);
+
+        // The kept results, broadcast to the word (as the complement nk)
+        size_t nk = nOv;
+        broadcast(F, 1, t, nk, word, true);
+
+        // z = keep ? (overflow ? infinity : P) : 0
+        for(size_t base = 0; base < M; base += CROSSBAR_N){
+            RangeMask q(base, std::min(M, base + CROSSBAR_N) - 1, 1);
+            computeNot(P, base, pairOf(t), q);
+            gateInit(regZ, q, true);
+            gateNor(pairOf(t), base, pairOf(ov), base, regZ, q);
+        }
+        RangeMask exponent(M, S - 1, 1);
+        computeNor(pairOf(EX), 0, pairOf(ov), 0, pairOf(t), exponent);
+        gateInit(regZ, exponent, true);
+        gateNot(pairOf(t), M, regZ, exponent);
+        computeNot(pairOf(F), pSign, pairOf(t), {S, S, 1});
+        gateInit(regZ, {S, S, 1}, true);
+        gateNot(pairOf(t), S, regZ, {S, S, 1});
+        gateNot(pairOf(nk), 0, regZ, {0, S, 1});
+        if(S < top) gateInit(regZ, {S + 1, top, 1}, false);
+
+        scratch.give(nEX); scratch.give(nOne); scratch.give(one);
+
+    }
+
+    /**
+     * Computes the significand of the given wide register (the mantissa with the hidden bit, which is set for non-zero
+     * exponents) at [0, M], and zeros in the partitions [M + 1, width)
+     * @param format
+     * @param reg
+     * @param dst
+     * @param width
+     * @param scratch
+     */
+    void significand(FloatFormat format, RegisterPair reg, RegisterPair dst, size_t width, Scratch& scratch){
+        size_t M = format.mantissa;
+        RangeMask hidden(M, M, 1);
+        copy(reg, 0, dst, {0, M - 1, 1}, scratch);
+        if(M + 1 < width) gateInit(dst, {M + 1, width - 1, 1}, false);
+        size_t t = scratch.take();
+        reduceNor(reg, M, format.exponent, t, M % CROSSBAR_N);
+        gateInit(dst, hidden, true);
+        gateNot(pairOf(t), M, dst, hidden);
+        scratch.give(t);
+    }
+
+    /**
+     * Generates floating-point addition of the given wide registers, or subtraction if y is negated
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void floatAdd(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ, bool negate){
+
+        // The significands are aligned within L partitions (as in the single-register routine), while the
+        // exponents and the signs are handled within the high registers, at [pE, pS]
+        size_t M = format.mantissa, E = format.exponent, S = M + E, X = E + 2, L = M + 5;
+        checkWide(format, L);
+        size_t K = 0;
+        while((1 << K) < L) K++;
+        if(L - 1 >= (1 << (E + 1))) throw std::runtime_error("Generator: unsupported wide floating-point format.");
+
+        Scratch scratch;
+        size_t pE = M - CROSSBAR_N, pS = S - CROSSBAR_N, pH = (M + 3) % CROSSBAR_N;
+        RangeMask word(0, CROSSBAR_N - 1, 1), first(0, 0, 1), high(pE, pS, 1), frame(0, X - 1, 1);
+
+        // Whether |x| < |y| (no carry out of |x| + ~|y| + 1, where regZ is a temporary), broadcast to the word
+        size_t sw = scratch.take(), nsw = scratch.take();
+        size_t nG = addWide(S, regX, regY, -1, true, CARRY_ONE, regZ, scratch);
+        broadcast(nG, (S - 1) % CROSSBAR_N, sw, nsw, word, true);
+        scratch.give(nG);
+
+        // The exponents and the signs of B (the operand of the larger magnitude) and A (the other), where y is
+        // negated for subtraction (in regZ)
+        size_t Bh = scratch.take(), Ah = scratch.take(), Yh = regY.high;
+        if(negate){
+            Yh = regZ.high;
+            computeNot(regY.high, pE, regZ.low, high);
+            gateInit(Yh, high, true);
+            gateNot(regZ.low, pE, Yh, {pE, pS - 1, 1});
+            gateNot(regY.high, pS, Yh, {pS, pS, 1});
+        }
+        select(pairOf(Yh), pE, pairOf(regX.high), pE, sw, nsw, pairOf(Bh), high, scratch);
+        select(pairOf(regX.high), pE, pairOf(Yh), pE, sw, nsw, pairOf(Ah), high, scratch);
+
+        // The significands (GB of B, and GA of A in regZ), where the hidden bit is set for non-zero exponents (as zero
+        // exponents represent zeros), and whether the result is kept (partition 1 of Bh)
+        RegisterPair GB = {scratch.take(), scratch.take()}, GA = regZ;
+        size_t T = scratch.take();
+        select(regY, 0, regX, 0, sw, nsw, GB, {3, M + 2, 1}, scratch);
+        select(regX, 0, regY, 0, sw, nsw, GA, {3, M + 2, 1}, scratch);
+        scratch.give(nsw); scratch.give(sw);
+        gateInit(GB, {0, 2, 1}, false);
+        gateInit(GB, {M + 3, L - 1, 1}, false);
+        gateInit(GA, {0, 2, 1}, false);
+        gateInit(GA, {M + 3, L - 1, 1}, false);
+        reduceNor(Bh, pE, E, T, pH);
+        gateInit(GB, {M + 3, M + 3, 1}, true);
+        gateNot(pairOf(T), M + 3, GB, {M + 3, M + 3, 1});
+        gateInit(Bh, {1, 1, 1}, true);
+        gateNot(T, pH, Bh, {1, 1, 1});
+        reduceNor(Ah, pE, E, T, pH);
+        gateInit(GA, {M + 3, M + 3, 1}, true);
+        gateNot(pairOf(T), M + 3, GA, {M + 3, M + 3, 1});
+
+        // d = eB - eA (in place of the exponent of A)
+        size_t nBh = scratch.take(), nAh = scratch.take();
+        computeNot(Bh, pE, nBh, {pE, pS - 1, 1});
+        computeNot(Ah, pE, nAh, {pE, pS - 1, 1});
+        scratch.give(add({pE, E, 1}, Bh, nBh, nAh, Ah, CARRY_ONE, Ah, scratch));
+        scratch.give(nAh); scratch.give(nBh);
+
+        // A far operand (a zero, or a distance of at least 2^K) is entirely shifted into the sticky bit
+        size_t sel = scratch.take(), nsel = scratch.take(), u = scratch.take();
+        gateInit(u, first, true);
+        gateNot(T, pH, u, first);
+        for(size_t b = K; b < E; b++) gateNot(Ah, pE + b, u, first);
+        broadcast(u, 0, nsel, sel, word, true);
+        gateNot(pairOf(sel), 0, GA, {0, L - 1, 1});
+        gateInit(GA, first, true);
+        gateNor(pairOf(nsel), 0, pairOf(T), pH, GA, first);
+
+        // Shift GA right by the bits of d, where the shifted-out bits are accumulated into the sticky bit
+        // (GA[0] |= sel & ~T)
+        size_t w = scratch.take();
+        for(size_t k = 0; k < K; k++){
+            size_t s = 1 << k;
+            broadcast(Ah, pE + k, sel, nsel, word, true);
+            reduceNor(GA, 0, s + 1, T, 0);
+            shiftSelect(GA, 1, L, s, sel, nsel, scratch);
+            computeNor(T, 0, nsel, 0, u, first);
+            computeNor(GA.low, 0, u, 0, w, first);
+            computeNot(w, 0, GA.low, first);
+        }
+        scratch.give(w); scratch.give(u);
+
+        // R = GB + (GA ^ sub) + sub (in place of GB), where sub is whether the operation is an effective subtraction
+        size_t m = sel, nm = nsel;
+        computeXnor(Bh, Ah, T, {pS, pS, 1}, scratch);
+        scratch.give(Ah);
+        broadcast(T, pS, nm, m, word, true);
+        scratch.give(T);
+        scratch.give(addWide(L, GB, GA, m, false, {false, nm, nm}, GB, scratch));
+        RegisterPair R = GB;
+
+        // Normalize R (the leading one to L - 1) by shifting left by the bits of the number of leading zeros, whose
+        // complement is accumulated in NZ
+        size_t NZ = scratch.take();
+        T = scratch.take();
+        gateInit(NZ, frame, true);
+        for(size_t k = K; k-- > 0;){
+            size_t s = 1 << k;
+            reduceNor(R, L - s, s, T, 0);
+            gateNot(T, 0, NZ, {k, k, 1});
+            broadcast(T, 0, sel, nsel, word, true);
+            shiftSelect(R, 0, L, -s, sel, nsel, scratch);
+        }
+
+        // The result is zero if R is zero
+        computeNot(R, L - 1, pairOf(T), {1, 1, 1});
+        gateNot(T, 1, Bh, {1, 1, 1});
+
+        // The exponent minus one: eB - z (where the carry into L - 1 is included as the normalization is by one more)
+        size_t EB = sel, nEB = nsel, Zc = T;
+        computeNot(Bh, pE, nEB, {0, E - 1, 1});
+        gateInit(nEB, {E, X - 1, 1}, true);
+        computeNot(nEB, 0, EB, frame);
+        computeNot(NZ, 0, Zc, frame);
+        scratch.give(add({0, X, 1}, EB, nEB, NZ, Zc, CARRY_ONE, EB, scratch));
+
+        // Round and pack (the mantissa follows the hidden bit at L - 1, with the guard bit at 3), with the sign of B
+        size_t nR = nEB, RU = NZ;
+        computeNot(R.low, 0, nR, word);
+        roundUp(R.low, nR, 3, RU, Bh);
+        scratch.give(T); scratch.give(NZ); scratch.give(nEB);
+        copy(R, 4, R, {0, M - 1, 1}, scratch);
+        roundPack(format, R, EB, X, Bh, pS, regZ, scratch);
+
+        scratch.give(EB); scratch.give(GB.high); scratch.give(GB.low); scratch.give(Bh);
+
+    }
+
+    void generateAdd(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        floatAdd(format, regX, regY, regZ, false);
+    }
+
+    void generateSubtract(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+        floatAdd(format, regX, regY, regZ, true);
+    }
+
+    /**
+     * Computes the complement of the exponent of the given wide register minus 2^(E - 1) (its top bit flipped and
+     * sign-extended) at [0, X) of dst, which is also bias - e
+     * @param format
+     * @param reg
+     * @param X
+     * @param dst
+     * @param t a temporary register
+     */
+    void unbias(FloatFormat format, RegisterPair reg, size_t X, size_t dst, size_t t){
+        size_t E = format.exponent, pE = format.mantissa - CROSSBAR_N, pTop = pE + E - 1;
+        computeNot(reg.high, pTop, t, {pTop, pTop, 1});
+        computeNot(reg.high, pE, dst, {0, E - 2, 1});
+        gateInit(dst, {E - 1, X - 1, 1}, true);
+        for(size_t b = E - 1; b < X; b++) gateNot(t, pTop, dst, {b, b, 1});
+    }
+
+    void generateMultiply(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+
+        // The significands are multiplied by shift-and-add (the product is shifted right by one bit per iteration), where
+        // the shifted-out bits are kept as the guard bits (b51 and b52 in F) and the sticky bit
+        size_t M = format.mantissa, E = format.exponent, X = E + 2, W = M + 2;
+        checkWide(format, M + 5);
+
+        Scratch scratch;
+        size_t pE = M - CROSSBAR_N, pS = M + E - CROSSBAR_N;
+        RangeMask word(0, CROSSBAR_N - 1, 1), first(0, 0, 1), frame(0, X - 1, 1), product(0, W - 1, 1);
+
+        // The significand of x (in regZ), the flags (the complement of the hidden bit of y at partition 0, the guard
+        // bits at 1 and 2, and the complement of the sticky bit at 3), and the sum and the carries of the product
+        RegisterPair SX = regZ;
+        size_t F = scratch.take();
+        significand(format, regX, SX, W, scratch);
+        reduceNor(regY, M, E, F, 0);
+        gateInit(F, {3, 3, 1}, true);
+        RegisterPair Sm = {scratch.take(), scratch.take()}, C = {scratch.take(), scratch.take()};
+        gateInit(Sm, product, false);
+        gateInit(C, product, false);
+
+        size_t sel = scratch.take(), nsel = scratch.take();
+        for(size_t i = 0; i <= M; i++){
+
+            // sel = y[i] (the hidden bit for i = M)
+            if(i < M) broadcast(wordOf(regY, i), i % CROSSBAR_N, sel, nsel, word, true);
+            else broadcast(F, 0, nsel, sel, word, true);
+
+            // The full adder (S, C) + (SX & sel), where the sum is shifted right (the low register first)
+            size_t out = i == M ? 2 : (i == M - 1 ? 1 : 4);
+            for(size_t base = 0; base < W; base += CROSSBAR_N){
+                size_t lo = base, hi = std::min(W - 1, base + CROSSBAR_N - 1);
+                RangeMask q(lo, hi, 1);
+                size_t t1 = scratch.take(), t2 = scratch.take(), t3 = scratch.take();
+                size_t t4 = scratch.take(), t5 = scratch.take();
+                computeNor(Sm, lo, C, lo, pairOf(t1), q);
+                computeNor(Sm, lo, pairOf(t1), lo, pairOf(t2), q);
+                computeNor(C, lo, pairOf(t1), lo, pairOf(t3), q);
+                computeNor(pairOf(t2), lo, pairOf(t3), lo, pairOf(t4), q);
+                computeNot(SX, lo, pairOf(t2), q);
+                computeNor(pairOf(t2), lo, pairOf(nsel), lo, pairOf(t3), q);
+                computeNor(pairOf(t4), lo, pairOf(t3), lo, pairOf(t5), q);
+                computeNor(pairOf(t1), lo, pairOf(t5), lo, C, q);
+                computeNor(pairOf(t3), lo, pairOf(t5), lo, pairOf(t1), q);
+                computeNor(pairOf(t4), lo, pairOf(t5), lo, pairOf(t2), q);
+                if(lo == 0) computeNor(t2, 0, t1, 0, F, {out, out, 1});
+                size_t v = std::max(lo, (size_t) 1);
+                computeNor(pairOf(t2), v, pairOf(t1), v, Sm, {v - 1, hi - 1, 1});
+                scratch.give(t5); scratch.give(t4); scratch.give(t3); scratch.give(t2); scratch.give(t1);
+            }
+            gateInit(Sm, {W - 1, W - 1, 1}, false);
+            if(out == 4) gateNot(F, 4, F, {3, 3, 1});
+
+        }
+        scratch.give(nsel); scratch.give(sel);
+
+        // R = (S + C) << 3 | b52 << 2 | b51 << 1 | sticky (in place of S)
+        scratch.give(addWide(W, Sm, C, -1, false, CARRY_ZERO, Sm, scratch));
+        scratch.give(C.high); scratch.give(C.low);
+        RegisterPair R = Sm;
+        copy(R, 0, R, {3, W + 2, 1}, scratch);
+        size_t T = scratch.take();
+        computeNot(F, 1, T, {1, 2, 1});
+        gateInit(R.low, {0, 2, 1}, true);
+        gateNot(T, 1, R.low, {1, 2, 1});
+        gateNot(F, 3, R.low, first);
+
+        // Normalize the product (in [1, 4)) by shifting left by one if its top bit (t) is clear
+        sel = scratch.take(); nsel = scratch.take();
+        broadcast(wordOf(R, M + 3), (M + 3) % CROSSBAR_N, nsel, sel, word, true);
+        shiftSelect(R, 0, M + 5, -1, sel, nsel, scratch);
+        scratch.give(nsel);
+
+        // The exponent minus one: (ex - 2^(E - 1)) + ey + t
+        size_t EX = scratch.take(), nEX = scratch.take(), EY = scratch.take(), nEY = scratch.take();
+        unbias(format, regX, X, nEX, T);
+        computeNot(nEX, 0, EX, frame);
+        gateInit(nEY, frame, true);
+        gateNot(regY.high, pE, nEY, {0, E - 1, 1});
+        computeNot(nEY, 0, EY, frame);
+        scratch.give(add({0, X, 1}, EX, nEX, EY, nEY, {false, sel, sel}, EX, scratch));
+        scratch.give(nEY); scratch.give(EY); scratch.give(nEX); scratch.give(sel);
+
+        // The flags: whether both operands are non-zero, and the XOR of the signs
+        reduceNor(regX, M, E, T, 1);
+        computeNor(T, 1, F, 0, F, {1, 1, 1});
+        computeXnor(regX.high, regY.high, T, {pS, pS, 1}, scratch);
+        computeNot(T, pS, F, {pS, pS, 1});
+
+        // Round and pack (the mantissa follows the hidden bit at M + 3, with the guard bit at 2)
+        size_t nR = scratch.take();
+        computeNot(R.low, 0, nR, word);
+        roundUp(R.low, nR, 2, T, F);
+        scratch.give(nR); scratch.give(T);
+        copy(R, 3, R, {0, M - 1, 1}, scratch);
+        roundPack(format, R, EX, X, F, pS, regZ, scratch);
+
+        scratch.give(EX); scratch.give(R.high); scratch.give(R.low); scratch.give(F);
+
+    }
+
+    void generateDivide(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ){
+
+        // The quotient of the significands has M + 3 bits (computed by non-restoring division into regZ), with the
+        // guard bit at 1 and the sticky bit at 0 after normalization
+        size_t M = format.mantissa, E = format.exponent, X = E + 2, W = M + 3;
+        checkWide(format, W);
+
+        Scratch scratch;
+        size_t pS = M + E - CROSSBAR_N;
+        RangeMask word(0, CROSSBAR_N - 1, 1), first(0, 0, 1), frame(0, X - 1, 1), all(0, W - 1, 1);
+
+        // The remainder (R, initially the dividend) and the divisor (D)
+        RegisterPair R = {scratch.take(), scratch.take()}, D = {scratch.take(), scratch.take()};
+        significand(format, regX, R, W, scratch);
+        significand(format, regY, D, W, scratch);
+
+        // Every iteration (but the first) shifts the remainder left, and subtracts the divisor if R is non-negative
+        // (or adds it otherwise). The bit of the quotient is whether the result is non-negative.
+        size_t m = scratch.take();
+        gateInit(m, word, false);
+        for(size_t i = W; i-- > 0;){
+            if(i != W - 1){
+                size_t nm = scratch.take();
+                broadcast(wordOf(R, W - 1), (W - 1) % CROSSBAR_N, m, nm, word, false);
+                scratch.give(nm);
+                copy(R, 0, R, {1, W - 1, 1}, scratch);
+                gateInit(R, first, false);
+            }
+            scratch.give(addWide(W, R, D, m, true, {false, m, m}, R, scratch));
+            gateInit(regZ, {i, i, 1}, true);
+            gateNot(R, W - 1, regZ, {i, i, 1});
+        }
+
+        // Whether the remainder (R, corrected by the divisor if negative) is non-zero (at partition 2 of F)
+        size_t nm = scratch.take();
+        broadcast(wordOf(R, W - 1), (W - 1) % CROSSBAR_N, m, nm, word, true);
+        select(D, 0, pairOf(m), 0, m, nm, D, all, scratch);
+        scratch.give(nm); scratch.give(m);
+        scratch.give(addWide(W, R, D, -1, false, CARRY_ZERO, R, scratch));
+        scratch.give(D.high); scratch.give(D.low);
+        size_t F = scratch.take(), T = scratch.take();
+        reduceNor(R, 0, W, T, 0);
+        computeNot(T, 0, F, {2, 2, 1});
+
+        // Normalize the quotient (in (1/2, 2)) by shifting left by one if its top bit (t) is clear, and include the
+        // remainder in the sticky bit (in place of R)
+        size_t sel = scratch.take(), nsel = scratch.take();
+        copy(regZ, 0, R, all, scratch);
+        broadcast(wordOf(R, W - 1), (W - 1) % CROSSBAR_N, nsel, sel, word, true);
+        shiftSelect(R, 0, W, -1, sel, nsel, scratch);
+        scratch.give(nsel);
+        computeNor(R.low, 0, F, 2, T, first);
+        computeNot(T, 0, R.low, first);
+
+        // The exponent minus one: ex + (bias - ey) + t - 2, where bias - ey is ~ey with its top bit flipped and
+        // sign-extended
+        size_t EX = scratch.take(), nEX = scratch.take(), Y = scratch.take(), nY = scratch.take();
+        gateInit(nEX, frame, true);
+        gateNot(regX.high, M - CROSSBAR_N, nEX, {0, E - 1, 1});
+        computeNot(nEX, 0, EX, frame);
+        unbias(format, regY, X, Y, T);
+        computeNot(Y, 0, nY, frame);
+        scratch.give(add({0, X, 1}, EX, nEX, Y, nY, {false, sel, sel}, EX, scratch));
+        scratch.give(sel);
+        computeNot(EX, 0, nEX, frame);
+        gateInit(Y, frame, true);
+        gateInit(Y, first, false);
+        computeNot(Y, 0, nY, frame);
+        scratch.give(add({0, X, 1}, EX, nEX, Y, nY, CARRY_ZERO, EX, scratch));
+        scratch.give(nY); scratch.give(Y); scratch.give(nEX);
+
+        // The flags: whether both operands are non-zero (a zero divisor results in zero), and the XOR of the signs
+        gateInit(F, {1, 1, 1}, true);
+        reduceNor(regX, M, E, T, 1);
+        gateNot(T, 1, F, {1, 1, 1});
+        reduceNor(regY, M, E, T, 1);
+        gateNot(T, 1, F, {1, 1, 1});
+        computeXnor(regX.high, regY.high, T, {pS, pS, 1}, scratch);
+        computeNot(T, pS, F, {pS, pS, 1});
+
+        // Round and pack (the mantissa follows the hidden bit at M + 2, with the guard bit at 1)
+        size_t nR = scratch.take();
+        computeNot(R.low, 0, nR, word);
+        roundUp(R.low, nR, 1, T, F);
+        scratch.give(nR); scratch.give(T);
+        copy(R, 2, R, {0, M - 1, 1}, scratch);
+        roundPack(format, R, EX, X, F, pS, regZ, scratch);
+
+        scratch.give(EX); scratch.give(F); scratch.give(R.high); scratch.give(R.low);
+
+    }
+
+    /**
+     * Copies the given wide register to regZ with its sign flipped (or cleared)
+     * @param format
+     * @param regX
+     * @param regZ
+     * @param flip
+     */
+    void replaceSign(FloatFormat format, RegisterPair regX, RegisterPair regZ, bool flip){
+        checkWide(format, 0);
+        Scratch scratch;
+        size_t S = format.mantissa + format.exponent;
+        copy(regX, 0, regZ, {0, S - 1, 1}, scratch);
+        gateInit(regZ, {S, S, 1}, flip);
+        if(flip) gateNot(regX, S, regZ, {S, S, 1});
+    }
+
+    void generateNegate(FloatFormat format, RegisterPair regX, RegisterPair regZ){
+        replaceSign(format, regX, regZ, true);
+    }
+
+    void generateAbsolute(FloatFormat format, RegisterPair regX, RegisterPair regZ){
+        replaceSign(format, regX, regZ, false);
+    }
+
+    void generateSign(FloatFormat format, RegisterPair regX, size_t regZ){
+        checkWide(format, 0);
+        generateSign(IntegerFormat{2 * CROSSBAR_N, 1, true}, regX, regZ);
+    }
+
+    void generateZero(FloatFormat format, RegisterPair regX, size_t regZ){
+        checkWide(format, 0);
+        generateZero(IntegerFormat{2 * CROSSBAR_N, 1, true}, regX, regZ);
+    }
+
+    void generateConvert(FloatFormat from, FloatFormat to, size_t regX, RegisterPair regZ){
+
+        size_t M1 = from.mantissa, E1 = from.exponent, S1 = M1 + E1;
+        size_t M2 = to.mantissa, E2 = to.exponent, S2 = M2 + E2;
+        checkFormat(from, 0);
+        checkWide(to, 0);
+        if(E2 < E1 || M2 < M1) throw std::runtime_error("Generator: unsupported floating-point conversion.");
+
+        Scratch scratch;
+        RangeMask word(0, CROSSBAR_N - 1, 1), exponent(M2, S2 - 1, 1);
+
+        // Zero exponents (zeros and subnormals) are flushed (nk), and infinities remain all-one (inf)
+        size_t nx = scratch.take(), T = scratch.take(), nk = scratch.take(), inf = scratch.take(), u = scratch.take();
+        computeNot(regX, 0, nx, {0, S1, 1});
+        reduceNor(regX, M1, E1, T, 0);
+        broadcast(T, 0, nk, u, word, false);
+        reduceNor(nx, M1, E1, T, 0);
+        broadcast(T, 0, inf, u, word, false);
+
+        // Widening is exact: the mantissa is extended with zeros, and the exponent is rebiased by repeating the
+        // complement of its top bit (e - bias1 + bias2)
+        gateInit(regZ, {0, S2, 1}, true);
+        gateInit(regZ, {0, M2 - M1 - 1, 1}, false);
+        gateNot(pairOf(nx), 0, regZ, {M2 - M1, M2 - 1, 1});
+        gateNot(pairOf(nx), M1, regZ, {M2, M2 + E1 - 2, 1});
+        for(size_t b = M2 + E1 - 1; b < S2 - 1; b++) gateNot(pairOf(regX), S1 - 1, regZ, {b, b, 1});
+        gateNot(pairOf(nx), S1 - 1, regZ, {S2 - 1, S2 - 1, 1});
+        gateNot(pairOf(nx), S1, regZ, {S2, S2, 1});
+        gateNot(pairOf(nk), 0, regZ, {0, S2, 1});
+
+        // Infinities are ORed into the exponent
+        computeNor(regZ, M2, pairOf(inf), M2, pairOf(u), exponent);
+        gateInit(regZ, exponent, true);
+        gateNot(pairOf(u), M2, regZ, exponent);
+
+        scratch.give(u); scratch.give(inf); scratch.give(nk); scratch.give(T); scratch.give(nx);
+
+    }
+
+    void generateConvert(FloatFormat from, FloatFormat to, RegisterPair regX, size_t regZ){
+
+        size_t M1 = from.mantissa, E1 = from.exponent;
+        size_t M2 = to.mantissa, E2 = to.exponent, X = E1 + 2;
+        checkWide(from, 0);
+        checkFormat(to, 0);
+        if(E2 > E1 || M2 > M1 || M1 - M2 >= CROSSBAR_N)
+            throw std::runtime_error("Generator: unsupported floating-point conversion.");
+
+        Scratch scratch;
+        RangeMask word(0, CROSSBAR_N - 1, 1), frame(0, X - 1, 1), first(0, 0, 1);
+        size_t pS = CROSSBAR_N - 1;
+
+        // The mantissa is rounded to the leading bits (P), and the exponent minus one is (e - 2^(E1 - 1)) + bias2
+        size_t P = scratch.take(), EX = scratch.take(), nEX = scratch.take(), C = scratch.take(), nC = scratch.take();
+        copy(regX, M1 - M2, pairOf(P), {0, M2 - 1, 1}, scratch);
+        unbias(from, regX, X, nEX, C);
+        computeNot(nEX, 0, EX, frame);
+        gateInit(C, frame, false);
+        gateInit(C, {0, E2 - 2, 1}, true);
+        computeNot(C, 0, nC, frame);
+        scratch.give(add({0, X, 1}, EX, nEX, C, nC, CARRY_ZERO, EX, scratch));
+        scratch.give(nC); scratch.give(C); scratch.give(nEX);
+
+        // The flags: whether the exponent is non-zero, and the sign
+        size_t F = scratch.take(), T = scratch.take();
+        reduceNor(regX, M1, E1, T, 1);
+        computeNot(T, 1, F, {1, 1, 1});
+        computeNot(regX.high, pS, T, {pS, pS, 1});
+        computeNot(T, pS, F, {pS, pS, 1});
+
+        // Round (the guard bit is the leading bit below the rounded mantissa) and pack
+        if(M1 > M2){
+            size_t nR = scratch.take();
+            computeNot(regX.low, 0, nR, word);
+            roundUp(regX.low, nR, M1 - M2 - 1, T, F);
+            scratch.give(nR);
+        }
+        else{
+            gateInit(F, first, true);
+        }
+        scratch.give(T);
+        roundPack(to, pairOf(P), EX, X, F, pS, pairOf(regZ), scratch);
+
+        scratch.give(F); scratch.give(EX); scratch.give(P);
+
+    }
+
+    /**
+     * AND-reduces the partitions [0, length) of the given register into its first partition by folding the upper half
+     * of the partitions onto the lower half, where t holds the complement of the folded partitions
+     * @param reg
+     * @param length
+     * @param t
+     */
+    void foldAnd(size_t reg, size_t length, size_t t){
+        for(; length > 1; length -= length / 2){
+            RangeMask half(0, length / 2 - 1, 1);
+            computeNot(reg, length - length / 2, t, half);
+            gateNot(t, 0, reg, half);
+        }
+    }
+
+    /**
+     * Computes whether the partitions [0, width) of the given values (registers or register pairs) are equal into
+     * the first partition of a scratch register
+     * @param width
+     * @param regX
+     * @param regY
+     * @param scratch
+     * @return the scratch register (the caller gives it back)
+     */
+    template <class R>
+    size_t equalBits(size_t width, R regX, R regY, Scratch& scratch){
+
+        // nR = ~(x ^ y) over all of the words, where x ^ y = u | v for u = ~(x | t), v = ~(y | t), and t = ~(x | y),
+        // and then AND-reduce the register into its first partition
+        size_t t = scratch.take(), nR = scratch.take(), u = scratch.take(), v = scratch.take();
+        gateInit(nR, {0, std::min(width, CROSSBAR_N) - 1, 1}, true);
+        for(size_t base = 0; base < width; base += CROSSBAR_N){
+            RangeMask word(0, std::min(width - base, CROSSBAR_N) - 1, 1);
+            size_t x = wordOf(regX, base), y = wordOf(regY, base);
+            computeNor(x, 0, y, 0, t, word);
+            computeNor(x, 0, t, 0, u, word);
+            computeNor(y, 0, t, 0, v, word);
+            gateNor(u, 0, v, 0, nR, word);
+        }
+        foldAnd(nR, std::min(width, CROSSBAR_N), t);
+        scratch.give(v); scratch.give(u); scratch.give(t);
+        return nR;
+
+    }
+
+    /**
+     * dst = src[pSrc], or its complement (through a scratch register, if dst may be src)
+     * @param src
+     * @param pSrc
+     * @param dst
+     * @param complement
+     * @param scratch
+     */
+    void copyBit(size_t src, size_t pSrc, RegisterBit dst, bool complement, Scratch& scratch){
+        RangeMask p(dst.partition, dst.partition, 1);
+        if(complement && (src != dst.reg || pSrc != dst.partition)){
+            computeNot(src, pSrc, dst.reg, p);
+            return;
+        }
+        size_t t = scratch.take();
+        computeNot(src, pSrc, t, p);
+        if(complement){
+            size_t u = scratch.take();
+            computeNot(t, dst.partition, u, p);
+            computeNot(u, dst.partition, dst.reg, p);
+            scratch.give(u);
+        }
+        else computeNot(t, dst.partition, dst.reg, p);
+        scratch.give(t);
+    }
+
+    void generateMaskInit(RegisterBit regZ, bool value){
+        gateInit(regZ.reg, {regZ.partition, regZ.partition, 1}, value);
+    }
+
+    void generateMaskCopy(RegisterBit regX, RegisterBit regZ){
+        Scratch scratch;
+        copyBit(regX.reg, regX.partition, regZ, false, scratch);
+    }
+
+    void generateMaskNot(RegisterBit regX, RegisterBit regZ){
+        Scratch scratch;
+        copyBit(regX.reg, regX.partition, regZ, true, scratch);
+    }
+
+    void generateMaskAnd(RegisterBit regX, RegisterBit regY, RegisterBit regZ){
+        Scratch scratch;
+        RangeMask p(regZ.partition, regZ.partition, 1);
+        size_t nx = scratch.take(), ny = scratch.take();
+        computeNot(regX.reg, regX.partition, nx, p);
+        computeNot(regY.reg, regY.partition, ny, p);
+        computeNor(nx, regZ.partition, ny, regZ.partition, regZ.reg, p);
+        scratch.give(ny); scratch.give(nx);
+    }
+
+    void generateMaskOr(RegisterBit regX, RegisterBit regY, RegisterBit regZ){
+        Scratch scratch;
+        RangeMask p(regZ.partition, regZ.partition, 1);
+        size_t t = scratch.take();
+        computeNor(regX.reg, regX.partition, regY.reg, regY.partition, t, p);
+        computeNot(t, regZ.partition, regZ.reg, p);
+        scratch.give(t);
+    }
+
+    void generateMaskXor(RegisterBit regX, RegisterBit regY, RegisterBit regZ){
+
+        Scratch scratch;
+        RangeMask p(regZ.partition, regZ.partition, 1);
+
+        // x ^ y = ~(~(x | y) | (x & y)), where x & y = ~(~x | ~y)
+        size_t nx = scratch.take(), ny = scratch.take(), a = scratch.take(), o = scratch.take();
+        computeNot(regX.reg, regX.partition, nx, p);
+        computeNot(regY.reg, regY.partition, ny, p);
+        computeNor(nx, regZ.partition, ny, regZ.partition, a, p);
+        computeNor(regX.reg, regX.partition, regY.reg, regY.partition, o, p);
+        computeNor(o, regZ.partition, a, regZ.partition, regZ.reg, p);
+        scratch.give(o); scratch.give(a); scratch.give(ny); scratch.give(nx);
+
+    }
+
+    void generateMaskExpand(RegisterBit regX, size_t regZ){
+        Scratch scratch;
+        size_t t = scratch.take();
+        broadcast(regX.reg, regX.partition, regZ, t, {0, CROSSBAR_N - 1, 1}, false);
+        scratch.give(t);
+    }
+
+    /**
+     * Computes the given predicate of a value of the given width (a register, or a register pair) into a single
+     * partition, where the sign is bit width - 1 (if signed), and zero requires the low zeroWidth bits to be zero (e.g.,
+     * all but the sign of floating-point values)
+     * @param width
+     * @param zeroWidth
+     * @param isSigned
+     * @param predicate
+     * @param regX
+     * @param regZ
+     */
+    template <class R>
+    void predicate(size_t width, size_t zeroWidth, bool isSigned, Predicate predicate, R regX, RegisterBit regZ){
+
+        Scratch scratch;
+        RangeMask p(regZ.partition, regZ.partition, 1);
+        size_t sign = wordOf(regX, width - 1), pSign = (width - 1) % CROSSBAR_N;
+
+        if(predicate == Predicate::NEGATIVE && (!isSigned || zeroWidth == width)){
+            if(isSigned) copyBit(sign, pSign, regZ, false, scratch);
+            else gateInit(regZ.reg, p, false);
+            return;
+        }
+
+        // The mask is a partition of a register that is not shared with the value, and thus the reduction is performed
+        // in place
+        if(predicate == Predicate::ZERO || !isSigned){
+            reduceNor(regX, 0, zeroWidth, regZ.reg, regZ.partition);
+            return;
+        }
+
+        // x <= 0 iff ~(~(zero | sign)), and x < 0 iff ~(zero | ~sign) if zero ignores the sign (as -0 is not negative)
+        size_t t = scratch.take(), u = scratch.take();
+        reduceNor(regX, 0, zeroWidth, t, regZ.partition);
+        if(predicate == Predicate::NEGATIVE){
+            computeNot(sign, pSign, u, p);
+            computeNor(t, regZ.partition, u, regZ.partition, regZ.reg, p);
+        }
+        else{
+            computeNor(t, regZ.partition, sign, pSign, u, p);
+            computeNot(u, regZ.partition, regZ.reg, p);
+        }
+        scratch.give(u); scratch.give(t);
+
+    }
+
+    void generatePredicate(IntegerFormat format, Predicate predicate, size_t regX, RegisterBit regZ){
+        if(format.lanes != 1) throw std::runtime_error("Generator: predicates require a single lane.");
+        pim::predicate(format.width, format.width, format.isSigned, predicate, regX, regZ);
+    }
+
+    void generatePredicate(FloatFormat format, Predicate predicate, size_t regX, RegisterBit regZ){
+        size_t width = format.mantissa + format.exponent + 1;
+        checkFormat(format, width);
+        pim::predicate(width, width - 1, true, predicate, regX, regZ);
+    }
+
+    void generatePredicate(IntegerFormat format, Predicate predicate, RegisterPair regX, RegisterBit regZ){
+        checkWide(format);
+        pim::predicate(2 * CROSSBAR_N, 2 * CROSSBAR_N, format.isSigned, predicate, regX, regZ);
+    }
+
+    void generatePredicate(FloatFormat format, Predicate predicate, RegisterPair regX, RegisterBit regZ){
+        checkWide(format, 0);
+        pim::predicate(2 * CROSSBAR_N, 2 * CROSSBAR_N - 1, true, predicate, regX, regZ);
+    }
+
+    void generateLess(IntegerFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate){
+        Scratch scratch;
+        size_t lt = less(format, regX, regY, scratch);
+        copyBit(lt, format.width - 1, regZ, negate, scratch);
+        scratch.give(lt);
+    }
+
+    /**
+     * Computes whether the first register pair is less than the second into partition (width - 1) % CROSSBAR_N of a
+     * scratch register, from the borrow of their subtraction over the partitions [0, width) (where the words of the
+     * difference are discarded), and for signed operands as for the registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param scratch
+     * @return the scratch register (the caller gives it back)
+     */
+    size_t less(IntegerFormat format, RegisterPair regX, RegisterPair regY, Scratch& scratch){
+
+        size_t top = (format.width - 1) % CROSSBAR_N;
+        RangeMask last(top, top, 1);
+        size_t d = scratch.take();
+        size_t nG = addWide(format.width, regX, regY, -1, true, CARRY_ONE, pairOf(d), scratch);
+
+        // lt = nG ^ x ^ y at the sign bit
+        if(format.isSigned){
+            size_t t = scratch.take();
+            computeXnor(wordOf(regX, format.width - 1), wordOf(regY, format.width - 1), d, last, scratch);
+            computeXnor(nG, d, t, last, scratch);
+            std::swap(nG, t);
+            scratch.give(t);
+        }
+        scratch.give(d);
+        return nG;
+
+    }
+
+    /**
+     * Computes whether the partitions [0, width) of both of the given values are zero into the first partition of a
+     * scratch register
+     * @param width
+     * @param regX
+     * @param regY
+     * @param scratch
+     * @return the scratch register (the caller gives it back)
+     */
+    template <class R>
+    size_t bothZero(size_t width, R regX, R regY, Scratch& scratch){
+        size_t t = scratch.take(), nR = scratch.take();
+        gateInit(nR, {0, std::min(width, CROSSBAR_N) - 1, 1}, true);
+        for(size_t base = 0; base < width; base += CROSSBAR_N)
+            gateNor(wordOf(regX, base), 0, wordOf(regY, base), 0, nR, {0, std::min(width - base, CROSSBAR_N) - 1, 1});
+        foldAnd(nR, std::min(width, CROSSBAR_N), t);
+        scratch.give(t);
+        return nR;
+    }
+
+    /**
+     * Computes whether the first floating-point value of the given width (a register, or a register pair) is less than
+     * the second into a mask (or greater than or equal, if negated), from the signs and from the borrow and the equality
+     * of the magnitudes, without their difference. Zeros are equal regardless of their signs, while the result is
+     * undefined for NaN operands (as the negation is not ordered).
+     * @param width
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    template <class R>
+    void floatLess(size_t width, R regX, R regY, RegisterBit regZ, bool negate){
+
+        Scratch scratch;
+        size_t m = width - 1, q = regZ.partition, s = m % CROSSBAR_N, pLt = (m - 1) % CROSSBAR_N;
+        size_t sx = wordOf(regX, m), sy = wordOf(regY, m);
+        RangeMask p(q, q, 1);
+
+        // The comparisons of the magnitudes
+        size_t lt = less(IntegerFormat{m, 1, false}, regX, regY, scratch);
+        size_t eq = equalBits(m, regX, regY, scratch), zero = bothZero(m, regX, regY, scratch);
+
+        size_t nsx = scratch.take(), nsy = scratch.take(), nlt = scratch.take();
+        computeNot(sx, s, nsx, p);
+        computeNot(sy, s, nsy, p);
+        computeNot(lt, pLt, nlt, p);
+
+        // x < y iff a = ~sx & ~sy & lt (both positive), b = sx & sy & ~lt & ~eq (both negative), or c = sx & ~sy & ~zero
+        size_t a = scratch.take(), b = scratch.take(), c = scratch.take();
+        computeNor(sx, s, sy, s, a, p);
+        gateNot(nlt, q, a, p);
+        computeNor(nsx, q, nsy, q, b, p);
+        gateNor(lt, pLt, eq, 0, b, p);
+        computeNor(nsx, q, sy, s, c, p);
+        gateNot(zero, 0, c, p);
+
+        // ~(a | b | c), directly into the mask if negated (as the operands were read)
+        size_t n = negate ? regZ.reg : scratch.take();
+        computeNor(a, q, b, q, n, p);
+        gateNot(c, q, n, p);
+        if(!negate){
+            computeNot(n, q, regZ.reg, p);
+            scratch.give(n);
+        }
+
+        scratch.give(c); scratch.give(b); scratch.give(a); scratch.give(nlt); scratch.give(nsy); scratch.give(nsx);
+        scratch.give(zero); scratch.give(eq); scratch.give(lt);
+
+    }
+
+    /**
+     * Computes whether the given floating-point values of the given width are equal into a mask (or not equal, if
+     * negated): either their bits are equal, or both are zero
+     * @param width
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    template <class R>
+    void floatEqual(size_t width, R regX, R regY, RegisterBit regZ, bool negate){
+
+        Scratch scratch;
+        size_t q = regZ.partition;
+        RangeMask p(q, q, 1);
+        size_t eq = equalBits(width, regX, regY, scratch), zero = bothZero(width - 1, regX, regY, scratch);
+
+        size_t n = negate ? regZ.reg : scratch.take();
+        computeNor(eq, 0, zero, 0, n, p);
+        if(!negate){
+            computeNot(n, q, regZ.reg, p);
+            scratch.give(n);
+        }
+        scratch.give(zero); scratch.give(eq);
+
+    }
+
+    void generateLess(FloatFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate){
+        size_t width = format.mantissa + format.exponent + 1;
+        checkFormat(format, width);
+        floatLess(width, regX, regY, regZ, negate);
+    }
+
+    void generateLess(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate){
+        checkWide(format);
+        Scratch scratch;
+        size_t lt = less(format, regX, regY, scratch);
+        copyBit(lt, CROSSBAR_N - 1, regZ, negate, scratch);
+        scratch.give(lt);
+    }
+
+    void generateLess(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate){
+        checkWide(format, 0);
+        floatLess(2 * CROSSBAR_N, regX, regY, regZ, negate);
+    }
+
+    void generateEqual(IntegerFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate){
+        if(format.lanes != 1) throw std::runtime_error("Generator: comparison requires a single lane.");
+        Scratch scratch;
+        size_t eq = equalBits(format.width, regX, regY, scratch);
+        copyBit(eq, 0, regZ, negate, scratch);
+        scratch.give(eq);
+    }
+
+    void generateEqual(FloatFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate){
+        size_t width = format.mantissa + format.exponent + 1;
+        checkFormat(format, width);
+        floatEqual(width, regX, regY, regZ, negate);
+    }
+
+    void generateEqual(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate){
+        checkWide(format);
+        Scratch scratch;
+        size_t eq = equalBits(format.width, regX, regY, scratch);
+        copyBit(eq, 0, regZ, negate, scratch);
+        scratch.give(eq);
+    }
+
+    void generateEqual(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate){
+        checkWide(format, 0);
+        floatEqual(2 * CROSSBAR_N, regX, regY, regZ, negate);
+    }
+
+    /**
+     * The elements [first, last] of every crossbar of a register whose elements span consecutive rows (see
+     * pim::RegisterRows), of the given number of words
+     */
+    struct Elements {
+
+        size_t first, last, words;
+
+        /** All rows of the elements */
+        RangeMask all() const { return {first * words, last * words + words - 1, 1}; }
+
+        /** Row k of every element (the step of a single element is arbitrary, as it may exceed the encoding of the
+         * micro-operations) */
+        RangeMask word(size_t k) const { return {first * words + k, last * words + k, last > first ? words : 1}; }
+
+        /** The rows of the even words (q = 0) or of the odd words (q = 1) of every element */
+        RangeMask parity(size_t q) const { return {first * words + q, last * words + words - 2 + q, 2}; }
+
+        /** Row k of element i */
+        size_t row(size_t i, size_t k) const { return i * words + k; }
+
+    };
+
+    /**
+     * Returns the elements of the given big integers in the given rows (the current row mask, which spans whole
+     * elements), and checks that their format is supported
+     * @param format
+     * @param reg
+     * @param rows
+     * @return
+     */
+    Elements elementsOf(IntegerFormat format, RegisterRows reg, RangeMask rows){
+        size_t words = reg.words;
+        if(format.lanes != 1 || format.isSigned || format.width != words * CROSSBAR_N || words < 2 ||
+           (words & (words - 1)) != 0 || words > CROSSBAR_HEIGHT)
+            throw std::runtime_error("Generator: big integers require a single unsigned lane of a power of two words.");
+        if(rows.step != 1 || rows.start % words != 0 || rows.stop % words != words - 1)
+            throw std::runtime_error("Generator: the rows of big integers must span whole elements.");
+        return {rows.start / words, rows.stop / words, words};
+    }
+
+    /**
+     * Sets the row mask of the following micro-operations (as the driver does before a routine)
+     * @param rows
+     */
+    void setRows(RangeMask rows){
+        perform((((((((rows.step << LOG_CROSSBAR_HEIGHT) | rows.stop) << LOG_CROSSBAR_HEIGHT) | rows.start) << 1) | 1)
+                << 2) | MicrooperationType::MASK);
+    }
+
+    /**
+     * Performs a vertical logic micro-operation from row in to row out of the given register, on all of its partitions
+     * in every active crossbar (regardless of the row mask), where NOT is out = out & ~in
+     * @param gate
+     * @param reg
+     * @param in
+     * @param out
+     */
+    void vertical(GateType gate, size_t reg, size_t in, size_t out){
+        otype operation = reg;
+        operation = (operation << LOG_CROSSBAR_HEIGHT) | out;
+        operation = (operation << LOG_CROSSBAR_HEIGHT) | in;
+        perform((((((operation << 2) | gate) << 1) | 1) << 2) | MicrooperationType::LOGIC);
+    }
+
+    /**
+     * Adds the given big integers (z = a + b, or a - b if subtract) by per-word routines: the words are added per row
+     * without their carries, the carries are chained across the rows of every element through an explicit carry
+     * register, and then they are added to the words per row. The carry into word k + 1 is computed at row k from the
+     * generate and the propagate of word k and the carry into it, and is moved into row k + 1 by a vertical NOT onto a
+     * row of ones. As the vertical micro-operations move entire rows, the carries alternate between partitions 0 and 1
+     * of the carry register. z may be one of the operands, or -1 for the carry out of every element only. Leaves the
+     * row mask at all rows of the elements.
+     * @param e
+     * @param a
+     * @param b
+     * @param subtract
+     * @param z
+     * @param scratch
+     * @return if z is -1, a scratch register holding the complement of the carry out of every element at partition 0 of
+     * its last row (the caller gives it back), and otherwise -1
+     */
+    size_t addRows(Elements e, size_t a, size_t b, bool subtract, size_t z, Scratch& scratch){
+
+        RangeMask word(0, CROSSBAR_N - 1, 1), first(0, 0, 1);
+        size_t W = e.words;
+
+        // The sums of the words without their carries (S), where the second operand is complemented for subtraction
+        size_t S = scratch.take(), nS = scratch.take(), na = scratch.take(), nb = scratch.take();
+        computeNot(a, 0, na, word);
+        computeNot(b, 0, nb, word);
+        size_t nG = subtract ? add({0, CROSSBAR_N, 1}, a, na, nb, b, CARRY_ZERO, S, scratch)
+                             : add({0, CROSSBAR_N, 1}, a, na, b, nb, CARRY_ZERO, S, scratch);
+        scratch.give(nb); scratch.give(na);
+
+        // The generate (G) and the complement of the propagate (nP) of every word at partition 0, where a word
+        // propagates the carry into it if its sum is all-one
+        size_t G = scratch.take(), nP = scratch.take();
+        computeNot(nG, CROSSBAR_N - 1, G, first);
+        computeNot(S, 0, nS, word);
+        computeNot(nS, 0, nG, word);
+        foldAnd(nG, CROSSBAR_N, nP);
+        computeNot(nG, 0, nP, first);
+
+        // The carry register (C) holds ones onto which the carries are moved, and the carry into word 0 (one for
+        // subtraction)
+        size_t C = scratch.take(), nc = nG, u = scratch.take();
+        gateInit(C, {0, 1, 1}, true);
+        setRows(e.word(0));
+        gateInit(C, first, subtract);
+
+        // ~c[k + 1] = ~(G | P & c[k]) into the other partition of row k, where P & c[k] = ~(nP | ~c[k]), and then
+        // c[k + 1] into row k + 1
+        for(size_t k = 0; k < (z == -1 ? W : W - 1); k++){
+            size_t q = k % 2;
+            if(k > 0) setRows(e.word(k));
+            computeNot(C, q, nc, first);
+            computeNor(nP, 0, nc, 0, u, first);
+            computeNor(G, 0, u, 0, C, {1 - q, 1 - q, 1});
+            if(k + 1 < W){
+                for(size_t i = e.first; i <= e.last; i++) vertical(GateType::NOT, C, e.row(i, k), e.row(i, k + 1));
+            }
+        }
+
+        if(z == -1){
+            setRows(e.all());
+            scratch.give(u); scratch.give(nP); scratch.give(G); scratch.give(nG); scratch.give(nS); scratch.give(S);
+            return C;
+        }
+
+        // z = S + c, where the carry into every word is given by its complement at partition 0 (nc), and the second
+        // operand is zero (u, and its complement in G)
+        setRows(e.parity(0));
+        computeNot(C, 0, nc, first);
+        setRows(e.parity(1));
+        computeNot(C, 1, nc, first);
+        setRows(e.all());
+        gateInit(u, word, false);
+        gateInit(G, word, true);
+        scratch.give(add({0, CROSSBAR_N, 1}, S, nS, u, G, {false, nc, nc}, z, scratch));
+
+        scratch.give(u); scratch.give(C); scratch.give(nP); scratch.give(G); scratch.give(nc); scratch.give(nS);
+        scratch.give(S);
+        return -1;
+
+    }
+
+    /**
+     * Broadcasts word j of every element of src to all rows of the element in dst, by vertical NOTs of the complement
+     * of the word onto the other rows (of ones), after which row j is restored, where t is a temporary register. Leaves
+     * the row mask at all rows of the elements.
+     * @param e
+     * @param src
+     * @param j
+     * @param dst
+     * @param t
+     */
+    void broadcastWord(Elements e, size_t src, size_t j, size_t dst, size_t t){
+        RangeMask word(0, CROSSBAR_N - 1, 1);
+        gateInit(dst, word, true);
+        setRows(e.word(j));
+        computeNot(src, 0, t, word);
+        gateNot(src, 0, dst, word);
+        for(size_t i = e.first; i <= e.last; i++){
+            for(size_t k = 0; k < e.words; k++){
+                if(k != j) vertical(GateType::NOT, dst, e.row(i, j), e.row(i, k));
+            }
+        }
+        gateInit(dst, word, true);
+        gateNot(t, 0, dst, word);
+        setRows(e.all());
+    }
+
+    /**
+     * Shifts every element of the given register by a word in place (every word into the following row, where the
+     * last word leaves and the first word is zero), by vertical micro-operations from the last row down, which leave
+     * the complement of the shifted element. Leaves the row mask at all rows of the elements.
+     * @param e
+     * @param reg
+     */
+    void shiftWords(Elements e, size_t reg){
+        for(size_t i = e.first; i <= e.last; i++){
+            for(size_t k = e.words - 1; k > 0; k--){
+                vertical(GateType::INIT1, reg, e.row(i, k), e.row(i, k));
+                vertical(GateType::NOT, reg, e.row(i, k - 1), e.row(i, k));
+            }
+        }
+        setRows(e.word(0));
+        gateInit(reg, {0, CROSSBAR_N - 1, 1}, true);
+        setRows(e.all());
+    }
+
+    void generateAdd(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask rows){
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+        addRows(e, regX.reg, regY.reg, false, regZ.reg, scratch);
+    }
+
+    void generateSubtract(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask rows){
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+        addRows(e, regX.reg, regY.reg, true, regZ.reg, scratch);
+    }
+
+    void generateMultiply(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask rows){
+
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+        RangeMask word(0, CROSSBAR_N - 1, 1);
+        size_t X = regX.reg, Z = regZ.reg;
+
+        // Horner's rule over the words of y (the last first): z = ((z + hi) << 32) + lo, where hi and lo are the
+        // halves of the products of every word of x by word j of y (broadcast to the rows of the element, in Y), and the
+        // shift moves every word of z into the following row
+        for(size_t j = e.words; j-- > 0;){
+
+            size_t Y = scratch.take(), t = scratch.take();
+            broadcastWord(e, regY.reg, j, Y, t);
+
+            if(j == e.words - 1) multiplyHigh(CROSSBAR_N, X, Y, Z, scratch);
+            else{
+                multiplyHigh(CROSSBAR_N, X, Y, t, scratch);
+                addRows(e, Z, t, false, Z, scratch);
+            }
+            shiftWords(e, Z);
+
+            // z = ~Z + lo (in t)
+            multiply({0, CROSSBAR_N, 1}, CROSSBAR_N, X, Y, t, scratch);
+            scratch.give(Y);
+            size_t s = scratch.take();
+            computeNot(Z, 0, s, word);
+            addRows(e, s, t, false, Z, scratch);
+            scratch.give(s); scratch.give(t);
+
+        }
+
+    }
+
+    /**
+     * AND-reduces partition 0 of the rows of every element of the given register into a scratch register at partition
+     * 0 of the first row of the element, by vertical NOTs of the complements of the following rows onto the first row.
+     * Leaves the row mask at the first rows of the elements.
+     * @param e
+     * @param R
+     * @param scratch
+     * @return the scratch register (the caller gives it back)
+     */
+    size_t andRows(Elements e, size_t R, Scratch& scratch){
+        RangeMask first(0, 0, 1);
+        size_t M = scratch.take(), t = scratch.take();
+        computeNot(R, 0, M, first);
+        setRows(e.word(0));
+        computeNot(R, 0, t, first);
+        gateInit(M, first, true);
+        gateNot(t, 0, M, first);
+        for(size_t i = e.first; i <= e.last; i++){
+            for(size_t k = 1; k < e.words; k++) vertical(GateType::NOT, M, e.row(i, k), e.row(i, 0));
+        }
+        scratch.give(t);
+        return M;
+    }
+
+    void generateLess(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate,
+                      RangeMask rows){
+
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+
+        // The borrow of x - y (the complement of the carry out of x + ~y + 1), whose complement is moved from the last
+        // row of every element onto its first row
+        size_t C = addRows(e, regX.reg, regY.reg, true, -1, scratch);
+        for(size_t i = e.first; i <= e.last; i++){
+            vertical(GateType::INIT1, C, e.row(i, 0), e.row(i, 0));
+            vertical(GateType::NOT, C, e.row(i, e.words - 1), e.row(i, 0));
+        }
+        setRows(e.word(0));
+        copyBit(C, 0, regZ, !negate, scratch);
+        setRows(e.all());
+        scratch.give(C);
+
+    }
+
+    void generateEqual(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate,
+                       RangeMask rows){
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+        size_t eq = equalBits(CROSSBAR_N, regX.reg, regY.reg, scratch), M = andRows(e, eq, scratch);
+        copyBit(M, 0, regZ, negate, scratch);
+        setRows(e.all());
+        scratch.give(M); scratch.give(eq);
+    }
+
+    void generateZero(IntegerFormat format, RegisterRows regX, RegisterBit regZ, RangeMask rows){
+        Elements e = elementsOf(format, regX, rows);
+        Scratch scratch;
+        size_t zero = bothZero(CROSSBAR_N, regX.reg, regX.reg, scratch), M = andRows(e, zero, scratch);
+        copyBit(M, 0, regZ, false, scratch);
+        setRows(e.all());
+        scratch.give(M); scratch.give(zero);
+    }
+
+}
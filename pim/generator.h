@@ -0,0 +1,737 @@
+#ifndef CUDAPIM_GENERATOR_H
+#define CUDAPIM_GENERATOR_H
+
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * The generator emits the micro-operations of routines that are parameterized by their element format (e.g., the
+     * width), rather than hard-coded as the int and float routines of the driver. The routines use the scratch
+     * registers of the driver routines (18 to 31), and are performed with the current masks.
+     */
+
+    /**
+     * The layout of integer elements within a register: lanes of width bits (partitions) each, where lane k occupies
+     * partitions [k * width, (k + 1) * width). Elements of a single lane narrower than the register are stored extended
+     * to the full register (sign-extended if signed, and zero-extended otherwise), as their conversion to int. The
+     * routines only read the bits of the lanes, and produce extended results.
+     */
+    struct IntegerFormat {
+
+        /** The number of bits of every lane */
+        size_t width;
+
+        /** The number of lanes in every register */
+        size_t lanes;
+
+        /** Whether the lanes are signed (two's complement) */
+        bool isSigned;
+
+    };
+
+    /**
+     * Generates addition of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateAdd(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates subtraction of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateSubtract(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates negation of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateNegate(IntegerFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates absolute value of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateAbsolute(IntegerFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates multiplication of the given registers (the low bits of the product)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiply(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates division of the given registers (rounded towards zero). Requires a single lane, of at most half of the
+     * register if signed.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateDivide(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates modulo division of the given registers (with the sign of the dividend). Requires a single lane, of at
+     * most half of the register if signed.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateModulo(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates the sign of the given register (all-one if negative, and zero otherwise) in every lane
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateSign(IntegerFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates whether the given register is zero (all-one if zero, and zero otherwise) in every lane. Several lanes
+     * require a power-of-two width.
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateZero(IntegerFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates whether the first register is less than the second (all-one if less, and zero otherwise, as the sign),
+     * from the borrow of their subtraction (which never overflows). Requires a single lane.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateLess(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates the high half of the (double-width) product of the given registers. Requires a single unsigned lane.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiplyHigh(IntegerFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * The layout of signed fixed-point elements within a register: integer + fraction bits (including the sign) at
+     * [0, integer + fraction), whose value is the two's complement integer divided by 2^fraction, sign-extended to the
+     * full register. The routines saturate the results that overflow to the extreme values, and round the products
+     * towards negative infinity. Requires twice the width to fit the register (for the exact products).
+     */
+    struct FixedFormat {
+
+        /** The number of bits of the integer part (including the sign) */
+        size_t integer;
+
+        /** The number of bits of the fractional part */
+        size_t fraction;
+
+    };
+
+    /**
+     * Generates saturating fixed-point addition of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateAdd(FixedFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates saturating fixed-point subtraction of the given registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateSubtract(FixedFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates saturating fixed-point negation of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateNegate(FixedFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates saturating fixed-point absolute value of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateAbsolute(FixedFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates saturating fixed-point multiplication of the given registers (the exact product shifted right by the
+     * fraction)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiply(FixedFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates the sign of the given register (all-one if negative, and zero otherwise)
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateSign(FixedFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates whether the given register is zero (all-one if zero, and zero otherwise)
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateZero(FixedFormat format, size_t regX, size_t regZ);
+
+    /**
+     * The layout of floating-point elements within a register: the mantissa at [0, mantissa), the (biased) exponent
+     * at [mantissa, mantissa + exponent), and the sign above them, where the remaining partitions are zero. The
+     * routines round to nearest (ties to even) and flush subnormal inputs and results to (positive) zero, while results
+     * that overflow become infinity. Infinite and NaN inputs are not supported (except by widening conversions).
+     */
+    struct FloatFormat {
+
+        /** The number of bits of the exponent */
+        size_t exponent;
+
+        /** The number of bits of the mantissa (excluding the hidden bit) */
+        size_t mantissa;
+
+    };
+
+    /**
+     * Generates floating-point addition of the given registers. Requires the mantissa and five additional bits to fit
+     * the register.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateAdd(FloatFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates floating-point subtraction of the given registers. Requires the mantissa and five additional bits to
+     * fit the register.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateSubtract(FloatFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates floating-point multiplication of the given registers. Requires the product of the significands
+     * (2 * mantissa + 2 bits) to fit the register.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiply(FloatFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates floating-point division of the given registers (a zero divisor results in zero). Requires the shifted
+     * dividend (2 * mantissa + 3 bits) to fit the register.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateDivide(FloatFormat format, size_t regX, size_t regY, size_t regZ);
+
+    /**
+     * Generates floating-point negation of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateNegate(FloatFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates floating-point absolute value of the given register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateAbsolute(FloatFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates the sign of the given floating-point register (all-one if negative, and zero otherwise)
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateSign(FloatFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates whether the given floating-point register is (positive) zero (all-one if zero, and zero otherwise)
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateZero(FloatFormat format, size_t regX, size_t regZ);
+
+    /**
+     * Generates the conversion of the given register between floating-point formats. Widening conversions (of both the
+     * exponent and the mantissa) are exact, while other conversions round the mantissa and require it not to widen.
+     * @param from
+     * @param to
+     * @param regX
+     * @param regZ
+     */
+    void generateConvert(FloatFormat from, FloatFormat to, size_t regX, size_t regZ);
+
+    /**
+     * Elements wider than a word (e.g., int64_t and double) are stored in register pairs, as wide values whose
+     * partitions [0, CROSSBAR_N) are those of the low register, and whose following partitions are those of the high
+     * register. The wide routines support integers of a single lane of both registers, and floating-point formats whose
+     * mantissa fills the low register (e.g., double) with the semantics of the single-register floating-point routines.
+     * The result of a wide routine may not overlap its operands (as it is used for temporaries).
+     */
+
+    /**
+     * Generates addition of the given wide registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateAdd(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates subtraction of the given wide registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateSubtract(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates negation of the given wide register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateNegate(IntegerFormat format, RegisterPair regX, RegisterPair regZ);
+
+    /**
+     * Generates absolute value of the given wide register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateAbsolute(IntegerFormat format, RegisterPair regX, RegisterPair regZ);
+
+    /**
+     * Generates multiplication of the given wide registers (the low bits of the product)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiply(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates division of the given wide registers (rounded towards zero). Requires a signed format.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateDivide(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates modulo division of the given wide registers (with the sign of the dividend). Requires a signed format.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateModulo(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates the sign of the given wide register (all-one if negative, and zero otherwise) into a single register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateSign(IntegerFormat format, RegisterPair regX, size_t regZ);
+
+    /**
+     * Generates whether the given wide register is zero (all-one if zero, and zero otherwise) into a single register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateZero(IntegerFormat format, RegisterPair regX, size_t regZ);
+
+    /**
+     * Generates floating-point addition of the given wide registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateAdd(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates floating-point subtraction of the given wide registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateSubtract(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates floating-point multiplication of the given wide registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMultiply(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates floating-point division of the given wide registers (a zero divisor results in zero)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateDivide(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterPair regZ);
+
+    /**
+     * Generates floating-point negation of the given wide register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateNegate(FloatFormat format, RegisterPair regX, RegisterPair regZ);
+
+    /**
+     * Generates floating-point absolute value of the given wide register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateAbsolute(FloatFormat format, RegisterPair regX, RegisterPair regZ);
+
+    /**
+     * Generates the sign of the given wide floating-point register into a single register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateSign(FloatFormat format, RegisterPair regX, size_t regZ);
+
+    /**
+     * Generates whether the given wide floating-point register is (positive) zero into a single register
+     * @param format
+     * @param regX
+     * @param regZ
+     */
+    void generateZero(FloatFormat format, RegisterPair regX, size_t regZ);
+
+    /**
+     * Generates the (exact) widening conversion of the given register to a wide floating-point format
+     * @param from
+     * @param to
+     * @param regX
+     * @param regZ
+     */
+    void generateConvert(FloatFormat from, FloatFormat to, size_t regX, RegisterPair regZ);
+
+    /**
+     * Generates the conversion of the given wide register to a floating-point format of a single register, which
+     * rounds the mantissa
+     * @param from
+     * @param to
+     * @param regX
+     * @param regZ
+     */
+    void generateConvert(FloatFormat from, FloatFormat to, RegisterPair regX, size_t regZ);
+
+    /**
+     * Big unsigned integers (e.g., pim::uint_t<N>) span consecutive rows of a register (pim::RegisterRows), a word per
+     * row (the width of the format is that of the element). Their routines are given the current row mask (which spans
+     * whole elements, and is restored by the routines), as they are performed per word on all rows of the elements and
+     * chain the carries across the rows of every element through an explicit carry register, by vertical
+     * micro-operations (a row per element for every word).
+     */
+
+    /**
+     * Generates addition of the given big integers (modulo 2^width), from the sums of the words and their carries
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param rows
+     */
+    void generateAdd(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ, RangeMask rows);
+
+    /**
+     * Generates subtraction of the given big integers (modulo 2^width), as the addition of the complement and one
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param rows
+     */
+    void generateSubtract(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ,
+                          RangeMask rows);
+
+    /**
+     * Generates multiplication of the given big integers (the low width bits of the product) by Horner's rule over the
+     * words of y, from the products of the words of x by every word of y. z may not be one of the operands.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param rows
+     */
+    void generateMultiply(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterRows regZ,
+                          RangeMask rows);
+
+    /**
+     * The masks (see pim/mask.h) are single partitions of registers (pim::RegisterBit), whose routines only write the
+     * partition of the output (which may be one of the inputs), as the other partitions store other masks.
+     */
+
+    /**
+     * Generates the initialization of the given mask
+     * @param regZ
+     * @param value
+     */
+    void generateMaskInit(RegisterBit regZ, bool value);
+
+    /**
+     * Generates copy of the given mask
+     * @param regX
+     * @param regZ
+     */
+    void generateMaskCopy(RegisterBit regX, RegisterBit regZ);
+
+    /**
+     * Generates NOT of the given mask
+     * @param regX
+     * @param regZ
+     */
+    void generateMaskNot(RegisterBit regX, RegisterBit regZ);
+
+    /**
+     * Generates AND of the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMaskAnd(RegisterBit regX, RegisterBit regY, RegisterBit regZ);
+
+    /**
+     * Generates OR of the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMaskOr(RegisterBit regX, RegisterBit regY, RegisterBit regZ);
+
+    /**
+     * Generates XOR of the given masks
+     * @param regX
+     * @param regY
+     * @param regZ
+     */
+    void generateMaskXor(RegisterBit regX, RegisterBit regY, RegisterBit regZ);
+
+    /**
+     * Generates the expansion of the given mask to a register (all-one if set, and zero otherwise, as the sign)
+     * @param regX
+     * @param regZ
+     */
+    void generateMaskExpand(RegisterBit regX, size_t regZ);
+
+    /**
+     * Generates the given predicate of the given register (e.g., of the difference of a comparison) into a mask.
+     * Requires a single lane.
+     * @param format
+     * @param predicate
+     * @param regX
+     * @param regZ
+     */
+    void generatePredicate(IntegerFormat format, Predicate predicate, size_t regX, RegisterBit regZ);
+
+    /**
+     * Generates the given predicate of the given register into a mask, where zero ignores the sign (as -0 is zero)
+     * @param format
+     * @param predicate
+     * @param regX
+     * @param regZ
+     */
+    void generatePredicate(FloatFormat format, Predicate predicate, size_t regX, RegisterBit regZ);
+
+    /**
+     * Generates the given predicate of the given register pair into a mask
+     * @param format
+     * @param predicate
+     * @param regX
+     * @param regZ
+     */
+    void generatePredicate(IntegerFormat format, Predicate predicate, RegisterPair regX, RegisterBit regZ);
+
+    /**
+     * Generates the given predicate of the given register pair into a mask, where zero ignores the sign
+     * @param format
+     * @param predicate
+     * @param regX
+     * @param regZ
+     */
+    void generatePredicate(FloatFormat format, Predicate predicate, RegisterPair regX, RegisterBit regZ);
+
+    /**
+     * Generates whether the first register is less than the second into a mask (or greater than or equal, if negated),
+     * from the borrow of their subtraction. Requires a single lane.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateLess(IntegerFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the first big integer is less than the second into a mask at the first row of every element (or
+     * greater than or equal, if negated), from the borrow of their subtraction
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param rows
+     */
+    void generateLess(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate,
+                      RangeMask rows);
+
+    /**
+     * Generates whether the given big integers are equal into a mask at the first row of every element (or not equal,
+     * if negated)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     * @param rows
+     */
+    void generateEqual(IntegerFormat format, RegisterRows regX, RegisterRows regY, RegisterBit regZ, bool negate,
+                       RangeMask rows);
+
+    /**
+     * Generates whether the given big integer is zero into a mask at the first row of every element
+     * @param format
+     * @param regX
+     * @param regZ
+     * @param rows
+     */
+    void generateZero(IntegerFormat format, RegisterRows regX, RegisterBit regZ, RangeMask rows);
+
+    /**
+     * Generates whether the first register is less than the second into a mask (or greater than or equal, if negated),
+     * from the signs and from the borrow and the equality of the magnitudes (rather than from their difference), where
+     * zeros are equal regardless of their signs. The result is undefined for NaN operands.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateLess(FloatFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the first register pair is less than the second into a mask (or greater than or equal, if
+     * negated), from the borrow of their subtraction
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateLess(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the first register pair is less than the second into a mask (or greater than or equal, if
+     * negated), as for the registers
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateLess(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the given registers are equal into a mask (or not equal, if negated). Requires a single lane.
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateEqual(IntegerFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the given registers are equal into a mask (or not equal, if negated), where zeros are equal
+     * regardless of their signs
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateEqual(FloatFormat format, size_t regX, size_t regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the given register pairs are equal into a mask (or not equal, if negated)
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateEqual(IntegerFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate);
+
+    /**
+     * Generates whether the given register pairs are equal into a mask (or not equal, if negated), where zeros are
+     * equal regardless of their signs
+     * @param format
+     * @param regX
+     * @param regY
+     * @param regZ
+     * @param negate
+     */
+    void generateEqual(FloatFormat format, RegisterPair regX, RegisterPair regY, RegisterBit regZ, bool negate);
+
+}
+
+#endif // CUDAPIM_GENERATOR_H
@@ -0,0 +1,43 @@
+#ifndef CUDAPIM_MASK_H
+#define CUDAPIM_MASK_H
+
+#include <type_traits>
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * Boolean predicate (e.g., the result of a comparison), stored as a single bit in pim::vector<mask>: every vector
+     * occupies a single partition of a register (see pim::RegisterBit), so that the registers are shared by up to
+     * CROSSBAR_N vectors. Its routines (see pim/generator.h) are performed on the single partition.
+     */
+    struct mask {
+
+        /** The value of the predicate */
+        bool value = false;
+
+        mask() = default;
+
+        mask(bool value) : value(value) {}
+
+        explicit operator bool() const{
+            return value;
+        }
+
+    };
+
+    /** Mask comparison and negation (at namespace scope, so that they apply to the references of the vectors) */
+    inline bool operator==(mask a, mask b) {return a.value == b.value;}
+    inline bool operator!=(mask a, mask b) {return a.value != b.value;}
+    inline mask operator!(mask a) {return !a.value;}
+
+    /**
+     * Whether the given type is the mask type
+     * @tparam T
+     */
+    template <class T>
+    struct isMask : std::is_same<T, mask> {};
+
+}
+
+#endif // CUDAPIM_MASK_H
@@ -1,22 +1,63 @@
 #include "memory.h"
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "context.h"
+#include "simulator.cuh"
 
 namespace pim{
 
-    bool REGISTERS[CROSSBAR_R][NUM_CROSSBARS];
-    size_t lastCrossbar = 0;
+    /**
+     * The allocator state
+     */
+    struct AllocatorState {
+        bool registers[CROSSBAR_R][NUM_CROSSBARS];
+        /** The allocated partitions of the registers that are shared by vectors of a single partition (zero for the
+         * registers that are allocated whole) */
+        uint32_t partitions[CROSSBAR_R][NUM_CROSSBARS];
+        size_t lastCrossbar;
+    };
+    /** The allocator state (in process memory, unless the memory is mapped from a file) */
+    AllocatorState processAllocator;
+    AllocatorState *allocator = &processAllocator;
+
+    /** The allocator states of the live snapshots (by handle) */
+    std::map<size_t, std::unique_ptr<AllocatorState>> allocatorSnapshots;
+
+    /** Serializes the allocator across the threads of the contexts */
+    std::mutex allocatorMutex;
+
+    /**
+     * Returns the crossbars that the current context allocates from, and the crossbar from which it searches
+     * @param first
+     * @param count
+     * @return
+     */
+    size_t& allocatorRange(size_t& first, size_t& count){
+        context& ctx = getContext();
+        first = ctx.crossbars.start;
+        count = ctx.crossbars.stop - ctx.crossbars.start + 1;
+        return &ctx == &processContext() ? allocator->lastCrossbar : ctx.lastCrossbar;
+    }
 
     address malloc(size_t n){
 
         pim::size_t numCrossbars = (n + CROSSBAR_HEIGHT - 1) / CROSSBAR_HEIGHT;
 
-        // Search for free register
-        for(size_t startCrossbar = lastCrossbar; startCrossbar != (lastCrossbar - 1) % NUM_CROSSBARS; startCrossbar++, startCrossbar %= NUM_CROSSBARS){
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        size_t first, count;
+        size_t& lastCrossbar = allocatorRange(first, count);
+
+        // Search for free register (within the crossbars of the current context)
+        for(size_t i = 0; i < count; i++){
+            size_t startCrossbar = first + (lastCrossbar - first + i) % count;
+            if(startCrossbar + numCrossbars > first + count) continue;
             size_t reg;
             for(reg = 0; reg < CROSSBAR_R; reg++){
                 bool found = false;
                 for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
-                    if(REGISTERS[reg][crossbar]){
+                    if(allocator->registers[reg][crossbar]){
                         found = true; break;
                     }
                 }
@@ -24,7 +65,7 @@ namespace pim{
             }
             if(reg < CROSSBAR_R) {
                 for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
-                    REGISTERS[reg][crossbar] = true;
+                    allocator->registers[reg][crossbar] = true;
                 }
 
 #ifdef VERBOSE
@@ -44,17 +85,23 @@ namespace pim{
 
     }
 
-    std::vector<address> mallocMulti(size_t n, size_t m){
+    std::vector<address> malloc(size_t n, size_t m){
 
         pim::size_t numCrossbars = (n + CROSSBAR_HEIGHT - 1) / CROSSBAR_HEIGHT;
 
-        // Search for free register
-        for(size_t startCrossbar = lastCrossbar; startCrossbar != (lastCrossbar - 1) % NUM_CROSSBARS; startCrossbar++, startCrossbar %= NUM_CROSSBARS){
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        size_t first, count;
+        size_t& lastCrossbar = allocatorRange(first, count);
+
+        // Search for free register (within the crossbars of the current context)
+        for(size_t i = 0; i < count; i++){
+            size_t startCrossbar = first + (lastCrossbar - first + i) % count;
+            if(startCrossbar + numCrossbars > first + count) continue;
             std::vector<size_t> regs;
             for(size_t reg = 0; reg < CROSSBAR_R; reg++){
                 bool found = false;
                 for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
-                    if(REGISTERS[reg][crossbar]){
+                    if(allocator->registers[reg][crossbar]){
                         found = true; break;
                     }
                 }
@@ -66,12 +113,12 @@ namespace pim{
             if(regs.size() >= m) {
                 for(size_t reg : regs) {
                     for (size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++) {
-                        REGISTERS[reg][crossbar] = true;
+                        allocator->registers[reg][crossbar] = true;
                     }
                 }
 
 #ifdef VERBOSE
-                std::cerr << "Allocated register " << reg << " from " << startCrossbar << " to " << startCrossbar + numCrossbars << std::endl;
+                for(size_t reg : regs) std::cerr << "Allocated register " << reg << " from " << startCrossbar << " to " << startCrossbar + numCrossbars << std::endl;
 #endif
 
                 lastCrossbar = startCrossbar;
@@ -89,10 +136,79 @@ namespace pim{
 
     }
 
+    address mallocPartition(size_t n){
+
+        pim::size_t numCrossbars = (n + CROSSBAR_HEIGHT - 1) / CROSSBAR_HEIGHT;
+
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        size_t first, count;
+        size_t& lastCrossbar = allocatorRange(first, count);
+
+        // Search for a free partition of a shared register, and otherwise for a free register (within the crossbars of
+        // the current context)
+        for(size_t i = 0; i < count; i++){
+            size_t startCrossbar = first + (lastCrossbar - first + i) % count;
+            if(startCrossbar + numCrossbars > first + count) continue;
+            size_t reg, partition = -1;
+            for(reg = 0; reg < CROSSBAR_R; reg++){
+                uint32_t used = 0;
+                bool shared = true;
+                for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
+                    if(allocator->partitions[reg][crossbar] == 0){
+                        shared = false; break;
+                    }
+                    used |= allocator->partitions[reg][crossbar];
+                }
+                if(shared && ~used != 0){
+                    for(partition = 0; used & (1u << partition); partition++);
+                    break;
+                }
+            }
+            if(partition == -1){
+                for(reg = 0; reg < CROSSBAR_R; reg++){
+                    bool found = false;
+                    for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
+                        if(allocator->registers[reg][crossbar]){
+                            found = true; break;
+                        }
+                    }
+                    if(!found) break;
+                }
+                partition = 0;
+            }
+            if(reg < CROSSBAR_R) {
+                for(size_t crossbar = startCrossbar; crossbar < startCrossbar + numCrossbars; crossbar++){
+                    allocator->registers[reg][crossbar] = true;
+                    allocator->partitions[reg][crossbar] |= 1u << partition;
+                }
+
+#ifdef VERBOSE
+                std::cerr << "Allocated partition " << partition << " of register " << reg << " from " << startCrossbar << " to " << startCrossbar + numCrossbars << std::endl;
+#endif
+
+                lastCrossbar = startCrossbar;
+
+                return {startCrossbar, startCrossbar + numCrossbars, reg, partition};
+
+            }
+
+        }
+
+        std::cerr << "Out of Memory!" << std::endl;
+        exit(1);
+
+    }
+
     void free(address vec){
         if(vec.reg != -1){
+            std::lock_guard<std::mutex> lock(allocatorMutex);
             for(size_t crossbar = vec.startArray; crossbar < vec.endArray; crossbar++){
-                REGISTERS[vec.reg][crossbar] = false;
+                if(vec.partition != -1){
+                    // The register is freed with its last partition
+                    allocator->partitions[vec.reg][crossbar] &= ~(1u << vec.partition);
+                    if(allocator->partitions[vec.reg][crossbar]) continue;
+                }
+                allocator->registers[vec.reg][crossbar] = false;
             }
 
 #ifdef VERBOSE
@@ -102,4 +218,37 @@ namespace pim{
         }
     }
 
+    size_t snapshot(){
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        size_t handle = snapshotMemory();
+        allocatorSnapshots[handle].reset(new AllocatorState(*allocator));
+        return handle;
+    }
+
+    void restore(size_t handle){
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        restoreMemory(handle);
+        *allocator = *allocatorSnapshots.at(handle);
+    }
+
+    void releaseSnapshot(size_t handle){
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        releaseMemorySnapshot(handle);
+        allocatorSnapshots.erase(handle);
+    }
+
+    void mapMemoryFile(const std::string& path){
+        bool created;
+        auto mapped = static_cast<AllocatorState *>(mapMemory(path, sizeof(AllocatorState), created));
+        if(created) *mapped = *allocator;
+        allocator = mapped;
+    }
+
+    void unmapMemoryFile(){
+        if(allocator == &processAllocator) return;
+        processAllocator = *allocator;
+        allocator = &processAllocator;
+        unmapMemory();
+    }
+
 }
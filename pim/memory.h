@@ -1,6 +1,7 @@
 #ifndef CUDAPIM_MEMORY_H
 #define CUDAPIM_MEMORY_H
 
+#include <string>
 #include <vector>
 #include "constants.h"
 
@@ -21,12 +22,52 @@ namespace pim{
      */
     std::vector<address> malloc(size_t n, size_t m);
 
+    /**
+     * Allocates a vector of size n of elements of a single partition (e.g., pim::mask), which shares its register with
+     * up to CROSSBAR_N - 1 other such vectors
+     * @param n
+     * @return
+     */
+    address mallocPartition(size_t n);
+
     /**
      * Frees the memory allocates for the given vector
      * @param vec
      */
     void free(address vec);
 
+    /**
+     * Takes a copy-on-write snapshot of the memory and allocator states
+     * @return the handle of the snapshot
+     */
+    size_t snapshot();
+
+    /**
+     * Restores the memory and allocator states to the given snapshot. Vectors allocated after the snapshot should not
+     * be used afterwards.
+     * @param handle
+     */
+    void restore(size_t handle);
+
+    /**
+     * Releases the given snapshot
+     * @param handle
+     */
+    void releaseSnapshot(size_t handle);
+
+    /**
+     * Maps the memory and allocator states from the given file (created if it does not exist), so that they are
+     * demand-paged from the file and persist across runs. An existing file replaces the current states (e.g., to resume
+     * a previous run), while a new file is initialized with them.
+     * @param path
+     */
+    void mapMemoryFile(const std::string& path);
+
+    /**
+     * Unmaps the memory file, copying the memory and allocator states back to process memory
+     */
+    void unmapMemoryFile();
+
 }
 
 #endif // CUDAPIM_MEMORY_H
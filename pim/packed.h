@@ -0,0 +1,55 @@
+#ifndef CUDAPIM_PACKED_H
+#define CUDAPIM_PACKED_H
+
+#include <type_traits>
+#include "constants.h"
+
+namespace pim{
+
+    /**
+     * L lanes of the integer type T packed within a single word (SIMD within a register), where lane k occupies
+     * partitions [k * 8 * sizeof(T), (k + 1) * 8 * sizeof(T)) (the memory order of the lanes on the host). The routines
+     * of pim::vector<packed<T, L>> operate on all lanes at once, with the carries isolated between the lanes.
+     * @tparam T
+     * @tparam L
+     */
+    template <class T, size_t L>
+    struct packed {
+
+        static_assert(std::is_integral<T>::value && sizeof(T) * L == sizeof(dtype),
+                "packed: the lanes must be integers that fill a word.");
+
+        /** The lanes */
+        T lanes[L];
+
+        T& operator[](size_t i){
+            return lanes[i];
+        }
+        const T& operator[](size_t i) const{
+            return lanes[i];
+        }
+
+        friend bool operator==(const packed& a, const packed& b){
+            for(size_t i = 0; i < L; i++){
+                if(a.lanes[i] != b.lanes[i]) return false;
+            }
+            return true;
+        }
+        friend bool operator!=(const packed& a, const packed& b){
+            return !(a == b);
+        }
+
+    };
+
+    /**
+     * Whether the given type is a packed type
+     * @tparam T
+     */
+    template <class T>
+    struct isPacked : std::false_type {};
+    template <class T, size_t L>
+    struct isPacked<packed<T, L>> : std::true_type {};
+
+}
+
+#endif // CUDAPIM_PACKED_H
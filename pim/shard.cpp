@@ -0,0 +1,749 @@
+#include "shard.h"
+#include "async.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace pim{
+
+    /** The number of words in each ring of the shared memory transport */
+    constexpr uint64_t SHARD_RING_WORDS = 1 << 16;
+    /** The number of words buffered for a shard before they are sent */
+    constexpr size_t SHARD_BATCH_WORDS = 1 << 12;
+    /** The number of crossbars transferred together when handing the memory state over */
+    constexpr size_t SHARD_TRANSFER_CROSSBARS = 16;
+    /** The number of polls of an empty (or full) transport before the waiting process starts sleeping */
+    constexpr size_t SHARD_SPIN_POLLS = 1 << 12;
+
+    /** The number of words of a crossbar in the memory state */
+    constexpr size_t SHARD_CROSSBAR_SIZE = CROSSBAR_R * CROSSBAR_HEIGHT;
+    /** The number of transport words holding the memory state of a crossbar */
+    constexpr size_t SHARD_CROSSBAR_WORDS = SHARD_CROSSBAR_SIZE * sizeof(dtype) / sizeof(otype);
+    static_assert(SHARD_CROSSBAR_SIZE * sizeof(dtype) % sizeof(otype) == 0, "Crossbars are transferred as whole words");
+
+    /**
+     * The word that introduces a control command. It is never a forwarded micro-operation, as the coordinator encodes
+     * the forwarded mask micro-operations itself.
+     */
+    constexpr otype SHARD_CONTROL = ~(otype)0;
+
+    /**
+     * The control commands of the coordinator
+     */
+    enum ShardCommand{
+        /** Stops the worker */
+        SHUTDOWN,
+        /** Waits for the completion of the micro-operations, and replies with a single word */
+        SYNCHRONIZE,
+        /** Selects the storage engine (followed by the engine) */
+        STORAGE_ENGINE,
+        /** Replaces the memory state of the shard (followed by the memory state) */
+        LOAD,
+        /** Replies with the memory state of the shard */
+        STORE
+    };
+
+    /**
+     * A single-producer single-consumer ring of words in shared memory
+     */
+    struct ShardRing {
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) otype words[SHARD_RING_WORDS];
+    };
+
+    /**
+     * The shared memory object of a shard: the requests of the coordinator, and the replies of the worker
+     */
+    struct ShardRings {
+        ShardRing requests, replies;
+    };
+
+    /**
+     * A bidirectional stream of words between the coordinator and a worker
+     */
+    class ShardChannel {
+
+    public:
+
+        /**
+         * @param coordinator whether this is the coordinator end of the channel
+         * @param peer the process at the other end of the channel
+         */
+        ShardChannel(bool coordinator, pid_t peer) : coordinator(coordinator), peer(peer) {}
+
+        virtual ~ShardChannel() = default;
+
+        /**
+         * Sends the given words
+         * @param words
+         * @param count
+         */
+        virtual void send(const otype *words, size_t count) = 0;
+
+        /**
+         * Receives at least one (and at most count) words
+         * @param words
+         * @param count
+         * @return the number of received words
+         */
+        virtual size_t receive(otype *words, size_t count) = 0;
+
+        /**
+         * Receives exactly count words
+         * @param words
+         * @param count
+         */
+        void receiveAll(otype *words, size_t count){
+            while(count > 0){
+                size_t received = receive(words, count);
+                words += received;
+                count -= received;
+            }
+        }
+
+    protected:
+
+        /** Whether this is the coordinator end of the channel, and the process at the other end */
+        bool coordinator;
+        pid_t peer;
+
+        /**
+         * Waits for the other end of the channel, spinning first and then sleeping
+         * @param polls the number of polls so far
+         */
+        void wait(size_t& polls){
+            if(++polls < SHARD_SPIN_POLLS){
+                std::this_thread::yield();
+                return;
+            }
+            int status = 0;
+            if(coordinator ? waitpid(peer, &status, WNOHANG) != 0 : getppid() != peer){
+                throw std::runtime_error("Shard: the peer process exited.");
+            }
+            usleep(50);
+        }
+
+    };
+
+    /**
+     * A channel over a pair of rings in a shared memory object
+     */
+    class RingChannel : public ShardChannel {
+
+    public:
+
+        RingChannel(ShardRings *rings, bool coordinator, pid_t peer) : ShardChannel(coordinator, peer), rings(rings),
+            out(coordinator ? &rings->requests : &rings->replies), in(coordinator ? &rings->replies : &rings->requests) {}
+
+        ~RingChannel() override {
+            munmap(rings, sizeof(ShardRings));
+        }
+
+        void send(const otype *words, size_t count) override {
+            size_t polls = 0;
+            while(count > 0){
+                uint64_t head = out->head.load(std::memory_order_relaxed);
+                uint64_t space = SHARD_RING_WORDS - (head - out->tail.load(std::memory_order_acquire));
+                if(space == 0){
+                    wait(polls);
+                    continue;
+                }
+                uint64_t sent = std::min(space, (uint64_t)count);
+                for(uint64_t i = 0; i < sent; i++) out->words[(head + i) % SHARD_RING_WORDS] = words[i];
+                out->head.store(head + sent, std::memory_order_release);
+                words += sent;
+                count -= (size_t)sent;
+                polls = 0;
+            }
+        }
+
+        size_t receive(otype *words, size_t count) override {
+            size_t polls = 0;
+            while(true){
+                uint64_t tail = in->tail.load(std::memory_order_relaxed);
+                uint64_t available = in->head.load(std::memory_order_acquire) - tail;
+                if(available == 0){
+                    wait(polls);
+                    continue;
+                }
+                uint64_t received = std::min(available, (uint64_t)count);
+                for(uint64_t i = 0; i < received; i++) words[i] = in->words[(tail + i) % SHARD_RING_WORDS];
+                in->tail.store(tail + received, std::memory_order_release);
+                return (size_t)received;
+            }
+        }
+
+    private:
+
+        /** The shared memory object, and the rings of the outgoing and incoming words */
+        ShardRings *rings;
+        ShardRing *out, *in;
+
+    };
+
+    /**
+     * A channel over a Unix-domain stream socket
+     */
+    class SocketChannel : public ShardChannel {
+
+    public:
+
+        SocketChannel(int fd, bool coordinator, pid_t peer) : ShardChannel(coordinator, peer), fd(fd) {}
+
+        ~SocketChannel() override {
+            close(fd);
+        }
+
+        void send(const otype *words, size_t count) override {
+            const char *data = reinterpret_cast<const char *>(words);
+            ::size_t remaining = count * sizeof(otype);
+            while(remaining > 0){
+                ssize_t sent = ::send(fd, data, remaining, MSG_NOSIGNAL);
+                if(sent < 0 && errno == EINTR) continue;
+                if(sent < 0){
+                    throw std::runtime_error("Shard: the peer process exited.");
+                }
+                data += sent;
+                remaining -= sent;
+            }
+        }
+
+        size_t receive(otype *words, size_t count) override {
+            char *data = reinterpret_cast<char *>(words);
+            ssize_t received = 0;
+            do{
+                received = recv(fd, data, count * sizeof(otype), 0);
+            } while(received < 0 && errno == EINTR);
+            if(received <= 0){
+                throw std::runtime_error("Shard: the peer process exited.");
+            }
+            // Complete a partially received word
+            ssize_t partial = received % (ssize_t)sizeof(otype);
+            if(partial != 0){
+                ssize_t rest = recv(fd, data + received, sizeof(otype) - partial, MSG_WAITALL);
+                if(rest != (ssize_t)sizeof(otype) - partial){
+                    throw std::runtime_error("Shard: the peer process exited.");
+                }
+                received += rest;
+            }
+            return (size_t)(received / (ssize_t)sizeof(otype));
+        }
+
+    private:
+
+        /** The socket */
+        int fd;
+
+    };
+
+    /**
+     * A shard worker, as seen by the coordinator
+     */
+    struct Shard {
+
+        /** The owned crossbars [first, first + count) */
+        size_t first, count;
+
+        /** The worker process, and the name of its shared memory object (empty for sockets) */
+        pid_t pid;
+        std::string name;
+
+        /** The channel to the worker, and the words not yet sent over it */
+        std::unique_ptr<ShardChannel> channel;
+        std::vector<otype> pending;
+
+        /** The masks that the worker last received */
+        RangeMask crossbars, rows;
+
+    };
+
+    /** The running shards (ordered by their crossbar ranges) */
+    std::vector<Shard> shards;
+
+    /** Whether the workers are bound to NUMA nodes, and whether the rings are backed by huge pages */
+    bool shardNuma = true, shardHugePages = false;
+
+    /**
+     * Reads the first line of the given (sysfs) file
+     * @param path
+     * @return the line, or an empty string if the file does not exist
+     */
+    std::string readLine(const std::string& path){
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    /**
+     * Parses a list of ranges in the sysfs format (e.g., "0-3,8-11")
+     * @param list
+     * @return
+     */
+    std::vector<size_t> parseList(const std::string& list){
+        std::vector<size_t> values;
+        std::string::size_type position = 0;
+        while(position < list.size()){
+            std::string::size_type end = list.find(',', position);
+            if(end == std::string::npos) end = list.size();
+            std::string range = list.substr(position, end - position);
+            std::string::size_type dash = range.find('-');
+            if(!range.empty()){
+                size_t first = std::stoll(range.substr(0, dash));
+                size_t last = dash == std::string::npos ? first : std::stoll(range.substr(dash + 1));
+                for(size_t value = first; value <= last; value++) values.push_back(value);
+            }
+            position = end + 1;
+        }
+        return values;
+    }
+
+    /**
+     * Returns the identifier of the given device as of CUDA_VISIBLE_DEVICES: the entry of the inherited list (which may
+     * hold UUIDs rather than ordinals), or the ordinal if the variable is unset
+     * @param device
+     * @return
+     */
+    std::string visibleDevice(size_t device){
+        const char *inherited = getenv("CUDA_VISIBLE_DEVICES");
+        if(inherited == nullptr) return std::to_string(device);
+        std::string list = inherited;
+        std::string::size_type position = 0;
+        for(size_t k = 0; k < device; k++){
+            position = list.find(',', position);
+            if(position == std::string::npos) return std::to_string(device);
+            position++;
+        }
+        std::string::size_type end = list.find(',', position);
+        return list.substr(position, end == std::string::npos ? std::string::npos : end - position);
+    }
+
+    /**
+     * Returns the NUMA node local to the given device
+     * @param device
+     * @return the node, or -1 if unknown
+     */
+    int deviceNode(size_t device){
+        unsigned domain = 0, bus = 0, slot = 0, function = 0;
+        std::string busId = devicePciBusId(device);
+        if(sscanf(busId.c_str(), "%x:%x:%x.%x", &domain, &bus, &slot, &function) != 4) return -1;
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/bus/pci/devices/%04x:%02x:%02x.%x/numa_node", domain, bus, slot, function);
+        std::string node = readLine(path);
+        return node.empty() ? -1 : std::stoi(node);
+    }
+
+    /**
+     * Binds the current thread (and the threads it creates) to the CPUs of the given NUMA node, and prefers the memory
+     * of the node for its allocations
+     * @param node
+     */
+    void bindToNode(int node){
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for(size_t cpu : parseList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))){
+            if(cpu < CPU_SETSIZE) CPU_SET(cpu, &cpus);
+        }
+        if(CPU_COUNT(&cpus) > 0) sched_setaffinity(0, sizeof(cpus), &cpus);
+
+        std::vector<unsigned long> nodes(node / (8 * sizeof(unsigned long)) + 1, 0);
+        nodes[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodes.data(), nodes.size() * 8 * sizeof(unsigned long) + 1);
+
+    }
+
+    /**
+     * Sends the pending words of the given shard
+     * @param shard
+     */
+    void flushShard(Shard& shard){
+        if(shard.pending.empty()) return;
+        shard.channel->send(shard.pending.data(), (size_t)shard.pending.size());
+        shard.pending.clear();
+    }
+
+    /**
+     * Sends the given control command (and its argument, if any) to the given shard
+     * @param shard
+     * @param command
+     * @param argument
+     */
+    void sendCommand(Shard& shard, ShardCommand command, otype argument){
+        shard.pending.push_back(SHARD_CONTROL);
+        shard.pending.push_back(command);
+        if(command == ShardCommand::STORAGE_ENGINE) shard.pending.push_back(argument);
+        flushShard(shard);
+    }
+
+    /**
+     * Restricts the given mask to the range [first, last]
+     * @param mask
+     * @param first
+     * @param last
+     * @param restricted
+     * @return false if no element of the mask is in the range
+     */
+    bool restrictMask(RangeMask mask, size_t first, size_t last, RangeMask& restricted){
+        if(mask.stop < first || mask.start > last) return false;
+        size_t start = mask.start >= first ? mask.start : mask.start + (first - mask.start + mask.step - 1) / mask.step * mask.step;
+        if(start > last || start > mask.stop) return false;
+        size_t stop = start + (std::min(mask.stop, last) - start) / mask.step * mask.step;
+        restricted = {start, stop, mask.step};
+        return true;
+    }
+
+    /**
+     * Queues the given micro-operation for the given shard, preceded by the masks that the shard did not receive yet
+     * @param shard
+     * @param operation
+     * @param crossbars the crossbar mask, restricted to the shard
+     * @param rows
+     */
+    void queueOperation(Shard& shard, otype operation, RangeMask crossbars, RangeMask rows){
+        if(shard.crossbars != crossbars){
+            shard.pending.push_back(((((((otype)crossbars.step << LOG_NUM_CROSSBARS) | crossbars.stop) << LOG_NUM_CROSSBARS) |
+                    crossbars.start) << 3) | MicrooperationType::MASK);
+            shard.crossbars = crossbars;
+        }
+        if(shard.rows != rows){
+            shard.pending.push_back(((((((otype)rows.step << LOG_CROSSBAR_HEIGHT) | rows.stop) << LOG_CROSSBAR_HEIGHT) |
+                    rows.start) << 3) | (1 << 2) | MicrooperationType::MASK);
+            shard.rows = rows;
+        }
+        shard.pending.push_back(operation);
+        if((size_t)shard.pending.size() >= SHARD_BATCH_WORDS) flushShard(shard);
+    }
+
+    /**
+     * Returns the index of the shard that owns the given crossbar
+     * @param crossbar
+     * @return
+     */
+    size_t shardOf(size_t crossbar){
+        size_t index = crossbar * (size_t)shards.size() / NUM_CROSSBARS;
+        while(shards[index].first + shards[index].count <= crossbar) index++;
+        return index;
+    }
+
+    /**
+     * Stops the workers without gathering their memory state (at exit)
+     */
+    void terminateShards(){
+        for(Shard& shard : shards){
+            try{
+                sendCommand(shard, ShardCommand::SHUTDOWN, 0);
+            } catch(const std::runtime_error&){}
+            shard.channel.reset();
+            waitpid(shard.pid, nullptr, 0);
+            if(!shard.name.empty()) shm_unlink(shard.name.c_str());
+        }
+        shards.clear();
+    }
+
+    /**
+     * Returns the default worker executable (pimshard next to the current executable)
+     * @return
+     */
+    std::string defaultWorker(){
+        char path[PATH_MAX];
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if(length <= 0) return "pimshard";
+        std::string executable(path, length);
+        return executable.substr(0, executable.rfind('/') + 1) + "pimshard";
+    }
+
+    void setShardPlacement(bool numa, bool hugePages){
+        shardNuma = numa;
+        shardHugePages = hugePages;
+    }
+
+    void startShards(size_t numShards, ShardTransport transport, const std::string& worker){
+
+        drainQueue();
+        if(!shards.empty()){
+            throw std::runtime_error("Start Shards: shards are already running.");
+        }
+        if(numShards <= 0 || numShards > NUM_CROSSBARS){
+            throw std::runtime_error("Start Shards: invalid number of shards.");
+        }
+        validateSharding();
+
+        static bool registered = false;
+        if(!registered){
+            atexit(terminateShards);
+            registered = true;
+        }
+
+        std::string executable = worker.empty() ? defaultWorker() : worker;
+        size_t devices = deviceCount();
+        std::vector<size_t> nodes;
+        if(shardNuma) nodes = parseList(readLine("/sys/devices/system/node/online"));
+        for(size_t i = 0; i < numShards; i++){
+
+            Shard shard = {i * NUM_CROSSBARS / numShards, (i + 1) * NUM_CROSSBARS / numShards - i * NUM_CROSSBARS / numShards,
+                           -1, "", nullptr, {}, RangeMask(-1, -1, -1), RangeMask(-1, -1, -1)};
+
+            // Place the worker on the node local to its device, or otherwise on the nodes in turn
+            int node = -1;
+            if(nodes.size() > 1){
+                node = devices > 0 ? deviceNode(i % devices) : -1;
+                if(node < 0) node = (int)nodes[i % (size_t)nodes.size()];
+            }
+
+            // Create the endpoint of the worker
+            int fds[2] = {-1, -1};
+            ShardRings *rings = nullptr;
+            std::string endpoint;
+            if(transport == ShardTransport::SHARED_MEMORY){
+                shard.name = "/pim-shard-" + std::to_string(getpid()) + "-" + std::to_string(i);
+                int fd = shm_open(shard.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+                if(fd < 0 || ftruncate(fd, sizeof(ShardRings)) != 0){
+                    if(fd >= 0) close(fd);
+                    terminateShards();
+                    throw std::runtime_error("Start Shards: failed to create " + shard.name + ".");
+                }
+                void *mapped = mmap(nullptr, sizeof(ShardRings), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if(mapped == MAP_FAILED){
+                    shm_unlink(shard.name.c_str());
+                    terminateShards();
+                    throw std::runtime_error("Start Shards: failed to map " + shard.name + ".");
+                }
+                if(shardHugePages) madvise(mapped, sizeof(ShardRings), MADV_HUGEPAGE);
+                rings = new (mapped) ShardRings();
+                endpoint = shard.name;
+            }
+            else{
+                if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0){
+                    terminateShards();
+                    throw std::runtime_error("Start Shards: failed to create a socket.");
+                }
+                endpoint = std::to_string(fds[1]);
+            }
+
+            // Launch the worker, spreading the workers over the devices (of those visible to this process)
+            std::string device = devices > 1 ? visibleDevice(i % devices) : "";
+            pid_t pid = fork();
+            if(pid == 0){
+                if(fds[1] >= 0) fcntl(fds[1], F_SETFD, 0);
+                if(!device.empty()) setenv("CUDA_VISIBLE_DEVICES", device.c_str(), 1);
+                execl(executable.c_str(), executable.c_str(), transport == ShardTransport::SHARED_MEMORY ? "shm" : "socket",
+                      endpoint.c_str(), std::to_string(shard.first).c_str(), std::to_string(shard.count).c_str(),
+                      std::to_string(node).c_str(), (char *)nullptr);
+                _exit(127);
+            }
+            if(fds[1] >= 0) close(fds[1]);
+            if(pid < 0){
+                if(rings) munmap(rings, sizeof(ShardRings));
+                if(fds[0] >= 0) close(fds[0]);
+                if(!shard.name.empty()) shm_unlink(shard.name.c_str());
+                terminateShards();
+                throw std::runtime_error("Start Shards: failed to launch " + executable + ".");
+            }
+            shard.pid = pid;
+            if(rings) shard.channel.reset(new RingChannel(rings, true, pid));
+            else shard.channel.reset(new SocketChannel(fds[0], true, pid));
+            shards.push_back(std::move(shard));
+
+        }
+
+        // Hand the memory state over to the workers
+        try{
+            StorageEngine engine = getStorageEngine();
+            bool allocated = memoryAllocated();
+            std::vector<dtype> buffer(SHARD_TRANSFER_CROSSBARS * SHARD_CROSSBAR_SIZE);
+            for(Shard& shard : shards){
+                sendCommand(shard, ShardCommand::STORAGE_ENGINE, engine);
+                if(!allocated) continue;
+                sendCommand(shard, ShardCommand::LOAD, 0);
+                for(size_t crossbar = shard.first; crossbar < shard.first + shard.count; crossbar += SHARD_TRANSFER_CROSSBARS){
+                    size_t count = std::min(SHARD_TRANSFER_CROSSBARS, shard.first + shard.count - crossbar);
+                    copyCrossbars(crossbar, count, buffer.data(), true);
+                    shard.channel->send(reinterpret_cast<const otype *>(buffer.data()), count * SHARD_CROSSBAR_WORDS);
+                }
+            }
+            synchronizeShards();
+        } catch(const std::runtime_error&){
+            terminateShards();
+            throw;
+        }
+        releaseMemory();
+
+    }
+
+    void stopShards(){
+
+        drainQueue();
+        if(shards.empty()) return;
+
+        // Gather the memory state of the workers
+        std::vector<dtype> buffer(SHARD_TRANSFER_CROSSBARS * SHARD_CROSSBAR_SIZE);
+        for(Shard& shard : shards){
+            sendCommand(shard, ShardCommand::STORE, 0);
+            for(size_t crossbar = shard.first; crossbar < shard.first + shard.count; crossbar += SHARD_TRANSFER_CROSSBARS){
+                size_t count = std::min(SHARD_TRANSFER_CROSSBARS, shard.first + shard.count - crossbar);
+                shard.channel->receiveAll(reinterpret_cast<otype *>(buffer.data()), count * SHARD_CROSSBAR_WORDS);
+                copyCrossbars(crossbar, count, buffer.data(), false);
+            }
+        }
+
+        terminateShards();
+
+    }
+
+    bool shardsActive(){
+        return !shards.empty();
+    }
+
+    void forwardToShards(otype operation, RangeMask crossbars, RangeMask rows){
+
+        // The shards are ordered, so only the shards between those of the first and last crossbars are considered
+        for(size_t i = shardOf(crossbars.start); i < (size_t)shards.size() && shards[i].first <= crossbars.stop; i++){
+            Shard& shard = shards[i];
+            RangeMask restricted(0, 0, 1);
+            if(restrictMask(crossbars, shard.first, shard.first + shard.count - 1, restricted)){
+                queueOperation(shard, operation, restricted, rows);
+            }
+        }
+
+    }
+
+    dtype readFromShard(otype operation, RangeMask crossbars, RangeMask rows){
+
+        // The read selects a single crossbar
+        Shard& shard = shards[shardOf(crossbars.start)];
+        queueOperation(shard, operation, crossbars, rows);
+        flushShard(shard);
+        otype result = 0;
+        shard.channel->receiveAll(&result, 1);
+        return (dtype)result;
+
+    }
+
+    void synchronizeShards(){
+
+        // Flush every shard before waiting, so that the shards synchronize concurrently
+        for(Shard& shard : shards) sendCommand(shard, ShardCommand::SYNCHRONIZE, 0);
+        for(Shard& shard : shards){
+            otype reply = 0;
+            shard.channel->receiveAll(&reply, 1);
+        }
+
+    }
+
+    void setShardStorageEngine(StorageEngine engine){
+        for(Shard& shard : shards) sendCommand(shard, ShardCommand::STORAGE_ENGINE, engine);
+    }
+
+    void serveShard(ShardTransport transport, const std::string& endpoint, size_t first, size_t count, int node){
+
+        // The host memory of the worker is allocated after binding, and thus on its node
+        if(node >= 0) bindToNode(node);
+        setOwnedCrossbars(first, count);
+
+        // Connect to the coordinator
+        std::unique_ptr<ShardChannel> channel;
+        if(transport == ShardTransport::SHARED_MEMORY){
+            int fd = shm_open(endpoint.c_str(), O_RDWR, 0600);
+            if(fd < 0){
+                throw std::runtime_error("Serve Shard: failed to open " + endpoint + ".");
+            }
+            void *mapped = mmap(nullptr, sizeof(ShardRings), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if(mapped == MAP_FAILED){
+                throw std::runtime_error("Serve Shard: failed to map " + endpoint + ".");
+            }
+            channel.reset(new RingChannel(static_cast<ShardRings *>(mapped), false, getppid()));
+        }
+        else{
+            channel.reset(new SocketChannel(std::stoi(endpoint), false, getppid()));
+        }
+
+        // The words are received in batches
+        std::vector<otype> batch(SHARD_BATCH_WORDS);
+        size_t position = 0, received = 0;
+        auto next = [&]() -> otype {
+            if(position == received){
+                received = channel->receive(batch.data(), SHARD_BATCH_WORDS);
+                position = 0;
+            }
+            return batch[position++];
+        };
+
+        std::vector<dtype> buffer(SHARD_TRANSFER_CROSSBARS * SHARD_CROSSBAR_SIZE);
+        while(true){
+
+            otype operation = next();
+            if(operation != SHARD_CONTROL){
+                dtype result = perform(operation);
+                if((operation & 0x3) == MicrooperationType::READ){
+                    otype reply = result;
+                    channel->send(&reply, 1);
+                }
+                continue;
+            }
+
+            switch(next()){
+
+                case ShardCommand::SHUTDOWN:
+                    synchronize();
+                    return;
+
+                case ShardCommand::SYNCHRONIZE: {
+                    synchronize();
+                    otype reply = 0;
+                    channel->send(&reply, 1);
+                    break;
+                }
+
+                case ShardCommand::STORAGE_ENGINE:
+                    setStorageEngine((StorageEngine)next());
+                    break;
+
+                case ShardCommand::LOAD:
+                    for(size_t crossbar = first; crossbar < first + count; crossbar += SHARD_TRANSFER_CROSSBARS){
+                        size_t crossbars = std::min(SHARD_TRANSFER_CROSSBARS, first + count - crossbar);
+                        otype *words = reinterpret_cast<otype *>(buffer.data());
+                        for(size_t i = 0; i < crossbars * SHARD_CROSSBAR_WORDS; i++) words[i] = next();
+                        copyCrossbars(crossbar, crossbars, buffer.data(), false);
+                    }
+                    break;
+
+                case ShardCommand::STORE:
+                    for(size_t crossbar = first; crossbar < first + count; crossbar += SHARD_TRANSFER_CROSSBARS){
+                        size_t crossbars = std::min(SHARD_TRANSFER_CROSSBARS, first + count - crossbar);
+                        copyCrossbars(crossbar, crossbars, buffer.data(), true);
+                        channel->send(reinterpret_cast<const otype *>(buffer.data()), crossbars * SHARD_CROSSBAR_WORDS);
+                    }
+                    break;
+
+                default:
+                    throw std::runtime_error("Serve Shard: invalid command.");
+
+            }
+
+        }
+
+    }
+
+}
@@ -0,0 +1,146 @@
+#ifndef CUDAPIM_SHARD_H
+#define CUDAPIM_SHARD_H
+
+#include <string>
+#include "constants.h"
+#include "simulator.cuh"
+
+namespace pim{
+
+    /**
+     * In the sharded mode, the memory is partitioned into contiguous crossbar ranges that are each simulated by a worker
+     * process (tools/pimshard). The coordinator (the process issuing the micro-operations) validates every
+     * micro-operation and forwards it to the shards whose ranges intersect the current crossbar mask, along with the
+     * masks restricted to their ranges. Reads are routed to the shard owning the selected crossbar.
+     */
+
+    /**
+     * The transports between the coordinator and the shards
+     */
+    enum ShardTransport{
+        /** A pair of single-producer single-consumer rings in a shared memory object per shard */
+        SHARED_MEMORY,
+        /** A Unix-domain socket pair per shard */
+        SOCKET
+    };
+
+    /**
+     * Starts the given number of shard workers, handing the current memory state over to them
+     * @param numShards
+     * @param transport
+     * @param worker the path of the worker executable (by default, pimshard next to the current executable)
+     */
+    void startShards(size_t numShards, ShardTransport transport = ShardTransport::SHARED_MEMORY,
+                     const std::string& worker = "");
+
+    /**
+     * Selects the placement of the shard workers started afterwards
+     * @param numa whether every worker (its threads and host memory) is bound to a NUMA node: the node local to its
+     * device when known, and otherwise the nodes in turn
+     * @param hugePages whether the shared memory rings are backed by transparent huge pages
+     */
+    void setShardPlacement(bool numa, bool hugePages = false);
+
+    /**
+     * Stops the shard workers, gathering their memory state back into the coordinator
+     */
+    void stopShards();
+
+    /**
+     * Whether shard workers are currently running
+     * @return
+     */
+    bool shardsActive();
+
+    /**
+     * Runs a shard worker (used by tools/pimshard), serving the micro-operations of the coordinator until it stops
+     * @param transport
+     * @param endpoint the name of the shared memory object, or the file descriptor of the socket
+     * @param first the first crossbar owned by the shard
+     * @param count the number of crossbars owned by the shard
+     * @param node the NUMA node that the worker is bound to (-1 for none)
+     */
+    void serveShard(ShardTransport transport, const std::string& endpoint, size_t first, size_t count, int node = -1);
+
+    /**
+     * Forwards the given micro-operation to the shards that own crossbars of the given crossbar mask
+     * @param operation
+     * @param crossbars
+     * @param rows
+     */
+    void forwardToShards(otype operation, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Performs the given read micro-operation on the shard that owns the selected crossbar
+     * @param operation
+     * @param crossbars
+     * @param rows
+     * @return
+     */
+    dtype readFromShard(otype operation, RangeMask crossbars, RangeMask rows);
+
+    /**
+     * Waits for the shards to complete all previously forwarded micro-operations
+     */
+    void synchronizeShards();
+
+    /**
+     * Selects the storage engine of the shards
+     * @param engine
+     */
+    void setShardStorageEngine(StorageEngine engine);
+
+    /**
+     * Restricts the memory state of this process to the given crossbars (before the memory state is allocated)
+     * @param first
+     * @param count
+     */
+    void setOwnedCrossbars(size_t first, size_t count);
+
+    /**
+     * Copies the given crossbars of the memory state to (or from) host memory, in the current storage engine
+     * @param first
+     * @param count
+     * @param host
+     * @param toHost
+     */
+    void copyCrossbars(size_t first, size_t count, dtype *host, bool toHost);
+
+    /**
+     * Releases the memory state of this process (after it was handed over to the shards)
+     */
+    void releaseMemory();
+
+    /**
+     * Returns whether the memory state is allocated (or mapped)
+     * @return
+     */
+    bool memoryAllocated();
+
+    /**
+     * Verifies that the simulator state allows starting shards
+     */
+    void validateSharding();
+
+    /**
+     * Returns the current storage engine
+     * @return
+     */
+    StorageEngine getStorageEngine();
+
+    /**
+     * Returns the number of devices available to this process
+     * @return
+     */
+    size_t deviceCount();
+
+    /**
+     * Returns the PCI bus identifier of the given device (empty if unavailable)
+     * @param device
+     * @return
+     */
+    std::string devicePciBusId(size_t device);
+
+}
+
+#endif // CUDAPIM_SHARD_H
@@ -1,7 +1,19 @@
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
 #include "simulator.cuh"
+#include "async.h"
+#include "shard.h"
+#include "trace.h"
 
 namespace pim {
 
@@ -11,20 +23,230 @@ namespace pim {
     /** The size of the logic operation buffer */
     constexpr size_t SIM_LOGIC_BUFFER_SIZE = 1024;
 
-    /** Represents the current memory state */
-    thrust::device_vector<dtype> memory(NUM_CROSSBARS * CROSSBAR_R * CROSSBAR_HEIGHT, 0);
+    /** The minimum number of units for horizontal logic operations to be performed four rows per thread */
+    constexpr size_t SIM_VECTOR_UNITS = 1 << 16;
+
+    /** The data type of a bit-plane word (bit-plane storage engine) */
+    typedef uint64_t ptype;
+    /** The log of the number of rows stored in a bit-plane word */
+    constexpr size_t LOG_PLANE_ROWS = 6;
+    /** The number of rows stored in a bit-plane word */
+    constexpr size_t PLANE_ROWS = 1 << LOG_PLANE_ROWS;
+    /** The number of bit-plane words per (crossbar, register, partition) */
+    constexpr size_t PLANE_WORDS = CROSSBAR_HEIGHT / PLANE_ROWS;
+    /** The number of threads per block in the bit-plane CUDA kernels (one per partition and bit-plane word) */
+    constexpr size_t SIM_PLANE_THREADS_PER_BLOCK = CROSSBAR_N * PLANE_WORDS;
+    static_assert(CROSSBAR_N == 8 * sizeof(dtype) && CROSSBAR_N == 32, "Bit-plane storage requires a partition per bit of a warp-sized word");
+
+    /** The number of crossbars converted together when switching storage engines */
+    constexpr size_t SIM_CONVERSION_CROSSBARS = 256;
+
+    /** The number of words of a crossbar in the memory vector (in every layout and storage engine) */
+    constexpr size_t CROSSBAR_SIZE = CROSSBAR_R * CROSSBAR_HEIGHT;
+    /** The number of words in the memory vector */
+    constexpr size_t MEMORY_SIZE = NUM_CROSSBARS * CROSSBAR_SIZE;
 
-    /** The latest crossbar mask */
-    RangeMask crossbarMask = {0, NUM_CROSSBARS - 1, 1};
-    /** The latest row mask */
-    RangeMask rowMask = {0, CROSSBAR_HEIGHT - 1, 1};
+    /**
+     * The memory state of the owned crossbars (words, or bit-plane words), indexed by the addresses of the global
+     * crossbars: the index of the first owned crossbar is subtracted at every access (rather than from the pointer,
+     * which would point outside of the allocation)
+     */
+    template <class W>
+    struct MemoryView {
+
+        /** The words of the first owned crossbar */
+        W *data;
+
+        /** The index of the first owned word */
+        size_t offset;
+
+        __forceinline__ __host__ __device__ W& operator[](size_t index) const{
+            return data[index - offset];
+        }
+
+        /** The view is also a view of constant words */
+        __forceinline__ __host__ __device__ operator MemoryView<const W>() const{
+            return {data, offset};
+        }
+
+    };
+
+    /** The crossbars owned by this process (all crossbars, unless the process is a shard worker) */
+    size_t firstOwnedCrossbar = 0, numOwnedCrossbars = NUM_CROSSBARS;
+
+    /** Represents the current memory state (allocated on the first micro-operation that is not a dry run) */
+    thrust::device_vector<dtype> memory;
+    /** The memory state when it is mapped from a file (device-accessible pointer, null otherwise) */
+    dtype *mappedMemory = nullptr;
+    /** The host mapping of the memory file, its length, and whether the memory state was registered with CUDA */
+    uint8_t *mappedFile = nullptr;
+    size_t mappedFileLength = 0;
+    bool mappedRegistered = false;
+    /** The storage engine that the memory state is currently stored in */
+    StorageEngine storageEngine = StorageEngine::WORDS;
+    /** The result of a read from the bit-plane storage (device memory) */
+    thrust::device_vector<dtype> d_readResult(1);
+
+    /** The current simulation backend */
+    Backend backend = Backend::GATE_LEVEL;
+    /** The sampling period of the functional backend (0 disables sampling) */
+    size_t samplingPeriod = 0;
+
+    /** The value returned by read micro-operations in the dry-run backend */
+    dtype readPlaceholder = 0;
+    /** The micro-operation counts of the dry-run backend */
+    DryRunStatistics dryRunStatistics = {};
+
+    /** The execution statistics of every routine */
+    std::map<std::string, RoutineStatistics> statistics;
+    /** The native results of the current sampled routine (device memory) */
+    thrust::device_vector<dtype> d_sampleBuffer;
+    /** Whether the native results of the current sampled routine are defined, for every row (device memory) */
+    thrust::device_vector<uint8_t> d_sampleDefined;
+    /** The number of mismatches found when verifying a sampled routine (device memory) */
+    thrust::device_vector<unsigned long long> d_mismatches(1);
+
+    /**
+     * A crossbar saved by copy-before-write, stored in a buffer that is shared by the snapshots it belongs to
+     */
+    struct SavedCrossbar {
+        std::shared_ptr<thrust::device_vector<dtype>> buffer;
+        size_t offset;
+    };
+
+    /**
+     * A memory snapshot, holding the crossbars that were modified since the snapshot was taken
+     */
+    struct Snapshot {
+        size_t epoch;
+        StorageEngine engine;
+        std::map<size_t, SavedCrossbar> crossbars;
+    };
+
+    /** The live snapshots (by handle, which is also the epoch of the snapshot) */
+    std::map<size_t, Snapshot> snapshots;
+    /** The epoch of the latest snapshot */
+    size_t snapshotEpoch = 0;
+    /** The epoch at which every crossbar was last saved */
+    std::vector<size_t> savedEpoch;
+
+    /** Whether a graph is currently captured, and the graph */
+    bool capturing = false;
+    Graph capturedGraph;
+
+    /**
+     * The simulator state of an execution context (see pim/context.h)
+     */
+    struct SimulatorContext {
+
+        /** The crossbars owned by the context */
+        RangeMask crossbars;
+
+        /** The latest crossbar mask and row mask */
+        RangeMask crossbarMask, rowMask;
+
+        /** Represents the buffer of logic operations, the current index in it, and whether it contains a vertical
+         * logic operation */
+        thrust::host_vector<otype> logicBuffer;
+        size_t logicBufferIdx;
+        bool logicBufferVertical;
+        /** Represents the buffer of logic operations (device memory) */
+        thrust::device_vector<otype> d_logicBuffer;
+
+        /** The stream that the kernels of the context are launched on (the default stream for the process context),
+         * so that the batches of contexts of disjoint crossbars may execute concurrently */
+        cudaStream_t stream;
+
+        /** The number of cycles issued by the context, and the cycle at which its latest micro-operation completes */
+        size_t issuedCycles, queueCycles;
+
+        /** The current routine, and its statistics (null outside of routines) */
+        Routine currRoutine;
+        RoutineStatistics *currStatistics;
+        /** Whether the current routine is executed natively (functional backend), whether it is a sampled call, and
+         * whether the native results of the sampled call were computed */
+        bool currNative, currSampled, currSampleComputed;
+
+        SimulatorContext(RangeMask crossbars, bool process) : crossbars(crossbars), crossbarMask(crossbars),
+                rowMask(0, CROSSBAR_HEIGHT - 1, 1), logicBuffer(SIM_LOGIC_BUFFER_SIZE), logicBufferIdx(0),
+                logicBufferVertical(false), d_logicBuffer(SIM_LOGIC_BUFFER_SIZE), stream(0), issuedCycles(0),
+                queueCycles(0), currRoutine({"", NativeOperation::NONE, false, 0, 0, 0}), currStatistics(nullptr),
+                currNative(false), currSampled(false), currSampleComputed(false) {
+            if(!process) cudaStreamCreate(&stream);
+        }
+
+        ~SimulatorContext(){
+            if(stream) cudaStreamDestroy(stream);
+        }
+
+    };
+    /** The state of the process context, and the states of the other contexts (by handle) */
+    SimulatorContext processSimulatorContext({0, NUM_CROSSBARS - 1, 1}, true);
+    std::map<size_t, std::unique_ptr<SimulatorContext>> simulatorContexts;
+    /** The handle of the latest created context */
+    size_t lastContextHandle = 0;
+    /** The state of the current context of the thread */
+    thread_local SimulatorContext *currContext = &processSimulatorContext;
+
+    /** Serializes the simulator functions across the threads of the contexts (recursive, as they call each other) */
+    std::recursive_mutex simulatorMutex;
+
+    /** The cycle at which the latest micro-operation of the process context completes (as the process context owns
+     * all crossbars, its micro-operations wait for those of the other contexts), and the elapsed cycles */
+    size_t barrierCycles = 0, elapsedCycles = 0;
+
+    /** The number of streaming multiprocessors of the device (0 until queried) */
+    size_t numMultiprocessors = 0;
+
+    /**
+     * Returns whether the memory state is allocated (or mapped)
+     * @return
+     */
+    bool memoryAllocated(){
+        return mappedMemory || !memory.empty();
+    }
+
+    /**
+     * Allocates the memory state (initialized to zero) if it is not allocated yet
+     */
+    void allocateMemory(){
+        if(!memoryAllocated()) memory.resize(numOwnedCrossbars * CROSSBAR_SIZE, 0);
+    }
+
+    /**
+     * Returns a device pointer to the words of the owned crossbars
+     * @return
+     */
+    dtype *ownedMemory(){
+        return mappedMemory ? mappedMemory : thrust::raw_pointer_cast(memory.data());
+    }
+
+    /**
+     * Returns the memory state of the device (the memory of a shard worker only holds its own crossbars, and is indexed
+     * by the global crossbars)
+     * @return
+     */
+    MemoryView<dtype> memoryData(){
+        return {ownedMemory(), firstOwnedCrossbar * CROSSBAR_SIZE};
+    }
+
+    /**
+     * Returns the memory state of the device in the bit-plane storage engine
+     * @return
+     */
+    MemoryView<ptype> planesData(){
+        return {reinterpret_cast<ptype *>(ownedMemory()),
+                firstOwnedCrossbar * CROSSBAR_SIZE * (size_t)sizeof(dtype) / (size_t)sizeof(ptype)};
+    }
 
-    /** Represents the buffer of logic operations */
-    thrust::host_vector<otype> logicBuffer(SIM_LOGIC_BUFFER_SIZE);
-    /** Represents the buffer of logic operations (device memory) */
-    thrust::device_vector<otype> d_logicBuffer(SIM_LOGIC_BUFFER_SIZE);
-    /** The current index in the logic buffer */
-    size_t logicBufferIdx = 0;
+    /**
+     * Returns a thrust device pointer to the given word of the memory state (indexed by the global crossbars)
+     * @param index
+     * @return
+     */
+    thrust::device_ptr<dtype> memoryAt(size_t index){
+        return thrust::device_pointer_cast(ownedMemory()) + (index - firstOwnedCrossbar * CROSSBAR_SIZE);
+    }
 
     /**
      * Maps the given address to the address in the memory vector
@@ -34,7 +256,13 @@ namespace pim {
      * @return
      */
     __forceinline__ __host__ __device__ size_t mapAddress(size_t crossbar, size_t index, size_t row){
+#ifdef ROW_INTERLEAVED
+        // Layout [crossbar][row][register]: the registers of a row share cache lines
+        return crossbar * CROSSBAR_HEIGHT * CROSSBAR_R + row * CROSSBAR_R + index;
+#else
+        // Layout [crossbar][register][row]: consecutive rows of a register are contiguous
         return crossbar * CROSSBAR_R * CROSSBAR_HEIGHT + index * CROSSBAR_HEIGHT + row;
+#endif
     }
 
     /**
@@ -48,6 +276,190 @@ namespace pim {
         return ((((uint64_t)(1) << ((stop - start) + step)) - 1) / ((1 << step) - 1)) << start;
     }
 
+    /**
+     * Represents a decoded horizontal logic operation
+     */
+    struct HorizontalOperation {
+
+        /** The registers of input A, input B and the output */
+        size_t inA, inB, out;
+
+        /** The shift aligning input B to input A, and the shift aligning input A to the output */
+        size_t shiftB, shiftOut;
+
+        /** The mask of the partitions containing an output */
+        dtype outputMask;
+
+    };
+
+    /**
+     * Shifts the given word left by the given (possibly negative) distance
+     * @param x
+     * @param distance
+     * @return
+     */
+    __forceinline__ __device__ dtype shiftWord(dtype x, size_t distance){
+        return distance >= 0 ? x << distance : x >> (-distance);
+    }
+
+    /**
+     * Computes the new value of an output word for the given horizontal gate.
+     * Equivalent to (~outputMask & old) | (outputMask & (gate(a, b) & old)).
+     * @tparam gateType
+     * @param a
+     * @param b
+     * @param old
+     * @param op
+     * @return
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ dtype horizontalGate(dtype a, dtype b, dtype old, const HorizontalOperation& op){
+        if (gateType == GateType::INIT0) {
+            return old & ~op.outputMask;
+        } else if (gateType == GateType::INIT1) {
+            return old | op.outputMask;
+        } else if (gateType == GateType::NOT) {
+            return old & (shiftWord(~a, op.shiftOut) | ~op.outputMask);
+        } else {
+            return old & (shiftWord(~(a | (b >> op.shiftB)), op.shiftOut) | ~op.outputMask);
+        }
+    }
+
+    /**
+     * Performs the given horizontal gate on a single row
+     * @tparam gateType
+     * @param crossbar
+     * @param row
+     * @param op
+     * @param memory_ptr
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ void horizontalRow(size_t crossbar, size_t row, const HorizontalOperation& op, MemoryView<dtype> memory_ptr){
+        dtype a = 0, b = 0;
+        if (gateType == GateType::NOT || gateType == GateType::NOR) a = memory_ptr[mapAddress(crossbar, op.inA, row)];
+        if (gateType == GateType::NOR) b = memory_ptr[mapAddress(crossbar, op.inB, row)];
+        dtype *out = &memory_ptr[mapAddress(crossbar, op.out, row)];
+        *out = horizontalGate<gateType>(a, b, *out, op);
+    }
+
+    /**
+     * Performs the given horizontal gate on four contiguous rows (aligned to four rows) using 128-bit accesses
+     * @tparam gateType
+     * @param crossbar
+     * @param row
+     * @param op
+     * @param memory_ptr
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ void horizontalQuad(size_t crossbar, size_t row, const HorizontalOperation& op, MemoryView<dtype> memory_ptr){
+        uint4 va = {0, 0, 0, 0}, vb = {0, 0, 0, 0};
+        if (gateType == GateType::NOT || gateType == GateType::NOR) va = *reinterpret_cast<const uint4 *>(&memory_ptr[mapAddress(crossbar, op.inA, row)]);
+        if (gateType == GateType::NOR) vb = *reinterpret_cast<const uint4 *>(&memory_ptr[mapAddress(crossbar, op.inB, row)]);
+        uint4 *out = reinterpret_cast<uint4 *>(&memory_ptr[mapAddress(crossbar, op.out, row)]);
+        uint4 vOut = *out;
+        vOut.x = horizontalGate<gateType>(va.x, vb.x, vOut.x, op);
+        vOut.y = horizontalGate<gateType>(va.y, vb.y, vOut.y, op);
+        vOut.z = horizontalGate<gateType>(va.z, vb.z, vOut.z, op);
+        vOut.w = horizontalGate<gateType>(va.w, vb.w, vOut.w, op);
+        *out = vOut;
+    }
+
+    /**
+     * Performs the given horizontal gate on a strided set of rows (one row per thread per iteration)
+     * @tparam gateType
+     * @param crossbar
+     * @param currRowMask
+     * @param op
+     * @param memory_ptr
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ void horizontalStrided(size_t crossbar, RangeMask currRowMask, const HorizontalOperation& op, MemoryView<dtype> memory_ptr){
+        for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
+            horizontalRow<gateType>(crossbar, currRowMask.start + i * currRowMask.step, op, memory_ptr);
+        }
+    }
+
+    /**
+     * Performs the given horizontal gate on a contiguous set of rows. As consecutive rows of a register are contiguous
+     * in the memory, the aligned body is processed four rows at a time using 128-bit accesses.
+     * @tparam gateType
+     * @param crossbar
+     * @param currRowMask
+     * @param op
+     * @param memory_ptr
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ void horizontalContiguous(size_t crossbar, RangeMask currRowMask, const HorizontalOperation& op, MemoryView<dtype> memory_ptr){
+#ifdef ROW_INTERLEAVED
+        horizontalStrided<gateType>(crossbar, currRowMask, op, memory_ptr);
+#else
+        // The aligned body [alignedStart, alignedStop) and the unaligned head and tail
+        size_t alignedStart = (currRowMask.start + 3) & ~(size_t)3;
+        size_t alignedStop = (currRowMask.stop + 1) & ~(size_t)3;
+        if(alignedStart >= alignedStop){
+            horizontalStrided<gateType>(crossbar, currRowMask, op, memory_ptr);
+            return;
+        }
+        if(currRowMask.start + threadIdx.x < alignedStart){
+            horizontalRow<gateType>(crossbar, currRowMask.start + threadIdx.x, op, memory_ptr);
+        }
+        if(alignedStop + threadIdx.x <= currRowMask.stop){
+            horizontalRow<gateType>(crossbar, alignedStop + threadIdx.x, op, memory_ptr);
+        }
+
+        // Vectorized body
+        for(size_t i = threadIdx.x; i < (alignedStop - alignedStart) / 4; i += blockDim.x){
+            horizontalQuad<gateType>(crossbar, alignedStart + 4 * i, op, memory_ptr);
+        }
+#endif
+    }
+
+    /**
+     * Performs the given horizontal gate on the activated rows, dispatching according to the row mask
+     * @tparam gateType
+     * @param crossbar
+     * @param currRowMask
+     * @param op
+     * @param memory_ptr
+     */
+    template <GateType gateType>
+    __forceinline__ __device__ void horizontal(size_t crossbar, RangeMask currRowMask, const HorizontalOperation& op, MemoryView<dtype> memory_ptr){
+        if(currRowMask.step == 1) horizontalContiguous<gateType>(crossbar, currRowMask, op, memory_ptr);
+        else horizontalStrided<gateType>(crossbar, currRowMask, op, memory_ptr);
+    }
+
+    /**
+     * Decodes the given horizontal logic operation (without the vertical flag)
+     * @param operation
+     * @param gateType set to the gate type of the operation
+     * @return
+     */
+    __forceinline__ __device__ HorizontalOperation decodeHorizontal(otype operation, size_t& gateType){
+
+        // Gate type
+        gateType = operation & 0x3; operation >>= 2;
+
+        // Input A (intra-partition and partition address)
+        size_t inA = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+        size_t pA = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
+
+        // Input B (intra-partition and partition address)
+        size_t inB = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+        size_t pB = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
+
+        // Output (intra-partition and partition address)
+        size_t out = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+        size_t pOut = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
+
+        // The pattern for the opcode repetition
+        size_t pEnd = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
+        size_t pStep = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
+
+        // Construct a mask corresponding to the partitions containing an output
+        return {inA, inB, out, pB - pA, pOut - pA, genBitwiseMask(pOut, pEnd, pStep)};
+
+    }
+
     /**
      * CUDA kernel that performs the given logic operations.
      * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars).
@@ -57,11 +469,162 @@ namespace pim {
      * @param currRowMask
      * @param memory_ptr
      */
-    __global__ void __logic(const otype *operations, size_t numOperations, RangeMask currCrossbarMask, RangeMask currRowMask, dtype *memory_ptr){
+    __global__ void __logic(const otype *operations, size_t numOperations, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<dtype> memory_ptr){
+
+        // Each block represents a single *active* crossbar
+        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
+
+        // Iterate over the operations in the buffer
+        for(size_t operationIdx = 0; operationIdx < numOperations; operationIdx++){
+            otype operation = operations[operationIdx];
+
+            // Parse the operation
+            if(operation & 0x1){ // Vertical logic operation
+                operation >>= 1;
+
+                // Gate type
+                size_t gateType = operation & 0x3; operation >>= 2;
+
+                // Input row
+                size_t input = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+                // Output row
+                size_t output = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+                // Index
+                size_t index = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+
+                // Perform the operation (a single thread, as the rows may be accessed by other threads)
+                if(threadIdx.x == 0) {
+                    if (gateType == GateType::INIT0) {
+                        memory_ptr[mapAddress(crossbar, index, output)] = 0;
+                    } else if (gateType == GateType::INIT1) {
+                        memory_ptr[mapAddress(crossbar, index, output)] = 0xFFFFFFFF;
+                    } else if (gateType == GateType::NOT) {
+                        memory_ptr[mapAddress(crossbar, index, output)] = memory_ptr[mapAddress(crossbar, index, output)] &
+                                (~memory_ptr[mapAddress(crossbar, index, input)]);
+                    }
+                }
+                __syncthreads();
+
+            } else{ // Horizontal logic operation
+
+                size_t gateType;
+                HorizontalOperation op = decodeHorizontal(operation >> 1, gateType);
+
+                // Perform the operation on the activated rows
+                switch (gateType) {
+                    case GateType::INIT0: horizontal<GateType::INIT0>(crossbar, currRowMask, op, memory_ptr); break;
+                    case GateType::INIT1: horizontal<GateType::INIT1>(crossbar, currRowMask, op, memory_ptr); break;
+                    case GateType::NOT: horizontal<GateType::NOT>(crossbar, currRowMask, op, memory_ptr); break;
+                    case GateType::NOR: horizontal<GateType::NOR>(crossbar, currRowMask, op, memory_ptr); break;
+                }
+                __syncthreads();
+
+            }
+
+        }
+
+    }
+
+    /**
+     * CUDA kernel that performs the given horizontal logic operations, which only access their own rows.
+     * The active (crossbar, row) pairs are flattened into units of a single row (or of four contiguous rows), and each
+     * thread performs all of the operations on its unit, without synchronizing with the other threads.
+     * @param operations
+     * @param numOperations
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param rowsPerUnit the number of rows per unit (1, or 4 for a contiguous row mask aligned to four rows)
+     * @param numUnits
+     * @param memory_ptr
+     */
+    __global__ void __logicRows(const otype *operations, size_t numOperations, RangeMask currCrossbarMask, RangeMask currRowMask,
+                                size_t rowsPerUnit, size_t numUnits, MemoryView<dtype> memory_ptr){
+
+        // The operations are shared by all of the threads of the block
+        __shared__ otype sharedOperations[SIM_LOGIC_BUFFER_SIZE];
+        for(size_t i = threadIdx.x; i < numOperations; i += blockDim.x) sharedOperations[i] = operations[i];
+        __syncthreads();
+
+        // Each thread represents a single unit
+        size_t unit = blockIdx.x * blockDim.x + threadIdx.x;
+        if(unit >= numUnits) return;
+        size_t unitsPerCrossbar = ((currRowMask.stop - currRowMask.start) / currRowMask.step + 1) / rowsPerUnit;
+        size_t crossbar = currCrossbarMask.start + (unit / unitsPerCrossbar) * currCrossbarMask.step;
+        size_t row = currRowMask.start + (unit % unitsPerCrossbar) * rowsPerUnit * currRowMask.step;
+
+        for(size_t operationIdx = 0; operationIdx < numOperations; operationIdx++){
+
+            size_t gateType;
+            HorizontalOperation op = decodeHorizontal(sharedOperations[operationIdx] >> 1, gateType);
+
+            if(rowsPerUnit == 4){
+                switch (gateType) {
+                    case GateType::INIT0: horizontalQuad<GateType::INIT0>(crossbar, row, op, memory_ptr); break;
+                    case GateType::INIT1: horizontalQuad<GateType::INIT1>(crossbar, row, op, memory_ptr); break;
+                    case GateType::NOT: horizontalQuad<GateType::NOT>(crossbar, row, op, memory_ptr); break;
+                    case GateType::NOR: horizontalQuad<GateType::NOR>(crossbar, row, op, memory_ptr); break;
+                }
+            }
+            else{
+                switch (gateType) {
+                    case GateType::INIT0: horizontalRow<GateType::INIT0>(crossbar, row, op, memory_ptr); break;
+                    case GateType::INIT1: horizontalRow<GateType::INIT1>(crossbar, row, op, memory_ptr); break;
+                    case GateType::NOT: horizontalRow<GateType::NOT>(crossbar, row, op, memory_ptr); break;
+                    case GateType::NOR: horizontalRow<GateType::NOR>(crossbar, row, op, memory_ptr); break;
+                }
+            }
+
+        }
+
+    }
+
+    /**
+     * Maps the given address to the address of a bit-plane word in the memory vector (bit-plane storage engine)
+     * @param crossbar
+     * @param index
+     * @param partition
+     * @param word
+     * @return
+     */
+    __forceinline__ __host__ __device__ size_t mapPlane(size_t crossbar, size_t index, size_t partition, size_t word){
+        return ((crossbar * CROSSBAR_R + index) * CROSSBAR_N + partition) * PLANE_WORDS + word;
+    }
+
+    /**
+     * Generates the bit-plane word of the rows in [word * PLANE_ROWS, (word + 1) * PLANE_ROWS) that belong to the mask
+     * @param mask
+     * @param word
+     * @return
+     */
+    __forceinline__ __device__ ptype genPlaneMask(RangeMask mask, size_t word){
+        ptype res = 0;
+        for(size_t bit = 0; bit < PLANE_ROWS; bit++){
+            size_t row = word * PLANE_ROWS + bit;
+            if(row >= mask.start && row <= mask.stop && (row - mask.start) % mask.step == 0) res |= (ptype)(1) << bit;
+        }
+        return res;
+    }
+
+    /**
+     * CUDA kernel that performs the given logic operations (bit-plane storage engine).
+     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars), and each thread
+     * represents a single (partition, word) pair of the bit-planes.
+     * @param operations
+     * @param numOperations
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param planes_ptr
+     */
+    __global__ void __logicBitplane(const otype *operations, size_t numOperations, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<ptype> planes_ptr){
 
         // Each block represents a single *active* crossbar
         size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
 
+        // Each thread represents a single (partition, word) pair
+        size_t partition = threadIdx.x / PLANE_WORDS;
+        size_t word = threadIdx.x % PLANE_WORDS;
+        ptype rowWord = genPlaneMask(currRowMask, word);
+
         // Iterate over the operations in the buffer
         for(size_t operationIdx = 0; operationIdx < numOperations; operationIdx++){
             otype operation = operations[operationIdx];
@@ -80,15 +643,19 @@ namespace pim {
                 // Index
                 size_t index = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
 
-                // Perform the operation
-                if (gateType == GateType::INIT0) {
-                    memory_ptr[mapAddress(crossbar, index, output)] = 0;
-                } else if (gateType == GateType::INIT1) {
-                    memory_ptr[mapAddress(crossbar, index, output)] = 0xFFFFFFFF;
-                } else if (gateType == GateType::NOT) {
-                    memory_ptr[mapAddress(crossbar, index, output)] = memory_ptr[mapAddress(crossbar, index, output)] &
-                            (~memory_ptr[mapAddress(crossbar, index, input)]);
+                // Perform the operation (a single thread per partition)
+                if(threadIdx.x < CROSSBAR_N) {
+                    ptype &outWord = planes_ptr[mapPlane(crossbar, index, threadIdx.x, output / PLANE_ROWS)];
+                    ptype outBit = (ptype)(1) << (output % PLANE_ROWS);
+                    if (gateType == GateType::INIT0) {
+                        outWord &= ~outBit;
+                    } else if (gateType == GateType::INIT1) {
+                        outWord |= outBit;
+                    } else if (gateType == GateType::NOT) {
+                        if((planes_ptr[mapPlane(crossbar, index, threadIdx.x, input / PLANE_ROWS)] >> (input % PLANE_ROWS)) & 1) outWord &= ~outBit;
+                    }
                 }
+                __syncthreads();
 
             } else{ // Horizontal logic operation
                 operation >>= 1;
@@ -112,32 +679,31 @@ namespace pim {
                 size_t pEnd = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
                 size_t pStep = operation & CROSSBAR_N_MASK; operation >>= LOG_CROSSBAR_N;
 
-                // Construct a mask corresponding to the partitions containing an output
-                dtype outputMask = genBitwiseMask(pOut, pEnd, pStep);
-
-                // Iterate over the activated rows
-                for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
-                    size_t row = currRowMask.start + i * currRowMask.step;
+                // Whether the partition of the thread contains an output
+                bool active = partition >= pOut && partition <= pEnd && (partition - pOut) % pStep == 0;
 
-                    // Perform the operation
+                // Compute the new value of the output word (inputs are partitions aligned to the output partition,
+                // where partitions beyond the crossbar read as zero)
+                ptype newVal = 0;
+                if(active) {
+                    size_t partitionA = partition - pOut + pA;
+                    size_t partitionB = partition - pOut + pB;
+                    ptype oldVal = planes_ptr[mapPlane(crossbar, out, partition, word)];
                     if (gateType == GateType::INIT0) {
-                        memory_ptr[mapAddress(crossbar, out, row)] &= ~outputMask;
+                        newVal = oldVal & ~rowWord;
                     } else if (gateType == GateType::INIT1) {
-                        memory_ptr[mapAddress(crossbar, out, row)] |= outputMask;
-                    } else if (gateType == GateType::NOT) {
-                        dtype oldVal = memory_ptr[mapAddress(crossbar, out, row)];
-                        dtype newVal = ((pOut - pA) >= 0 ? (~memory_ptr[mapAddress(crossbar, inA, row)]) << (pOut - pA) :
-                                (~memory_ptr[mapAddress(crossbar, inA, row)]) >> (pA - pOut)) & oldVal;
-                        memory_ptr[mapAddress(crossbar, out, row)] = (~outputMask & oldVal) | (outputMask & newVal);
-                    } else if (gateType == GateType::NOR) {
-                        dtype oldVal = memory_ptr[mapAddress(crossbar, out, row)];
-                        dtype newVal = ((pOut - pA) >= 0 ?
-                                (~(memory_ptr[mapAddress(crossbar, inA, row)] | (memory_ptr[mapAddress(crossbar, inB, row)] >> (pB - pA)))) << (pOut - pA) :
-                                (~(memory_ptr[mapAddress(crossbar, inA, row)] | (memory_ptr[mapAddress(crossbar, inB, row)] >> (pB - pA)))) >> (pA - pOut)) & oldVal;
-                        memory_ptr[mapAddress(crossbar, out, row)] = (~outputMask & oldVal) | (outputMask & newVal);
+                        newVal = oldVal | rowWord;
+                    } else {
+                        ptype a = partitionA < CROSSBAR_N ? planes_ptr[mapPlane(crossbar, inA, partitionA, word)] : 0;
+                        ptype b = (gateType == GateType::NOR && partitionB < CROSSBAR_N) ? planes_ptr[mapPlane(crossbar, inB, partitionB, word)] : 0;
+                        ptype gate = partitionA < CROSSBAR_N ? ~(a | b) : 0;
+                        newVal = oldVal & (gate | ~rowWord);
                     }
-
                 }
+
+                // Write only once all threads read their inputs (the output may overlap the inputs)
+                __syncthreads();
+                if(active) planes_ptr[mapPlane(crossbar, out, partition, word)] = newVal;
                 __syncthreads();
 
             }
@@ -147,42 +713,247 @@ namespace pim {
     }
 
     /**
-     * Flushes the logic operations in the buffer
+     * CUDA kernel that reads a single row (bit-plane storage engine).
+     * A single warp in which each thread represents a single partition.
+     * @param crossbar
+     * @param index
+     * @param row
+     * @param planes_ptr
+     * @param result
+     */
+    __global__ void __readBitplane(size_t crossbar, size_t index, size_t row, MemoryView<const ptype> planes_ptr, dtype *result){
+        bool bit = (planes_ptr[mapPlane(crossbar, index, threadIdx.x, row / PLANE_ROWS)] >> (row % PLANE_ROWS)) & 1;
+        dtype value = __ballot_sync(0xFFFFFFFF, bit);
+        if(threadIdx.x == 0) *result = value;
+    }
+
+    /**
+     * CUDA kernel that writes to several rows (bit-plane storage engine).
+     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars), and each thread
+     * represents a single (partition, word) pair of the bit-planes.
+     * @param operation
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param planes_ptr
      */
-    void flushLogic(){
+    __global__ void __writeBitplane(otype operation, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<ptype> planes_ptr){
 
-        if(logicBufferIdx > 0){
+        // Each block represents a single *active* crossbar
+        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
 
-            // Allocate the kernel
-            size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
-            d_logicBuffer = logicBuffer;
-            __logic<<<activeCrossbars, SIM_THREADS_PER_BLOCK>>>(
-                    thrust::raw_pointer_cast(d_logicBuffer.data()), logicBufferIdx, crossbarMask, rowMask,
-                    thrust::raw_pointer_cast(memory.data()));
+        // Each thread represents a single (partition, word) pair
+        size_t partition = threadIdx.x / PLANE_WORDS;
+        size_t word = threadIdx.x % PLANE_WORDS;
+        ptype rowWord = genPlaneMask(currRowMask, word);
 
-        }
-        logicBufferIdx = 0;
+        // Index, data
+        size_t index = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+        dtype data = (dtype) operation;
+
+        // Perform the operation
+        ptype &planeWord = planes_ptr[mapPlane(crossbar, index, partition, word)];
+        planeWord = (planeWord & ~rowWord) | (((data >> partition) & 1) ? rowWord : 0);
 
     }
 
     /**
-     * Receives the given logic operation
-     * @param operation
+     * CUDA kernel that converts crossbars from the word storage to the bit-plane storage.
+     * Each CUDA block represents a single (crossbar, register) pair, and each thread a single row.
+     * @param firstCrossbar the first crossbar to convert
+     * @param memory_ptr the memory in the word storage
+     * @param output_ptr the output for the converted crossbars (relative to firstCrossbar)
      */
-    void logic(otype operation){
+    __global__ void __toBitplane(size_t firstCrossbar, MemoryView<const dtype> memory_ptr, dtype *output_ptr){
 
-        // Check for input correctness
-        otype operationCopy = operation;
-        if(operationCopy & 0x1){ // Vertical logic operation
-            operationCopy >>= 1;
+        size_t crossbar = blockIdx.x / CROSSBAR_R, index = blockIdx.x % CROSSBAR_R, row = threadIdx.x;
+        dtype value = memory_ptr[mapAddress(firstCrossbar + crossbar, index, row)];
 
-            // Gate type
-            size_t gateType = operationCopy & 0x3; operationCopy >>= 2;
+        // Each warp gathers the bits of its 32 rows for every partition (half a bit-plane word)
+        for(size_t partition = 0; partition < CROSSBAR_N; partition++){
+            dtype bits = __ballot_sync(0xFFFFFFFF, (value >> partition) & 1);
+            if(row % 32 == 0) {
+                output_ptr[mapPlane(crossbar, index, partition, row / PLANE_ROWS) * 2 + (row % PLANE_ROWS) / 32] = bits;
+            }
+        }
 
-            // Input row
-            size_t input = operationCopy & CROSSBAR_HEIGHT_MASK; operationCopy >>= LOG_CROSSBAR_HEIGHT;
-            // Output row
-            size_t output = operationCopy & CROSSBAR_HEIGHT_MASK; operationCopy >>= LOG_CROSSBAR_HEIGHT;
+    }
+
+    /**
+     * CUDA kernel that converts crossbars from the bit-plane storage to the word storage.
+     * Each CUDA block represents a single (crossbar, register) pair, and each thread a single row.
+     * @param firstCrossbar the first crossbar to convert
+     * @param planes_ptr the memory in the bit-plane storage
+     * @param output_ptr the output for the converted crossbars (relative to firstCrossbar)
+     */
+    __global__ void __fromBitplane(size_t firstCrossbar, MemoryView<const ptype> planes_ptr, dtype *output_ptr){
+
+        size_t crossbar = blockIdx.x / CROSSBAR_R, index = blockIdx.x % CROSSBAR_R, row = threadIdx.x;
+
+        dtype value = 0;
+        for(size_t partition = 0; partition < CROSSBAR_N; partition++){
+            value |= (dtype)((planes_ptr[mapPlane(firstCrossbar + crossbar, index, partition, row / PLANE_ROWS)] >> (row % PLANE_ROWS)) & 1) << partition;
+        }
+        output_ptr[mapAddress(crossbar, index, row)] = value;
+
+    }
+
+    /**
+     * Saves the given crossbars for every snapshot that does not hold them yet (copy-before-write)
+     * @param crossbars
+     */
+    void saveCrossbars(const std::vector<size_t>& crossbars){
+
+        // Only crossbars that were not saved since the latest snapshot are missing from some snapshot
+        std::vector<size_t> missing;
+        for(size_t crossbar : crossbars){
+            if(savedEpoch[crossbar] < snapshotEpoch) missing.push_back(crossbar);
+        }
+        if(missing.empty()) return;
+
+        auto buffer = std::make_shared<thrust::device_vector<dtype>>(missing.size() * CROSSBAR_SIZE);
+        for(size_t i = 0; i < (size_t)missing.size(); i++){
+            size_t crossbar = missing[i];
+            thrust::copy(memoryAt(crossbar * CROSSBAR_SIZE), memoryAt((crossbar + 1) * CROSSBAR_SIZE),
+                         buffer->begin() + i * CROSSBAR_SIZE);
+            for(auto it = snapshots.upper_bound(savedEpoch[crossbar]); it != snapshots.end(); it++){
+                it->second.crossbars[crossbar] = {buffer, i * CROSSBAR_SIZE};
+            }
+            savedEpoch[crossbar] = snapshotEpoch;
+        }
+
+    }
+
+    /**
+     * Saves the crossbars of the given mask before they are modified, if there are live snapshots
+     * @param mask
+     */
+    void beforeWrite(RangeMask mask){
+
+        if(snapshots.empty()) return;
+
+        std::vector<size_t> crossbars;
+        for(size_t crossbar = mask.start; crossbar <= mask.stop; crossbar += mask.step){
+            if(savedEpoch[crossbar] < snapshotEpoch) crossbars.push_back(crossbar);
+        }
+        saveCrossbars(crossbars);
+
+    }
+
+    /**
+     * Accounts the given number of cycles to the issue queue of the current context. The queues of the contexts proceed
+     * concurrently, while the queue of the process context (which owns all crossbars) waits for all of them.
+     * @param cycles
+     */
+    void issueCycles(size_t cycles){
+        currContext->issuedCycles += cycles;
+        if(currContext == &processSimulatorContext){
+            barrierCycles = elapsedCycles + cycles;
+            elapsedCycles = barrierCycles;
+        }
+        else{
+            currContext->queueCycles = std::max(currContext->queueCycles, barrierCycles) + cycles;
+            elapsedCycles = std::max(elapsedCycles, currContext->queueCycles);
+        }
+    }
+
+    /**
+     * Flushes the logic operations in the buffer of the given context
+     * @param ctx
+     */
+    void flushContext(SimulatorContext& ctx){
+
+        const RangeMask& crossbarMask = ctx.crossbarMask;
+        const RangeMask& rowMask = ctx.rowMask;
+        if(ctx.logicBufferIdx > 0){
+
+            // Allocate the kernel
+            size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
+            beforeWrite(crossbarMask);
+            otype *operations = thrust::raw_pointer_cast(ctx.d_logicBuffer.data());
+            cudaMemcpyAsync(operations, thrust::raw_pointer_cast(ctx.logicBuffer.data()),
+                            ctx.logicBufferIdx * sizeof(otype), cudaMemcpyHostToDevice, ctx.stream);
+            if(storageEngine == StorageEngine::BITPLANES) {
+                __logicBitplane<<<activeCrossbars, SIM_PLANE_THREADS_PER_BLOCK, 0, ctx.stream>>>(
+                        operations, ctx.logicBufferIdx, crossbarMask, rowMask, planesData());
+            }
+            else if(ctx.logicBufferVertical) {
+                __logic<<<activeCrossbars, SIM_THREADS_PER_BLOCK, 0, ctx.stream>>>(
+                        operations, ctx.logicBufferIdx, crossbarMask, rowMask, memoryData());
+            }
+            else {
+                // Horizontal operations are independent across rows, so the work is split into (crossbar, row) units
+                size_t activeRows = (rowMask.stop - rowMask.start) / rowMask.step + 1;
+                size_t rowsPerUnit = 1;
+#ifndef ROW_INTERLEAVED
+                // Four contiguous rows per unit, unless it leaves too few units to occupy the device
+                if(rowMask.step == 1 && rowMask.start % 4 == 0 && activeRows % 4 == 0 &&
+                   activeCrossbars * activeRows / 4 >= SIM_VECTOR_UNITS) rowsPerUnit = 4;
+#endif
+                size_t numUnits = activeCrossbars * activeRows / rowsPerUnit;
+
+                // Small launches use smaller blocks, so that they are spread over the multiprocessors
+                if(numMultiprocessors == 0){
+                    int count = 0, device = 0;
+                    cudaGetDevice(&device);
+                    cudaDeviceGetAttribute(&count, cudaDevAttrMultiProcessorCount, device);
+                    numMultiprocessors = std::max(count, 1);
+                }
+                size_t threads = (numUnits + numMultiprocessors - 1) / numMultiprocessors;
+                threads = std::min(std::max((threads + 31) / 32 * 32, (size_t)32), SIM_THREADS_PER_BLOCK);
+
+                __logicRows<<<(numUnits + threads - 1) / threads, threads, 0, ctx.stream>>>(
+                        operations, ctx.logicBufferIdx, crossbarMask, rowMask, rowsPerUnit, numUnits, memoryData());
+            }
+
+        }
+        ctx.logicBufferIdx = 0;
+        ctx.logicBufferVertical = false;
+
+    }
+
+    /**
+     * Flushes the logic operations in the buffer of the current context
+     */
+    void flushLogic(){
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        flushContext(*currContext);
+    }
+
+    /**
+     * Flushes the logic operations in the buffers of all contexts (before accessing the entire memory state)
+     */
+    void flushContexts(){
+        flushContext(processSimulatorContext);
+        for(auto& ctx : simulatorContexts) flushContext(*ctx.second);
+    }
+
+    /**
+     * Adds the given (validated) logic operation to the buffer
+     * @param operation
+     */
+    void bufferLogic(otype operation){
+        currContext->logicBuffer[currContext->logicBufferIdx++] = operation;
+        currContext->logicBufferVertical |= (operation & 0x1) != 0;
+        if(currContext->logicBufferIdx == SIM_LOGIC_BUFFER_SIZE) flushLogic();
+    }
+
+    /**
+     * Verifies that the given logic operation is valid
+     * @param operation
+     */
+    void validateLogic(otype operation){
+
+        otype operationCopy = operation;
+        if(operationCopy & 0x1){ // Vertical logic operation
+            operationCopy >>= 1;
+
+            // Gate type
+            size_t gateType = operationCopy & 0x3; operationCopy >>= 2;
+
+            // Input row
+            size_t input = operationCopy & CROSSBAR_HEIGHT_MASK; operationCopy >>= LOG_CROSSBAR_HEIGHT;
+            // Output row
+            size_t output = operationCopy & CROSSBAR_HEIGHT_MASK; operationCopy >>= LOG_CROSSBAR_HEIGHT;
             // Index
             size_t index = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
 
@@ -206,235 +977,1234 @@ namespace pim {
         } else{ // Horizontal logic operation
             operationCopy >>= 1;
 
-            // Gate type
-            size_t gateType = operationCopy & 0x3; operationCopy >>= 2;
+            // Gate type
+            size_t gateType = operationCopy & 0x3; operationCopy >>= 2;
+
+            // Input A (intra-partition and partition address)
+            size_t inA = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
+            size_t pA = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+
+            // Input B (intra-partition and partition address)
+            size_t inB = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
+            size_t pB = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+
+            // Output (intra-partition and partition address)
+            size_t out = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
+            size_t pOut = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+
+            // The pattern for the opcode repetition
+            size_t pEnd = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+            size_t pStep = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+
+            if(gateType != GateType::INIT0 && gateType != GateType::INIT1 && gateType != GateType::NOT && gateType != GateType::NOR){
+                throw std::runtime_error("Logic operation: invalid gate type.");
+            }
+            if(inA < 0 || inA >= CROSSBAR_R ||
+               pA < 0 || pA >= CROSSBAR_N){
+                throw std::runtime_error("Logic operation: invalid input A.");
+            }
+            if(inB < 0 || inB >= CROSSBAR_R ||
+               pB < 0 || pB >= CROSSBAR_N){
+                throw std::runtime_error("Logic operation: invalid input B.");
+            }
+            if(out < 0 || out >= CROSSBAR_R ||
+               pOut < 0 || pOut >= CROSSBAR_N){
+                throw std::runtime_error("Logic operation: invalid output.");
+            }
+            if(pEnd < pOut || pEnd >= CROSSBAR_N ||
+                    pStep <= 0 || (pEnd - pOut) % pStep != 0){
+                throw std::runtime_error("Logic operation: invalid pattern.");
+            }
+            if(pA > pB){
+                throw std::runtime_error("Logic operation: the partition of input A should be to the left of that of input B.");
+            }
+
+        }
+
+    }
+
+    /**
+     * Receives the given logic operation
+     * @param operation
+     */
+    void logic(otype operation){
+
+        validateLogic(operation);
+        bufferLogic(operation);
+
+    }
+
+    /**
+     * Sets the current crossbar mask
+     * @param operation
+     */
+    void setCrossbarMask(otype operation){
+
+        // Start, stop, step
+        size_t start = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
+        size_t stop = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
+        size_t step = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
+
+        // Check for input correctness
+        if(start < 0 || start >= NUM_CROSSBARS){
+            throw std::runtime_error("Set Crossbar Mask: invalid crossbar start.");
+        }
+        if(stop < 0 || stop >= NUM_CROSSBARS){
+            throw std::runtime_error("Set Crossbar Mask: invalid crossbar stop.");
+        }
+        if(start > stop || step <= 0 || (stop - start) % step != 0){
+            throw std::runtime_error("Set Crossbar Mask: invalid crossbar mask.");
+        }
+        if(start < firstOwnedCrossbar || stop >= firstOwnedCrossbar + numOwnedCrossbars){
+            throw std::runtime_error("Set Crossbar Mask: the crossbars are not owned by this shard.");
+        }
+        if(start < currContext->crossbars.start || stop > currContext->crossbars.stop){
+            throw std::runtime_error("Set Crossbar Mask: the crossbars are not owned by the current context.");
+        }
+
+#ifdef VERBOSE
+        std::cerr << "Simulator: CrossbarMask(" << start << ", " << stop << ", " << step << ")" << std::endl;
+#endif
+
+        flushLogic();
+        currContext->crossbarMask = {start, stop, step};
+    }
+
+    /**
+     * Sets the current row mask
+     * @param operation
+     */
+    void setRowMask(otype operation){
+
+        // Start, stop, step
+        size_t start = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+        size_t stop = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+        size_t step = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+
+        // Check for input correctness
+        if(start < 0 || start >= CROSSBAR_HEIGHT){
+            throw std::runtime_error("Set Row Mask: invalid row start.");
+        }
+        if(stop < 0 || stop >= CROSSBAR_HEIGHT){
+            throw std::runtime_error("Set Row Mask: invalid row stop.");
+        }
+        if(start > stop || step <= 0 || (stop - start) % step != 0){
+            throw std::runtime_error("Set Row Mask: invalid row mask.");
+        }
+
+#ifdef VERBOSE
+        std::cerr << "Simulator: RowMask(" << start << ", " << stop << ", " << step << ")" << std::endl;
+#endif
+
+        flushLogic();
+        currContext->rowMask = {start, stop, step};
+    }
+
+    /**
+     * Performs a mask operation
+     * @param operation
+     */
+    void mask(otype operation){
+
+        if(operation & 0x1){
+            setRowMask(operation >> 1);
+        }
+        else{
+            setCrossbarMask(operation >> 1);
+        }
+
+    }
+
+    /**
+     * Verifies that the given read operation is valid
+     * @param operation
+     */
+    void validateRead(otype operation){
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        // Index
+        size_t index = (size_t)operation;
+
+        // Verify that only a single row in a single crossbar is selected
+        if((crossbarMask.start != crossbarMask.stop) || (rowMask.start != rowMask.stop)){
+            throw std::runtime_error("Read operation: multiple rows selected.");
+        }
+
+        // Verify that a valid index is provided
+        if(index < 0 || index >= CROSSBAR_N){
+            throw std::runtime_error("Read operation: invalid index.");
+        }
+
+#ifdef VERBOSE
+        std::cerr << "Simulator: Read(" << index << ")" << std::endl;
+#endif
+
+    }
+
+    /**
+    * Performs a read operation
+    * @param operation
+    * @return
+    */
+    dtype read(otype operation) {
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        validateRead(operation);
+        size_t index = (size_t)operation;
+
+        // Access the selected row
+        flushLogic();
+        if(storageEngine == StorageEngine::BITPLANES){
+            __readBitplane<<<1, CROSSBAR_N>>>(crossbarMask.start, index, rowMask.start,
+                    planesData(), thrust::raw_pointer_cast(d_readResult.data()));
+            return d_readResult[0];
+        }
+        return *memoryAt(mapAddress(crossbarMask.start, index, rowMask.start));
+    }
+
+    /**
+     * CUDA kernel that writes to several rows
+     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars).
+     * @param operation
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param memory_ptr
+     */
+    __global__ void __writeMulti(otype operation, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<dtype> memory_ptr){
+
+        // Each block represents a single *active* crossbar
+        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
+
+        // Index, data
+        size_t index = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
+        size_t data = (size_t) operation;
+
+        // Iterate over the activated rows
+        for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
+            size_t row = currRowMask.start + i * currRowMask.step;
+
+            // Perform the operation
+            memory_ptr[mapAddress(crossbar, index, row)] = data;
+
+        }
+
+    }
+
+    /**
+     * Verifies that the given write operation is valid
+     * @param operation
+     */
+    void validateWrite(otype operation){
+
+        // Index, data
+        otype operationCopy = operation;
+        size_t index = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
+        size_t data = (size_t) operationCopy;
+
+        // Verify that a valid index is provided
+        if(index < 0 || index >= CROSSBAR_N){
+            throw std::runtime_error("Write operation: invalid index.");
+        }
+
+#ifdef VERBOSE
+        std::cerr << "Simulator: Write(" << index << ", " << data << ")" << std::endl;
+#endif
+
+    }
+
+    /**
+     * Performs a write operation
+     * @param operation
+     * @return
+     */
+    void write(otype operation) {
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        validateWrite(operation);
+        otype operationCopy = operation;
+        size_t index = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
+        size_t data = (size_t) operationCopy;
+
+        flushLogic();
+        beforeWrite(crossbarMask);
+
+        // The bit-plane storage writes all rows through __writeBitplane
+        if(storageEngine == StorageEngine::BITPLANES){
+
+            // Allocate the kernel
+            size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
+            __writeBitplane<<<activeCrossbars, SIM_PLANE_THREADS_PER_BLOCK, 0, currContext->stream>>>(operation,
+                    crossbarMask, rowMask, planesData());
+
+        }
+        // If more than a single row is selected, use __writeMulti
+        else if((crossbarMask.start != crossbarMask.stop) || (rowMask.start != rowMask.stop)){
+
+            // Allocate the kernel
+            size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
+            __writeMulti<<<activeCrossbars, SIM_THREADS_PER_BLOCK, 0, currContext->stream>>>(operation, crossbarMask,
+                    rowMask, memoryData());
+
+        }
+        // Otherwise, write directly
+        else{
+
+            // Access the selected row
+            *memoryAt(mapAddress(crossbarMask.start, index, rowMask.start)) = data;
+
+        }
+
+    }
+
+    void setStorageEngine(StorageEngine engine){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(engine == StorageEngine::BITPLANES && backend == Backend::FUNCTIONAL){
+            throw std::runtime_error("Set Storage Engine: the functional backend requires the word storage engine.");
+        }
+
+        flushContexts();
+        if(engine == storageEngine) return;
+
+        if(!snapshots.empty()){
+            throw std::runtime_error("Set Storage Engine: the storage engine may not change while there are snapshots.");
+        }
+
+        // The memory state of the shards is converted by the workers
+        if(shardsActive()){
+            setShardStorageEngine(engine);
+            storageEngine = engine;
+            return;
+        }
+
+        // An unallocated memory is all zeros in both engines
+        if(!memoryAllocated()){
+            storageEngine = engine;
+            return;
+        }
+
+        // Convert the memory in batches of crossbars, using a temporary buffer for the converted crossbars
+        size_t crossbarSize = CROSSBAR_R * CROSSBAR_HEIGHT;
+        thrust::device_vector<dtype> converted(SIM_CONVERSION_CROSSBARS * crossbarSize);
+        size_t endCrossbar = firstOwnedCrossbar + numOwnedCrossbars;
+        for(size_t firstCrossbar = firstOwnedCrossbar; firstCrossbar < endCrossbar; firstCrossbar += SIM_CONVERSION_CROSSBARS){
+            size_t numCrossbars = std::min(SIM_CONVERSION_CROSSBARS, endCrossbar - firstCrossbar);
+            if(engine == StorageEngine::BITPLANES){
+                __toBitplane<<<numCrossbars * CROSSBAR_R, CROSSBAR_HEIGHT>>>(firstCrossbar,
+                        memoryData(), thrust::raw_pointer_cast(converted.data()));
+            }
+            else{
+                __fromBitplane<<<numCrossbars * CROSSBAR_R, CROSSBAR_HEIGHT>>>(firstCrossbar,
+                        planesData(), thrust::raw_pointer_cast(converted.data()));
+            }
+            thrust::copy(converted.begin(), converted.begin() + numCrossbars * crossbarSize, memoryAt(firstCrossbar * crossbarSize));
+        }
+
+#ifdef VERBOSE
+        std::cerr << "Simulator: StorageEngine(" << engine << ")" << std::endl;
+#endif
+
+        storageEngine = engine;
+
+    }
+
+    /**
+     * Flushes subnormal floating-point words (and negative zero) to positive zero, as in the gate-level routines
+     * @param x
+     * @return
+     */
+    __forceinline__ __device__ dtype flushFloat(dtype x){
+        return (x & 0x7F800000) == 0 ? 0 : x;
+    }
+
+    /**
+     * Returns whether the result of the given native operation is defined (i.e., neither a division by zero nor the
+     * overflowing integer division INT32_MIN / -1, whose gate-level results are arbitrary)
+     * @param operation
+     * @param floating
+     * @param x
+     * @param y
+     * @return
+     */
+    __forceinline__ __device__ bool nativeDefined(NativeOperation operation, bool floating, dtype x, dtype y){
+        if(operation != NativeOperation::DIVIDE && operation != NativeOperation::MODULO) return true;
+        if(floating) return flushFloat(y & 0x7FFFFFFF) != 0;
+        return y != 0 && !((int32_t)x == INT32_MIN && (int32_t)y == -1);
+    }
+
+    /**
+     * Computes the result of the given native operation on a single word
+     * @param operation
+     * @param floating
+     * @param x
+     * @param y
+     * @return
+     */
+    __forceinline__ __device__ dtype nativeResult(NativeOperation operation, bool floating, dtype x, dtype y){
+        if(floating){
+            switch(operation){
+                case NativeOperation::ADD:
+                    return flushFloat(__float_as_uint(__uint_as_float(flushFloat(x)) + __uint_as_float(flushFloat(y))));
+                case NativeOperation::SUBTRACT:
+                    return flushFloat(__float_as_uint(__uint_as_float(flushFloat(x)) - __uint_as_float(flushFloat(y))));
+                case NativeOperation::MULTIPLY:
+                    return flushFloat(__float_as_uint(__uint_as_float(flushFloat(x)) * __uint_as_float(flushFloat(y))));
+                case NativeOperation::DIVIDE:
+                    return flushFloat(__float_as_uint(__uint_as_float(flushFloat(x)) / __uint_as_float(flushFloat(y))));
+                default:
+                    break;
+            }
+        }
+        switch(operation){
+            case NativeOperation::ADD:
+                return x + y;
+            case NativeOperation::SUBTRACT:
+                return x - y;
+            case NativeOperation::MULTIPLY:
+                return x * y;
+            case NativeOperation::DIVIDE:
+                // Integer division by zero (and overflow) is undefined, so define it as zero
+                if((int32_t)y == 0 || ((int32_t)x == INT32_MIN && (int32_t)y == -1)) return 0;
+                return (dtype)((int32_t)x / (int32_t)y);
+            case NativeOperation::MODULO:
+                if((int32_t)y == 0 || ((int32_t)x == INT32_MIN && (int32_t)y == -1)) return 0;
+                return (dtype)((int32_t)x % (int32_t)y);
+            case NativeOperation::NEGATE:
+                return floating ? x ^ 0x80000000 : 0 - x;
+            case NativeOperation::ABSOLUTE:
+                return floating ? x & 0x7FFFFFFF : ((int32_t)x < 0 ? 0 - x : x);
+            case NativeOperation::SIGN:
+                return (int32_t)x < 0 ? 0xFFFFFFFF : 0;
+            case NativeOperation::ZERO:
+                return x == 0 ? 0xFFFFFFFF : 0;
+            case NativeOperation::BITWISE_NOT:
+                return ~x;
+            case NativeOperation::BITWISE_AND:
+                return x & y;
+            case NativeOperation::BITWISE_OR:
+                return x | y;
+            case NativeOperation::BITWISE_XOR:
+                return x ^ y;
+            case NativeOperation::COPY:
+                return x;
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * CUDA kernel that performs the given native operation on the activated rows (functional backend).
+     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars).
+     * @param routine
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param memory_ptr
+     * @param output_ptr if not null, the results are written to output_ptr (indexed by active crossbar and row)
+     * instead of to the output register
+     * @param defined_ptr if output_ptr is not null, whether every result is defined (indexed as output_ptr)
+     */
+    __global__ void __native(Routine routine, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<dtype> memory_ptr,
+                             dtype *output_ptr, uint8_t *defined_ptr){
+
+        // Each block represents a single *active* crossbar
+        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
+
+        // Iterate over the activated rows
+        for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
+            size_t row = currRowMask.start + i * currRowMask.step;
+
+            // Perform the operation
+            dtype x = memory_ptr[mapAddress(crossbar, routine.regX, row)];
+            dtype y = memory_ptr[mapAddress(crossbar, routine.regY, row)];
+            dtype result = nativeResult(routine.operation, routine.floating, x, y);
+            if(output_ptr){
+                output_ptr[blockIdx.x * CROSSBAR_HEIGHT + i] = result;
+                defined_ptr[blockIdx.x * CROSSBAR_HEIGHT + i] = nativeDefined(routine.operation, routine.floating, x, y);
+            }
+            else memory_ptr[mapAddress(crossbar, routine.regZ, row)] = result;
+
+        }
+
+    }
+
+    /**
+     * CUDA kernel that counts the activated rows in which the given register differs from the expected results.
+     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars).
+     * @param reg
+     * @param currCrossbarMask
+     * @param currRowMask
+     * @param memory_ptr
+     * @param expected_ptr the expected results (indexed by active crossbar and row)
+     * @param defined_ptr whether every expected result is defined (undefined results are not compared)
+     * @param mismatches
+     */
+    __global__ void __compare(size_t reg, RangeMask currCrossbarMask, RangeMask currRowMask, MemoryView<const dtype> memory_ptr,
+                              const dtype *expected_ptr, const uint8_t *defined_ptr, unsigned long long *mismatches){
+
+        // Each block represents a single *active* crossbar
+        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
+
+        // Iterate over the activated rows
+        for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
+            size_t row = currRowMask.start + i * currRowMask.step;
+            if(defined_ptr[blockIdx.x * CROSSBAR_HEIGHT + i] &&
+                memory_ptr[mapAddress(crossbar, reg, row)] != expected_ptr[blockIdx.x * CROSSBAR_HEIGHT + i]){
+                atomicAdd(mismatches, 1ULL);
+            }
+        }
+
+    }
+
+    /**
+     * Executes the current routine natively
+     * @param output_ptr if not null, the results are written to output_ptr instead of to the output register
+     * @param defined_ptr if output_ptr is not null, whether every result is defined
+     */
+    void executeNative(dtype *output_ptr, uint8_t *defined_ptr){
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        flushLogic();
+        if(!output_ptr) beforeWrite(crossbarMask);
+
+        // Allocate the kernel
+        size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
+        __native<<<activeCrossbars, SIM_THREADS_PER_BLOCK>>>(currContext->currRoutine, crossbarMask, rowMask,
+                memoryData(), output_ptr, defined_ptr);
+
+    }
+
+    /**
+     * Verifies that the gate-level execution of the current (sampled) routine matches its native execution
+     */
+    void verifySample(){
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        flushLogic();
+
+        // Allocate the kernel
+        size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
+        d_mismatches[0] = 0;
+        __compare<<<activeCrossbars, SIM_THREADS_PER_BLOCK>>>(currContext->currRoutine.regZ, crossbarMask, rowMask,
+                memoryData(), thrust::raw_pointer_cast(d_sampleBuffer.data()),
+                thrust::raw_pointer_cast(d_sampleDefined.data()),
+                thrust::raw_pointer_cast(d_mismatches.data()));
+
+        unsigned long long mismatches = d_mismatches[0];
+        if(mismatches > 0){
+            throw std::runtime_error(std::string("Functional backend: ") + std::to_string(mismatches) +
+                    " mismatches between the native and gate-level execution of " + currContext->currRoutine.name + ".");
+        }
+
+    }
+
+    void beginRoutine(const Routine& routine){
+
+        if(queueActive()){
+            enqueueBeginRoutine(routine);
+            return;
+        }
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(isTracing()) traceBeginRoutine(routine);
+        if(capturing){
+            capturedGraph.operations.push_back({GraphOperation::BEGIN_ROUTINE, (otype)capturedGraph.routines.size(), {-1, -1, -1}});
+            capturedGraph.routines.push_back(routine);
+        }
+
+        currContext->currRoutine = routine;
+        currContext->currStatistics = &statistics[routine.name];
+        currContext->currStatistics->calls++;
+
+        // The functional backend executes the routines with a native operation natively, except for sampled calls
+        currContext->currNative = backend == Backend::FUNCTIONAL && routine.operation != NativeOperation::NONE;
+        currContext->currSampled = currContext->currNative && samplingPeriod > 0 &&
+                (currContext->currStatistics->calls - 1) % samplingPeriod == 0;
+        currContext->currSampleComputed = false;
+
+    }
+
+    void endRoutine(){
+
+        if(queueActive()){
+            enqueueEndRoutine();
+            return;
+        }
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(currContext->currNative){
+            if(!currContext->currSampled) executeNative(nullptr, nullptr);
+            else if(currContext->currSampleComputed) verifySample();
+        }
+
+        currContext->currStatistics = nullptr;
+        currContext->currNative = false;
+        currContext->currSampled = false;
+
+        if(isTracing()) traceEndRoutine();
+        if(capturing) capturedGraph.operations.push_back({GraphOperation::END_ROUTINE, 0, {-1, -1, -1}});
+
+    }
+
+    void setBackend(Backend selected, size_t period){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(selected == Backend::FUNCTIONAL && storageEngine == StorageEngine::BITPLANES){
+            throw std::runtime_error("Set Backend: the functional backend requires the word storage engine.");
+        }
+        if(selected == Backend::FUNCTIONAL && shardsActive()){
+            throw std::runtime_error("Set Backend: the functional backend is not supported with shards.");
+        }
+
+        flushContexts();
+        backend = selected;
+        samplingPeriod = period;
+
+    }
+
+    std::map<std::string, RoutineStatistics> getStatistics(){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        return statistics;
+    }
+
+    void resetStatistics(){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        statistics.clear();
+        processSimulatorContext.currStatistics = nullptr;
+        processSimulatorContext.issuedCycles = processSimulatorContext.queueCycles = 0;
+        for(auto& ctx : simulatorContexts){
+            ctx.second->currStatistics = nullptr;
+            ctx.second->issuedCycles = ctx.second->queueCycles = 0;
+        }
+        barrierCycles = elapsedCycles = 0;
+        dryRunStatistics = {};
+    }
+
+    IssueStatistics getIssueStatistics(){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        IssueStatistics result = {{{0, processSimulatorContext.issuedCycles}}, elapsedCycles};
+        for(const auto& ctx : simulatorContexts) result.issuedCycles[ctx.first] = ctx.second->issuedCycles;
+        return result;
+    }
+
+    DryRunStatistics getDryRunStatistics(){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        return dryRunStatistics;
+    }
+
+    void setReadPlaceholder(dtype placeholder){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        readPlaceholder = placeholder;
+    }
+
+    /**
+     * Counts the given micro-operation without accessing the memory state (dry-run backend)
+     * @param operation
+     * @return
+     */
+    dtype dryRun(otype operation){
+
+        const RangeMask& crossbarMask = currContext->crossbarMask;
+        const RangeMask& rowMask = currContext->rowMask;
+
+        dryRunStatistics.types[operation & 0x3]++;
+
+        // Mask operations update the masks that the following micro-operations are counted by
+        if((operation & 0x3) == MicrooperationType::MASK){
+            mask(operation >> 2);
+            return 0;
+        }
+        if((operation & 0x3) == MicrooperationType::LOGIC){
+            size_t gateType = (operation >> 3) & 0x3;
+            if((operation >> 2) & 0x1) dryRunStatistics.verticalGates[gateType]++;
+            else dryRunStatistics.horizontalGates[gateType]++;
+        }
+
+        dryRunStatistics.crossbarMaskWidths[(crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1]++;
+        dryRunStatistics.rowMaskWidths[(rowMask.stop - rowMask.start) / rowMask.step + 1]++;
+
+        return (operation & 0x3) == MicrooperationType::READ ? readPlaceholder : 0;
+
+    }
+
+    /**
+     * Pre-decodes the given micro-operation into a graph operation
+     * @param operation
+     * @return
+     */
+    GraphOperation decodeGraphOperation(otype operation){
+
+        GraphOperation result = {GraphOperation::MICROOPERATION, operation, {-1, -1, -1}};
+        switch(operation & 0x3){
+            case MicrooperationType::READ:
+            case MicrooperationType::WRITE:
+                result.registers[0] = 2;
+                break;
+            case MicrooperationType::LOGIC:
+                if((operation >> 2) & 0x1){
+                    // Vertical: the index follows the gate type, the input row and the output row
+                    result.registers[0] = (int8_t)(5 + 2 * LOG_CROSSBAR_HEIGHT);
+                }
+                else{
+                    // Horizontal: input A, input B and output follow the gate type (each with its partition)
+                    result.registers[0] = 5;
+                    result.registers[1] = (int8_t)(5 + LOG_CROSSBAR_R + LOG_CROSSBAR_N);
+                    result.registers[2] = (int8_t)(5 + 2 * (LOG_CROSSBAR_R + LOG_CROSSBAR_N));
+                }
+                break;
+            default:
+                break;
+        }
+        return result;
+
+    }
+
+    void beginGraphCapture(){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(capturing){
+            throw std::runtime_error("Begin Graph Capture: a graph is already being captured.");
+        }
+
+        capturedGraph = Graph();
+        capturing = true;
+
+    }
+
+    Graph endGraphCapture(){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(!capturing){
+            throw std::runtime_error("End Graph Capture: no graph is being captured.");
+        }
+        capturing = false;
+
+        // Compute the statistics of a single launch
+        RoutineStatistics *routineStatistics = nullptr;
+        for(const GraphOperation& entry : capturedGraph.operations){
+            if(entry.kind == GraphOperation::BEGIN_ROUTINE){
+                routineStatistics = &capturedGraph.statistics[capturedGraph.routines[entry.operation].name];
+                routineStatistics->calls++;
+            }
+            else if(entry.kind == GraphOperation::END_ROUTINE){
+                routineStatistics = nullptr;
+            }
+            else if(routineStatistics){
+                routineStatistics->microoperations++;
+                if((entry.operation & 0x3) != MicrooperationType::MASK) routineStatistics->cycles++;
+            }
+        }
+
+        return std::move(capturedGraph);
 
-            // Input A (intra-partition and partition address)
-            size_t inA = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
-            size_t pA = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+    }
 
-            // Input B (intra-partition and partition address)
-            size_t inB = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
-            size_t pB = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+    void launchGraph(const Graph& graph, const std::map<size_t, size_t>& registers, const RangeMask *crossbars){
 
-            // Output (intra-partition and partition address)
-            size_t out = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
-            size_t pOut = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
 
-            // The pattern for the opcode repetition
-            size_t pEnd = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
-            size_t pStep = operationCopy & CROSSBAR_N_MASK; operationCopy >>= LOG_CROSSBAR_N;
+        // Validate the binding once for the entire graph
+        size_t binding[CROSSBAR_R];
+        for(size_t reg = 0; reg < CROSSBAR_R; reg++) binding[reg] = reg;
+        for(const auto& bound : registers){
+            if(bound.first < 0 || bound.first >= CROSSBAR_R || bound.second < 0 || bound.second >= CROSSBAR_R){
+                throw std::runtime_error("Launch Graph: invalid register binding.");
+            }
+            binding[bound.first] = bound.second;
+        }
+        otype crossbarOperation = 0;
+        if(crossbars){
+            if(crossbars->start < 0 || crossbars->stop >= NUM_CROSSBARS || crossbars->start > crossbars->stop ||
+               crossbars->step <= 0 || (crossbars->stop - crossbars->start) % crossbars->step != 0){
+                throw std::runtime_error("Launch Graph: invalid crossbar mask.");
+            }
+            crossbarOperation = ((((((otype)crossbars->step << LOG_NUM_CROSSBARS) | crossbars->stop) << LOG_NUM_CROSSBARS) |
+                    crossbars->start) << 3) | MicrooperationType::MASK;
+        }
 
-            if(gateType != GateType::INIT0 && gateType != GateType::INIT1 && gateType != GateType::NOT && gateType != GateType::NOR){
-                throw std::runtime_error("Logic operation: invalid gate type.");
+        // Backends other than the gate level (and tracing or capturing) require every micro-operation to be performed
+        bool direct = backend == Backend::GATE_LEVEL && !isTracing() && !capturing && !shardsActive();
+        if(direct){
+            allocateMemory();
+            for(const auto& routine : graph.statistics){
+                RoutineStatistics& routineStatistics = statistics[routine.first];
+                routineStatistics.calls += routine.second.calls;
+                routineStatistics.microoperations += routine.second.microoperations;
+                routineStatistics.cycles += routine.second.cycles;
             }
-            if(inA < 0 || inA >= CROSSBAR_R ||
-               pA < 0 || pA >= CROSSBAR_N){
-                throw std::runtime_error("Logic operation: invalid input A.");
+        }
+
+        for(const GraphOperation& entry : graph.operations){
+
+            if(entry.kind == GraphOperation::BEGIN_ROUTINE){
+                if(!direct){
+                    Routine routine = graph.routines[entry.operation];
+                    routine.regX = binding[routine.regX];
+                    routine.regY = binding[routine.regY];
+                    routine.regZ = binding[routine.regZ];
+                    beginRoutine(routine);
+                }
+                continue;
             }
-            if(inB < 0 || inB >= CROSSBAR_R ||
-               pB < 0 || pB >= CROSSBAR_N){
-                throw std::runtime_error("Logic operation: invalid input B.");
+            if(entry.kind == GraphOperation::END_ROUTINE){
+                if(!direct) endRoutine();
+                continue;
             }
-            if(out < 0 || out >= CROSSBAR_R ||
-               pOut < 0 || pOut >= CROSSBAR_N){
-                throw std::runtime_error("Logic operation: invalid output.");
+
+            // Rebind the registers and the crossbars
+            otype operation = entry.operation;
+            for(int8_t offset : entry.registers){
+                if(offset < 0) continue;
+                size_t reg = (size_t)((operation >> offset) & CROSSBAR_R_MASK);
+                operation = (operation & ~(CROSSBAR_R_MASK << offset)) | ((otype)binding[reg] << offset);
             }
-            if(pEnd < pOut || pEnd >= CROSSBAR_N ||
-                    pStep <= 0 || (pEnd - pOut) % pStep != 0){
-                throw std::runtime_error("Logic operation: invalid pattern.");
+            bool crossbarMaskOperation = (operation & 0x3) == MicrooperationType::MASK && !((operation >> 2) & 0x1);
+            if(crossbars && crossbarMaskOperation) operation = crossbarOperation;
+
+            if(!direct){
+                perform(operation);
+                continue;
             }
-            if(pA > pB){
-                throw std::runtime_error("Logic operation: the partition of input A should be to the left of that of input B.");
+
+            // The micro-operations were validated during the capture
+            if((operation & 0x3) != MicrooperationType::MASK) issueCycles(1);
+            switch(operation & 0x3){
+                case MicrooperationType::LOGIC:
+                    bufferLogic(operation >> 2);
+                    break;
+                case MicrooperationType::MASK:
+                    flushLogic();
+                    if(crossbarMaskOperation){
+                        RangeMask mask((size_t)((operation >> 3) & NUM_CROSSBARS_MASK),
+                                       (size_t)((operation >> (3 + LOG_NUM_CROSSBARS)) & NUM_CROSSBARS_MASK),
+                                       (size_t)((operation >> (3 + 2 * LOG_NUM_CROSSBARS)) & NUM_CROSSBARS_MASK));
+                        // The graph may have been captured in another context
+                        if(mask.start < currContext->crossbars.start || mask.stop > currContext->crossbars.stop){
+                            throw std::runtime_error("Launch Graph: the crossbars are not owned by the current context.");
+                        }
+                        currContext->crossbarMask = mask;
+                    }
+                    else{
+                        currContext->rowMask = {(size_t)((operation >> 3) & CROSSBAR_HEIGHT_MASK),
+                                                (size_t)((operation >> (3 + LOG_CROSSBAR_HEIGHT)) & CROSSBAR_HEIGHT_MASK),
+                                                (size_t)((operation >> (3 + 2 * LOG_CROSSBAR_HEIGHT)) & CROSSBAR_HEIGHT_MASK)};
+                    }
+                    break;
+                case MicrooperationType::WRITE:
+                    write(operation >> 2);
+                    break;
+                default:
+                    break;
             }
 
         }
 
-        // Add the operation to the buffer
-        logicBuffer[logicBufferIdx++] = operation;
-        if(logicBufferIdx == SIM_LOGIC_BUFFER_SIZE) flushLogic();
+    }
+
+    size_t snapshotMemory(){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(shardsActive()){
+            throw std::runtime_error("Snapshot Memory: snapshots are not supported with shards.");
+        }
+        flushContexts();
+        allocateMemory();
+        if(savedEpoch.empty()) savedEpoch.resize(NUM_CROSSBARS, 0);
+
+        // The snapshot initially holds no crossbars, as none were modified since
+        snapshotEpoch++;
+        snapshots[snapshotEpoch] = {snapshotEpoch, storageEngine, {}};
+        return snapshotEpoch;
 
     }
 
-    /**
-     * Sets the current crossbar mask
-     * @param operation
-     */
-    void setCrossbarMask(otype operation){
+    void restoreMemory(size_t handle){
 
-        // Start, stop, step
-        size_t start = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
-        size_t stop = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
-        size_t step = operation & NUM_CROSSBARS_MASK; operation >>= LOG_NUM_CROSSBARS;
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
 
-        // Check for input correctness
-        if(start < 0 || start >= NUM_CROSSBARS){
-            throw std::runtime_error("Set Crossbar Mask: invalid crossbar start.");
+        auto it = snapshots.find(handle);
+        if(it == snapshots.end()){
+            throw std::runtime_error("Restore Memory: invalid snapshot.");
         }
-        if(stop < 0 || stop >= NUM_CROSSBARS){
-            throw std::runtime_error("Set Crossbar Mask: invalid crossbar stop.");
+        if(it->second.engine != storageEngine){
+            throw std::runtime_error("Restore Memory: the snapshot was taken in a different storage engine.");
         }
-        if(start > stop || step <= 0 || (stop - start) % step != 0){
-            throw std::runtime_error("Set Crossbar Mask: invalid crossbar mask.");
+
+        flushContexts();
+
+        // The restored crossbars are modified, so they are first saved for the snapshots that do not hold them yet
+        std::vector<size_t> crossbars;
+        for(const auto& saved : it->second.crossbars) crossbars.push_back(saved.first);
+        saveCrossbars(crossbars);
+
+        // Copy the saved crossbars back (the other crossbars were not modified since the snapshot)
+        for(const auto& saved : it->second.crossbars){
+            thrust::copy(saved.second.buffer->begin() + saved.second.offset,
+                         saved.second.buffer->begin() + saved.second.offset + CROSSBAR_SIZE,
+                         memoryAt(saved.first * CROSSBAR_SIZE));
         }
 
-#ifdef VERBOSE
-        std::cerr << "Simulator: CrossbarMask(" << start << ", " << stop << ", " << step << ")" << std::endl;
-#endif
+    }
 
-        flushLogic();
-        crossbarMask = {start, stop, step};
+    void releaseMemorySnapshot(size_t handle){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        if(snapshots.erase(handle) == 0){
+            throw std::runtime_error("Release Memory Snapshot: invalid snapshot.");
+        }
     }
 
     /**
-     * Sets the current row mask
-     * @param operation
+     * CUDA kernel that marks the crossbars that hold a non-zero word (in either storage engine, as zero is stored as
+     * zero words in both).
+     * Each CUDA block represents a single crossbar.
+     * @param memory_ptr
+     * @param nonZero_ptr
      */
-    void setRowMask(otype operation){
+    __global__ void __nonZero(const dtype *memory_ptr, uint8_t *nonZero_ptr){
+        const dtype *crossbar = memory_ptr + blockIdx.x * CROSSBAR_SIZE;
+        for(size_t i = threadIdx.x; i < CROSSBAR_SIZE; i += blockDim.x){
+            if(crossbar[i] != 0){
+                nonZero_ptr[blockIdx.x] = 1;
+                return;
+            }
+        }
+    }
 
-        // Start, stop, step
-        size_t start = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
-        size_t stop = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
-        size_t step = operation & CROSSBAR_HEIGHT_MASK; operation >>= LOG_CROSSBAR_HEIGHT;
+    void *mapMemory(const std::string& path, size_t userSize, bool& created){
 
-        // Check for input correctness
-        if(start < 0 || start >= CROSSBAR_HEIGHT){
-            throw std::runtime_error("Set Row Mask: invalid row start.");
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(mappedFile){
+            throw std::runtime_error("Map Memory: a memory file is already mapped.");
         }
-        if(stop < 0 || stop >= CROSSBAR_HEIGHT){
-            throw std::runtime_error("Set Row Mask: invalid row stop.");
+        if(!snapshots.empty()){
+            throw std::runtime_error("Map Memory: the memory may not be mapped while there are snapshots.");
         }
-        if(start > stop || step <= 0 || (stop - start) % step != 0){
-            throw std::runtime_error("Set Row Mask: invalid row mask.");
+        if(shardsActive() || numOwnedCrossbars != NUM_CROSSBARS){
+            throw std::runtime_error("Map Memory: the memory may not be mapped with shards.");
         }
-
-#ifdef VERBOSE
-        std::cerr << "Simulator: RowMask(" << start << ", " << stop << ", " << step << ")" << std::endl;
+        flushContexts();
+
+        // The user region and the memory state are page-aligned
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t userOffset = ((size_t)sizeof(MemoryFileHeader) + page - 1) / page * page;
+        size_t memoryOffset = (userOffset + userSize + page - 1) / page * page;
+        size_t memoryBytes = MEMORY_SIZE * (size_t)sizeof(dtype);
+        size_t length = memoryOffset + memoryBytes;
+
+        // Open (or create) the file, which is sparse until the memory state is modified
+        int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if(fd < 0){
+            throw std::runtime_error("Map Memory: failed to open " + path + ".");
+        }
+        struct stat st = {};
+        fstat(fd, &st);
+        created = st.st_size == 0;
+        if(created && ftruncate(fd, length) != 0){
+            close(fd);
+            throw std::runtime_error("Map Memory: failed to resize " + path + ".");
+        }
+        if(!created && (size_t)st.st_size != length){
+            close(fd);
+            throw std::runtime_error("Map Memory: " + path + " does not match the memory geometry.");
+        }
+        void *mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(mapped == MAP_FAILED){
+            throw std::runtime_error("Map Memory: failed to map " + path + ".");
+        }
+        uint8_t *file = static_cast<uint8_t *>(mapped);
+
+        // Verify (or write) the header
+        MemoryFileHeader expected = {};
+        memcpy(expected.magic, MEMORY_FILE_MAGIC, sizeof(expected.magic));
+        expected.version = MEMORY_FILE_VERSION;
+        expected.logNumCrossbars = LOG_NUM_CROSSBARS;
+        expected.logCrossbarHeight = LOG_CROSSBAR_HEIGHT;
+        expected.logCrossbarN = LOG_CROSSBAR_N;
+        expected.logCrossbarR = LOG_CROSSBAR_R;
+#ifdef ROW_INTERLEAVED
+        expected.rowInterleaved = 1;
 #endif
+        expected.storageEngine = storageEngine;
+        expected.userOffset = userOffset;
+        expected.userSize = userSize;
+        expected.memoryOffset = memoryOffset;
+        expected.memorySize = memoryBytes;
+        MemoryFileHeader header = {};
+        memcpy(&header, file, sizeof(header));
+        if(!created){
+            header.storageEngine = expected.storageEngine;
+            if(memcmp(&header, &expected, sizeof(header)) != 0){
+                munmap(mapped, length);
+                throw std::runtime_error("Map Memory: " + path + " does not match the memory geometry.");
+            }
+        }
+
+        // Access the memory state directly if the device supports pageable memory access, otherwise register it
+        dtype *hostMemory = reinterpret_cast<dtype *>(file + memoryOffset);
+        int device = 0, pageable = 0;
+        cudaGetDevice(&device);
+        cudaDeviceGetAttribute(&pageable, cudaDevAttrPageableMemoryAccess, device);
+        if(pageable){
+            mappedMemory = hostMemory;
+        }
+        else{
+            if(cudaHostRegister(hostMemory, memoryBytes, cudaHostRegisterMapped) != cudaSuccess ||
+               cudaHostGetDevicePointer((void **)&mappedMemory, hostMemory, 0) != cudaSuccess){
+                munmap(mapped, length);
+                mappedMemory = nullptr;
+                throw std::runtime_error("Map Memory: failed to register " + path + " with the device.");
+            }
+            mappedRegistered = true;
+        }
+        mappedFile = file;
+        mappedFileLength = length;
+
+        // A new file is initialized with the current memory state, while an existing file replaces it. Only the
+        // non-zero crossbars are copied, so that the pages of the other crossbars remain holes of the sparse file.
+        if(created){
+            if(!memory.empty()){
+                thrust::device_vector<uint8_t> d_nonZero(NUM_CROSSBARS, 0);
+                __nonZero<<<NUM_CROSSBARS, SIM_THREADS_PER_BLOCK>>>(thrust::raw_pointer_cast(memory.data()),
+                        thrust::raw_pointer_cast(d_nonZero.data()));
+                std::vector<uint8_t> nonZero(NUM_CROSSBARS);
+                thrust::copy(d_nonZero.begin(), d_nonZero.end(), nonZero.begin());
+                for(size_t crossbar = 0; crossbar < NUM_CROSSBARS; crossbar++){
+                    if(!nonZero[crossbar]) continue;
+                    thrust::copy(memory.begin() + crossbar * CROSSBAR_SIZE, memory.begin() + (crossbar + 1) * CROSSBAR_SIZE,
+                                 memoryAt(crossbar * CROSSBAR_SIZE));
+                }
+                cudaDeviceSynchronize();
+            }
+            memcpy(file, &expected, sizeof(expected));
+        }
+        else{
+            memcpy(&header, file, sizeof(header));
+            storageEngine = (StorageEngine)header.storageEngine;
+        }
+        memory.clear();
+        memory.shrink_to_fit();
+
+        return file + userOffset;
+
+    }
 
+    void unmapMemory(){
+
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(!mappedFile) return;
+        if(!snapshots.empty()){
+            throw std::runtime_error("Unmap Memory: the memory may not be unmapped while there are snapshots.");
+        }
+        flushContexts();
+
+        // Copy the memory state back to device memory
+        memory.resize(MEMORY_SIZE);
+        thrust::copy(memoryAt(0), memoryAt(MEMORY_SIZE), memory.begin());
+        cudaDeviceSynchronize();
+
+        // Record the storage engine of the memory state, and unmap the file
+        MemoryFileHeader header = {};
+        memcpy(&header, mappedFile, sizeof(header));
+        header.storageEngine = storageEngine;
+        memcpy(mappedFile, &header, sizeof(header));
+        if(mappedRegistered) cudaHostUnregister(mappedMemory);
+        munmap(mappedFile, mappedFileLength);
+        mappedFile = nullptr;
+        mappedMemory = nullptr;
+        mappedRegistered = false;
+
+    }
+
+    void synchronize(){
+        drainQueue();
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
         flushLogic();
-        rowMask = {start, stop, step};
+        if(shardsActive()) synchronizeShards();
+        cudaDeviceSynchronize();
     }
 
-    /**
-     * Performs a mask operation
-     * @param operation
-     */
-    void mask(otype operation){
+    void setOwnedCrossbars(size_t first, size_t count){
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        if(memoryAllocated()){
+            throw std::runtime_error("Set Owned Crossbars: the memory state is already allocated.");
+        }
+        if(first < 0 || count <= 0 || first + count > NUM_CROSSBARS){
+            throw std::runtime_error("Set Owned Crossbars: invalid crossbar range.");
+        }
+        firstOwnedCrossbar = first;
+        numOwnedCrossbars = count;
+        currContext->crossbarMask = {first, first + count - 1, 1};
+    }
 
-        if(operation & 0x1){
-            setRowMask(operation >> 1);
+    void copyCrossbars(size_t first, size_t count, dtype *host, bool toHost){
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        flushContexts();
+        allocateMemory();
+        if(toHost){
+            thrust::copy(memoryAt(first * CROSSBAR_SIZE), memoryAt((first + count) * CROSSBAR_SIZE), host);
         }
         else{
-            setCrossbarMask(operation >> 1);
+            thrust::copy(host, host + count * CROSSBAR_SIZE, memoryAt(first * CROSSBAR_SIZE));
         }
+    }
 
+    void releaseMemory(){
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        memory.clear();
+        memory.shrink_to_fit();
     }
 
-    /**
-    * Performs a read operation
-    * @param operation
-    * @return
-    */
-    dtype read(otype operation) {
+    void validateSharding(){
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+        flushContexts();
+        if(backend == Backend::FUNCTIONAL){
+            throw std::runtime_error("Start Shards: the functional backend is not supported with shards.");
+        }
+        if(!snapshots.empty()){
+            throw std::runtime_error("Start Shards: shards may not be started while there are snapshots.");
+        }
+        if(mappedFile){
+            throw std::runtime_error("Start Shards: shards may not be started while the memory is mapped.");
+        }
+    }
 
-        // Index
-        size_t index = (size_t)operation;
+    StorageEngine getStorageEngine(){
+        return storageEngine;
+    }
 
-        // Verify that only a single row in a single crossbar is selected
-        if((crossbarMask.start != crossbarMask.stop) || (rowMask.start != rowMask.stop)){
-            throw std::runtime_error("Read operation: multiple rows selected.");
-        }
+    size_t deviceCount(){
+        int count = 0;
+        if(cudaGetDeviceCount(&count) != cudaSuccess) return 0;
+        return count;
+    }
 
-        // Verify that a valid index is provided
-        if(index < 0 || index >= CROSSBAR_N){
-            throw std::runtime_error("Read operation: invalid index.");
+    std::string devicePciBusId(size_t device){
+        char busId[32] = {};
+        if(cudaDeviceGetPCIBusId(busId, sizeof(busId), (int)device) != cudaSuccess) return "";
+        return busId;
+    }
+
+    size_t createSimulatorContext(size_t firstCrossbar, size_t numCrossbars){
+
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(firstCrossbar < 0 || numCrossbars <= 0 || firstCrossbar + numCrossbars > NUM_CROSSBARS){
+            throw std::runtime_error("Create Context: invalid crossbar range.");
+        }
+        for(const auto& ctx : simulatorContexts){
+            if(firstCrossbar <= ctx.second->crossbars.stop && ctx.second->crossbars.start < firstCrossbar + numCrossbars){
+                throw std::runtime_error("Create Context: the crossbars are owned by another context.");
+            }
         }
 
-#ifdef VERBOSE
-        std::cerr << "Simulator: Read(" << index << ")" << std::endl;
-#endif
+        simulatorContexts[++lastContextHandle].reset(
+                new SimulatorContext({firstCrossbar, firstCrossbar + numCrossbars - 1, 1}, false));
+        return lastContextHandle;
 
-        // Access the selected row
-        flushLogic();
-        return memory[mapAddress(crossbarMask.start, index, rowMask.start)];
     }
 
-    /**
-     * CUDA kernel that writes to several rows
-     * Each CUDA block represents a single *active* crossbar (num blocks = num activate crossbars).
-     * @param operation
-     * @param currCrossbarMask
-     * @param currRowMask
-     * @param memory_ptr
-     */
-    __global__ void __writeMulti(otype operation, RangeMask currCrossbarMask, RangeMask currRowMask, dtype *memory_ptr){
+    void destroySimulatorContext(size_t handle){
 
-        // Each block represents a single *active* crossbar
-        size_t crossbar = currCrossbarMask.start + blockIdx.x * currCrossbarMask.step;
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
 
-        // Index, data
-        size_t index = operation & CROSSBAR_R_MASK; operation >>= LOG_CROSSBAR_R;
-        size_t data = (size_t) operation;
+        auto it = simulatorContexts.find(handle);
+        if(it == simulatorContexts.end()) return;
+        flushContext(*it->second);
+        if(currContext == it->second.get()) currContext = &processSimulatorContext;
+        simulatorContexts.erase(it);
 
-        // Iterate over the activated rows
-        for(size_t i = threadIdx.x; i <= ((currRowMask.stop - currRowMask.start) / currRowMask.step); i += blockDim.x){
-            size_t row = currRowMask.start + i * currRowMask.step;
+    }
 
-            // Perform the operation
-            memory_ptr[mapAddress(crossbar, index, row)] = data;
+    void selectSimulatorContext(size_t handle){
+
+        if(handle == 0){
+            currContext = &processSimulatorContext;
+            return;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
 
+        auto it = simulatorContexts.find(handle);
+        if(it == simulatorContexts.end()){
+            throw std::runtime_error("Select Context: invalid context.");
         }
+        currContext = it->second.get();
 
     }
 
     /**
-     * Performs a write operation
+     * Validates the given micro-operation and forwards it to the shards that own the selected crossbars
      * @param operation
      * @return
      */
-    void write(otype operation) {
-
-        // Index, data
-        otype operationCopy = operation;
-        size_t index = operationCopy & CROSSBAR_R_MASK; operationCopy >>= LOG_CROSSBAR_R;
-        size_t data = (size_t) operationCopy;
-
-        // Verify that a valid index is provided
-        if(index < 0 || index >= CROSSBAR_N){
-            throw std::runtime_error("Write operation: invalid index.");
-        }
+    dtype forward(otype operation){
 
-#ifdef VERBOSE
-        std::cerr << "Simulator: Write(" << index << ", " << data << ")" << std::endl;
-#endif
+        switch(operation & 0x3){
 
-        flushLogic();
+            case MicrooperationType::READ:
+                validateRead(operation >> 2);
+                return readFromShard(operation, currContext->crossbarMask, currContext->rowMask);
 
-        // If more than a single row is selected, use __writeMulti
-        if((crossbarMask.start != crossbarMask.stop) || (rowMask.start != rowMask.stop)){
+            case MicrooperationType::WRITE:
+                validateWrite(operation >> 2);
+                forwardToShards(operation, currContext->crossbarMask, currContext->rowMask);
+                return 0;
 
-            // Allocate the kernel
-            size_t activeCrossbars = (crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1;
-            __writeMulti<<<activeCrossbars, SIM_THREADS_PER_BLOCK>>>(operation, crossbarMask, rowMask, thrust::raw_pointer_cast(memory.data()));
+            case MicrooperationType::LOGIC:
+                validateLogic(operation >> 2);
+                forwardToShards(operation, currContext->crossbarMask, currContext->rowMask);
+                return 0;
 
-        }
-        // Otherwise, write directly
-        else{
+            case MicrooperationType::MASK:
+                // Masks are sent to a shard only before its next micro-operation
+                mask(operation >> 2);
+                return 0;
 
-            // Access the selected row
-            memory[mapAddress(crossbarMask.start, index, rowMask.start)] = data;
+            default:
+                throw std::runtime_error("Perform: invalid operation type.");
 
         }
 
     }
 
     /**
-     * Performs the given micro-operation
+     * Performs the given micro-operation on the memory state
      * @param operation
      * @return
      */
-    dtype perform(otype operation){
+    dtype execute(otype operation){
 
         // Switch according to the operation type
         switch(operation & 0x3){
@@ -447,6 +2217,18 @@ namespace pim {
                 return 0;
 
             case MicrooperationType::LOGIC:
+                if(currContext->currNative){
+                    // Only sampled calls are simulated at the gate level, after computing the native results
+                    if(!currContext->currSampled) return 0;
+                    if(!currContext->currSampleComputed){
+                        const RangeMask& crossbarMask = currContext->crossbarMask;
+                        size_t sampleSize = ((crossbarMask.stop - crossbarMask.start) / crossbarMask.step + 1) * CROSSBAR_HEIGHT;
+                        d_sampleBuffer.resize(sampleSize);
+                        d_sampleDefined.resize(sampleSize);
+                        executeNative(thrust::raw_pointer_cast(d_sampleBuffer.data()), thrust::raw_pointer_cast(d_sampleDefined.data()));
+                        currContext->currSampleComputed = true;
+                    }
+                }
                 logic(operation >> 2);
                 return 0;
 
@@ -461,4 +2243,57 @@ namespace pim {
 
     }
 
-}
\ No newline at end of file
+    /**
+     * Performs the given micro-operation
+     * @param operation
+     * @return
+     */
+    dtype perform(otype operation){
+
+        // In the asynchronous mode, the micro-operation is performed by the executor thread
+        if(queueActive()){
+            if((operation & 0x3) != MicrooperationType::READ){
+                enqueueOperation(operation);
+                return 0;
+            }
+            std::future<dtype> result = enqueueRead(operation);
+            drainQueue();
+            return result.get();
+        }
+        std::lock_guard<std::recursive_mutex> lock(simulatorMutex);
+
+        if(capturing && (operation & 0x3) == MicrooperationType::READ){
+            throw std::runtime_error("Perform: read operations may not be captured.");
+        }
+
+        // Attribute the micro-operation to the current routine, and to the issue queue of the current context
+        if(currContext->currStatistics){
+            currContext->currStatistics->microoperations++;
+            if((operation & 0x3) != MicrooperationType::MASK) currContext->currStatistics->cycles++;
+        }
+        if((operation & 0x3) != MicrooperationType::MASK) issueCycles(1);
+
+        dtype result;
+        if(backend == Backend::DRY_RUN){
+            result = dryRun(operation);
+        }
+        else if(shardsActive()){
+            result = forward(operation);
+        }
+        else{
+            allocateMemory();
+            result = execute(operation);
+        }
+
+        // Record the micro-operation (and the result of reads)
+        if(isTracing()){
+            traceOperation(operation);
+            if((operation & 0x3) == MicrooperationType::READ) traceReadResult(result);
+        }
+        if(capturing) capturedGraph.operations.push_back(decodeGraphOperation(operation));
+
+        return result;
+
+    }
+
+}
@@ -1,15 +1,297 @@
 #ifndef CUDAPIM_SIMULATOR_H
 #define CUDAPIM_SIMULATOR_H
 
+#include <map>
+#include <string>
+#include <vector>
 #include "constants.h"
 
 namespace pim{
 
+    /**
+     * The storage engines supported by the simulator
+     */
+    enum StorageEngine{
+        /** Every (crossbar, register, row) is stored as a word of CROSSBAR_N partitions */
+        WORDS,
+        /** Every (crossbar, register, partition) is stored as bit-planes, a word holding 64 rows */
+        BITPLANES
+    };
+
+    /**
+     * The simulation backends supported by the simulator
+     */
+    enum Backend{
+        /** Every micro-operation is simulated at the gate level */
+        GATE_LEVEL,
+        /** Routines are executed natively on the stored words, and their micro-operations are only counted */
+        FUNCTIONAL,
+        /** Micro-operations are only counted, without accessing (or allocating) the memory state */
+        DRY_RUN
+    };
+
+    /**
+     * The native operations that a routine is equivalent to (used by the functional backend)
+     */
+    enum NativeOperation{
+        NONE, ADD, SUBTRACT, MULTIPLY, DIVIDE, MODULO, NEGATE, ABSOLUTE, SIGN, ZERO,
+        BITWISE_NOT, BITWISE_AND, BITWISE_OR, BITWISE_XOR, COPY
+    };
+
+    /**
+     * Describes a driver routine (the micro-operations between beginRoutine and endRoutine)
+     */
+    struct Routine {
+
+        /** The name of the routine */
+        const char *name;
+
+        /** The native operation that the routine is equivalent to, and whether it operates on floating-point words */
+        NativeOperation operation;
+        bool floating;
+
+        /** The input registers (regX, regY) and the output register (regZ) */
+        size_t regX, regY, regZ;
+
+    };
+
+    /**
+     * The execution statistics of a routine
+     */
+    struct RoutineStatistics {
+
+        /** The number of calls to the routine */
+        size_t calls;
+
+        /** The total number of micro-operations performed by the routine */
+        size_t microoperations;
+
+        /** The total number of cycles of the routine (micro-operations excluding mask updates) */
+        size_t cycles;
+
+    };
+
+    /**
+     * The micro-operation counts aggregated by the dry-run backend
+     */
+    struct DryRunStatistics {
+
+        /** The number of micro-operations of every type (indexed by MicrooperationType) */
+        size_t types[4];
+
+        /** The number of horizontal and vertical logic micro-operations of every gate (indexed by GateType) */
+        size_t horizontalGates[4], verticalGates[4];
+
+        /** The number of non-mask micro-operations by the number of active crossbars, and by the number of active rows */
+        std::map<size_t, size_t> crossbarMaskWidths, rowMaskWidths;
+
+    };
+
+    /**
+     * The cycle accounting of the issue queues. Every context (see pim/context.h) is an issue queue bound to its
+     * crossbars, and the queues of disjoint crossbars proceed concurrently (as the banks of a PIM controller), so that
+     * the elapsed cycles are the maximum across the queues rather than their sum. The micro-operations of the process
+     * context, which owns all crossbars, wait for every queue.
+     */
+    struct IssueStatistics {
+
+        /** The number of cycles (micro-operations excluding mask updates) issued by every queue, by context handle
+         * (0 for the process context) */
+        std::map<size_t, size_t> issuedCycles;
+
+        /** The elapsed cycles */
+        size_t elapsedCycles;
+
+    };
+
+    /**
+     * A pre-decoded micro-operation (or routine marker) of a graph
+     */
+    struct GraphOperation {
+
+        /** The kinds of graph operations */
+        enum Kind { MICROOPERATION, BEGIN_ROUTINE, END_ROUTINE };
+        Kind kind;
+
+        /** The micro-operation (or, for routine markers, the index of the routine in the graph) */
+        otype operation;
+
+        /** The bit offsets of the register fields of the micro-operation (-1 if unused) */
+        int8_t registers[3];
+
+    };
+
+    /**
+     * A captured micro-operation program that may be launched repeatedly with rebound registers and crossbars
+     */
+    struct Graph {
+
+        /** The validated and pre-decoded micro-operations, and the routines that they belong to */
+        std::vector<GraphOperation> operations;
+        std::vector<Routine> routines;
+
+        /** The execution statistics of a single launch of the graph */
+        std::map<std::string, RoutineStatistics> statistics;
+
+    };
+
+    /** The magic number at the start of a memory file */
+    constexpr char MEMORY_FILE_MAGIC[8] = {'P', 'I', 'M', 'S', 'T', 'A', 'T', 'E'};
+    /** The version of the memory file format */
+    constexpr uint32_t MEMORY_FILE_VERSION = 1;
+
+    /**
+     * The header of a memory file (see mapMemory). The header is followed by the user region (at userOffset) and by the
+     * memory state (at memoryOffset), stored in the layout and storage engine described by the header.
+     */
+    struct MemoryFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t logNumCrossbars, logCrossbarHeight, logCrossbarN, logCrossbarR;
+        uint32_t rowInterleaved, storageEngine;
+        uint64_t userOffset, userSize, memoryOffset, memorySize;
+    };
+
     /**
      * Performs the given micro-operation
      */
     dtype perform(otype operation);
 
+    /**
+     * Waits for the completion of all previously performed micro-operations
+     */
+    void synchronize();
+
+    /**
+     * Marks the start of a routine. The subsequent micro-operations are attributed to the routine.
+     * @param routine
+     */
+    void beginRoutine(const Routine& routine);
+
+    /**
+     * Marks the end of the current routine
+     */
+    void endRoutine();
+
+    /**
+     * Starts capturing the subsequent micro-operations and routine markers into a graph. The captured micro-operations
+     * are also performed (and thus validated); read micro-operations may not be captured.
+     */
+    void beginGraphCapture();
+
+    /**
+     * Ends the capture, returning the captured graph
+     * @return
+     */
+    Graph endGraphCapture();
+
+    /**
+     * Launches the given graph, without validating or decoding its micro-operations again
+     * @param graph
+     * @param registers maps registers of the graph to the registers to use instead (other registers are unchanged)
+     * @param crossbars if not null, replaces every crossbar mask of the graph
+     */
+    void launchGraph(const Graph& graph, const std::map<size_t, size_t>& registers, const RangeMask *crossbars);
+
+    /**
+     * Selects the simulation backend
+     * @param backend
+     * @param samplingPeriod for the functional backend, every samplingPeriod-th call of a routine is also simulated
+     * at the gate level and compared to the native execution (0 disables sampling)
+     */
+    void setBackend(Backend backend, size_t samplingPeriod = 0);
+
+    /**
+     * Returns the execution statistics of every routine since the last reset
+     * @return
+     */
+    std::map<std::string, RoutineStatistics> getStatistics();
+
+    /**
+     * Resets the execution statistics
+     */
+    void resetStatistics();
+
+    /**
+     * Returns the cycle accounting of the issue queues since the last reset
+     * @return
+     */
+    IssueStatistics getIssueStatistics();
+
+    /**
+     * Returns the micro-operation counts aggregated by the dry-run backend since the last reset
+     * @return
+     */
+    DryRunStatistics getDryRunStatistics();
+
+    /**
+     * Sets the value returned by read micro-operations in the dry-run backend
+     * @param placeholder
+     */
+    void setReadPlaceholder(dtype placeholder);
+
+    /**
+     * Takes a copy-on-write snapshot of the memory state (crossbars are copied only when first modified afterwards)
+     * @return the handle of the snapshot
+     */
+    size_t snapshotMemory();
+
+    /**
+     * Restores the memory state to the given snapshot (the snapshot remains valid)
+     * @param handle
+     */
+    void restoreMemory(size_t handle);
+
+    /**
+     * Releases the given snapshot
+     * @param handle
+     */
+    void releaseMemorySnapshot(size_t handle);
+
+    /**
+     * Maps the memory state from the given file (created if it does not exist), so that it is demand-paged from the file
+     * and persists across runs. An existing file replaces the current memory state, while a new file is initialized
+     * with it. The file also holds a user region of the given size (e.g., for the allocator state).
+     * @param path
+     * @param userSize
+     * @param created set to whether the file was created
+     * @return a host pointer to the user region
+     */
+    void *mapMemory(const std::string& path, size_t userSize, bool& created);
+
+    /**
+     * Unmaps the memory file, copying the memory state back to device memory
+     */
+    void unmapMemory();
+
+    /**
+     * Selects the storage engine of the simulator, converting the current memory state to the new engine
+     * @param engine
+     */
+    void setStorageEngine(StorageEngine engine);
+
+    /**
+     * Creates the simulator state of an execution context (see pim/context.h): its masks (initially, all of its
+     * crossbars and rows), its buffer of logic operations, and its current routine
+     * @param firstCrossbar
+     * @param numCrossbars
+     * @return the handle of the state
+     */
+    size_t createSimulatorContext(size_t firstCrossbar, size_t numCrossbars);
+
+    /**
+     * Destroys the simulator state of an execution context, performing its buffered logic operations
+     * @param handle
+     */
+    void destroySimulatorContext(size_t handle);
+
+    /**
+     * Selects the simulator state that the micro-operations of the calling thread are performed in (0 for the process
+     * context)
+     * @param handle
+     */
+    void selectSimulatorContext(size_t handle);
+
 }
 
 #endif // CUDAPIM_SIMULATOR_H
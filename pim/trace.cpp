@@ -0,0 +1,253 @@
+#include "trace.h"
+#include "async.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pim{
+
+    /** The size of the buffer that records are encoded into before being written to the file */
+    constexpr size_t TRACE_BUFFER_SIZE = 1 << 20;
+
+    /** Whether a trace is currently recorded */
+    bool tracing = false;
+    /** The trace file */
+    std::ofstream traceFile;
+    /** The encoded records that were not yet written to the file */
+    std::vector<uint8_t> traceBuffer;
+    /** The previous micro-operation of every type */
+    otype tracePrevious[4];
+    /** The indices of the routine names recorded so far */
+    std::unordered_map<std::string, size_t> traceNames;
+
+    /**
+     * Writes the encoded records to the file
+     */
+    void flushTrace(){
+        traceFile.write(reinterpret_cast<const char *>(traceBuffer.data()), (std::streamsize)traceBuffer.size());
+        traceBuffer.clear();
+    }
+
+    /**
+     * Encodes the given value as a varint (7 bits per byte, LSB first)
+     * @param value
+     */
+    void encodeVarint(uint64_t value){
+        while(value >= 0x80){
+            traceBuffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        traceBuffer.push_back((uint8_t)value);
+        if(traceBuffer.size() >= TRACE_BUFFER_SIZE) flushTrace();
+    }
+
+    /**
+     * Encodes the header of a record that is not a micro-operation
+     * @param type
+     * @param value
+     */
+    void encodeRecord(TraceRecord type, uint64_t value){
+        encodeVarint((value << 4) | ((uint64_t)type << 1) | 1);
+    }
+
+    void startTrace(const std::string& path){
+
+        drainQueue();
+        if(tracing) stopTrace();
+
+        traceFile.open(path, std::ios::binary | std::ios::trunc);
+        if(!traceFile){
+            throw std::runtime_error("Trace: failed to open " + path + ".");
+        }
+
+        // Write the header
+        TraceHeader header = {};
+        memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        header.logNumCrossbars = LOG_NUM_CROSSBARS;
+        header.logCrossbarHeight = LOG_CROSSBAR_HEIGHT;
+        header.logCrossbarN = LOG_CROSSBAR_N;
+        header.logCrossbarR = LOG_CROSSBAR_R;
+        traceFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        traceBuffer.reserve(TRACE_BUFFER_SIZE + 64);
+        memset(tracePrevious, 0, sizeof(tracePrevious));
+        traceNames.clear();
+        tracing = true;
+
+    }
+
+    void stopTrace(){
+
+        drainQueue();
+        if(!tracing) return;
+
+        flushTrace();
+        traceFile.close();
+        tracing = false;
+
+    }
+
+    bool isTracing(){
+        return tracing;
+    }
+
+    void traceOperation(otype operation){
+
+        // The type bits of the XOR are always zero, and are replaced by the record header
+        otype type = operation & 0x3;
+        otype delta = (operation ^ tracePrevious[type]) >> 2;
+        if(delta >> 61){
+            throw std::runtime_error("Trace: micro-operation exceeds the trace format.");
+        }
+        tracePrevious[type] = operation;
+        encodeVarint((delta << 3) | (type << 1));
+
+    }
+
+    void traceReadResult(dtype result){
+        encodeRecord(TraceRecord::READ_RESULT, result);
+    }
+
+    void traceBeginRoutine(const Routine& routine){
+
+        // Routine names are recorded on their first occurrence, and referenced by index afterwards
+        auto it = traceNames.find(routine.name);
+        bool first = it == traceNames.end();
+        size_t index = first ? (size_t)traceNames.size() : it->second;
+        encodeRecord(TraceRecord::BEGIN_ROUTINE, index);
+        if(first){
+            traceNames[routine.name] = index;
+            size_t length = (size_t)strlen(routine.name);
+            encodeVarint(length);
+            traceBuffer.insert(traceBuffer.end(), routine.name, routine.name + length);
+        }
+
+        encodeVarint(routine.operation);
+        encodeVarint(routine.floating);
+        encodeVarint(routine.regX);
+        encodeVarint(routine.regY);
+        encodeVarint(routine.regZ);
+
+    }
+
+    void traceEndRoutine(){
+        encodeRecord(TraceRecord::END_ROUTINE, 0);
+    }
+
+    TraceReader::TraceReader(const std::string& path) : data(nullptr), length(0), position(0), previous() {
+
+        // Map the file
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+            throw std::runtime_error("Trace: failed to open " + path + ".");
+        }
+        struct stat st = {};
+        fstat(fd, &st);
+        length = st.st_size;
+        if(length < (size_t)sizeof(TraceHeader)){
+            close(fd);
+            throw std::runtime_error("Trace: " + path + " is not a trace file.");
+        }
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(mapped == MAP_FAILED){
+            throw std::runtime_error("Trace: failed to map " + path + ".");
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t *>(mapped);
+
+        // Verify the header
+        TraceHeader header = {};
+        memcpy(&header, data, sizeof(header));
+        position = sizeof(header);
+        if(memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != TRACE_VERSION){
+            munmap(mapped, length);
+            throw std::runtime_error("Trace: " + path + " is not a trace file.");
+        }
+        if(header.logNumCrossbars != LOG_NUM_CROSSBARS || header.logCrossbarHeight != LOG_CROSSBAR_HEIGHT ||
+           header.logCrossbarN != LOG_CROSSBAR_N || header.logCrossbarR != LOG_CROSSBAR_R){
+            munmap(mapped, length);
+            throw std::runtime_error("Trace: " + path + " was recorded on a different memory geometry.");
+        }
+
+    }
+
+    TraceReader::~TraceReader(){
+        munmap(const_cast<uint8_t *>(data), length);
+    }
+
+    uint64_t TraceReader::varint(){
+        uint64_t value = 0;
+        for(int shift = 0; shift < 64; shift += 7){
+            if(position >= length){
+                throw std::runtime_error("Trace: truncated record.");
+            }
+            uint8_t byte = data[position++];
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if(!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Trace: invalid record.");
+    }
+
+    bool TraceReader::next(TraceEntry& entry){
+
+        if(position >= length) return false;
+
+        uint64_t header = varint();
+
+        // Micro-operation
+        if(!(header & 0x1)){
+            otype type = (header >> 1) & 0x3;
+            previous[type] ^= (header >> 3) << 2;
+            previous[type] = (previous[type] & ~(otype)0x3) | type;
+            entry.type = TraceRecord::OPERATION;
+            entry.operation = previous[type];
+            return true;
+        }
+
+        entry.type = (TraceRecord)((header >> 1) & 0x7);
+        uint64_t value = header >> 4;
+        switch(entry.type){
+
+            case TraceRecord::READ_RESULT:
+                entry.result = (dtype)value;
+                return true;
+
+            case TraceRecord::BEGIN_ROUTINE: {
+                if(value == (uint64_t)names.size()){
+                    size_t nameLength = (size_t)varint();
+                    if(nameLength > length - position){
+                        throw std::runtime_error("Trace: truncated record.");
+                    }
+                    names.emplace_back(reinterpret_cast<const char *>(data + position), nameLength);
+                    position += nameLength;
+                }
+                else if(value > (uint64_t)names.size()){
+                    throw std::runtime_error("Trace: invalid routine name.");
+                }
+                entry.routine.name = names[value].c_str();
+                entry.routine.operation = (NativeOperation)varint();
+                entry.routine.floating = varint() != 0;
+                entry.routine.regX = (size_t)varint();
+                entry.routine.regY = (size_t)varint();
+                entry.routine.regZ = (size_t)varint();
+                return true;
+            }
+
+            case TraceRecord::END_ROUTINE:
+                return true;
+
+            default:
+                throw std::runtime_error("Trace: invalid record.");
+
+        }
+
+    }
+
+}
@@ -0,0 +1,149 @@
+#ifndef CUDAPIM_TRACE_H
+#define CUDAPIM_TRACE_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "constants.h"
+#include "simulator.cuh"
+
+namespace pim{
+
+    /**
+     * The trace file format consists of a header (TraceHeader) followed by a stream of records, each starting with a
+     * varint whose LSB distinguishes micro-operations (0) from other records (1).
+     * Micro-operation: bits 1-2 are the micro-operation type, and the remaining bits are the XOR of the
+     * micro-operation with the previous micro-operation of the same type (without the type bits).
+     * Other records: bits 1-3 are the record type (TraceRecord), and the remaining bits are the record value.
+     */
+
+    /** The magic number at the start of a trace file */
+    constexpr char TRACE_MAGIC[8] = {'P', 'I', 'M', 'T', 'R', 'A', 'C', 'E'};
+    /** The version of the trace file format */
+    constexpr uint32_t TRACE_VERSION = 1;
+
+    /**
+     * The header of a trace file, containing the geometry of the memory that the trace was recorded on
+     */
+    struct TraceHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t logNumCrossbars, logCrossbarHeight, logCrossbarN, logCrossbarR;
+    };
+
+    /**
+     * The types of records in a trace
+     */
+    enum TraceRecord{
+        /** A micro-operation (value: the micro-operation) */
+        OPERATION,
+        /** The result of the preceding read micro-operation (value: the result) */
+        READ_RESULT,
+        /** The start of a routine (value: the index of the routine name, followed by the routine description) */
+        BEGIN_ROUTINE,
+        /** The end of the current routine */
+        END_ROUTINE
+    };
+
+    /**
+     * A decoded trace record
+     */
+    struct TraceEntry {
+        TraceRecord type;
+        otype operation;
+        dtype result;
+        Routine routine;
+    };
+
+    /**
+     * Starts recording every micro-operation (with read results and routine markers) to the given trace file
+     * @param path
+     */
+    void startTrace(const std::string& path);
+
+    /**
+     * Stops recording the trace, flushing it to the file
+     */
+    void stopTrace();
+
+    /**
+     * Whether a trace is currently recorded
+     * @return
+     */
+    bool isTracing();
+
+    /**
+     * Records the given micro-operation
+     * @param operation
+     */
+    void traceOperation(otype operation);
+
+    /**
+     * Records the result of the preceding read micro-operation
+     * @param result
+     */
+    void traceReadResult(dtype result);
+
+    /**
+     * Records the start of the given routine
+     * @param routine
+     */
+    void traceBeginRoutine(const Routine& routine);
+
+    /**
+     * Records the end of the current routine
+     */
+    void traceEndRoutine();
+
+    /**
+     * Sequentially decodes a memory-mapped trace file
+     */
+    class TraceReader {
+
+    public:
+
+        /**
+         * Maps the given trace file, verifying that it was recorded on the current memory geometry
+         * @param path
+         */
+        explicit TraceReader(const std::string& path);
+
+        ~TraceReader();
+
+        TraceReader(const TraceReader&) = delete;
+        TraceReader& operator=(const TraceReader&) = delete;
+
+        /**
+         * Decodes the next record of the trace
+         * @param entry
+         * @return false if the end of the trace was reached
+         */
+        bool next(TraceEntry& entry);
+
+        /**
+         * The size of the trace file in bytes
+         * @return
+         */
+        size_t size() const { return length; }
+
+    private:
+
+        /** The mapped trace file, its length, and the current position */
+        const uint8_t *data;
+        size_t length;
+        size_t position;
+
+        /** The previous micro-operation of every type */
+        otype previous[4];
+
+        /** The names of the routines in the trace (a deque, as the routines point to the names) */
+        std::deque<std::string> names;
+
+        /** Decodes a varint at the current position */
+        uint64_t varint();
+
+    };
+
+}
+
+#endif // CUDAPIM_TRACE_H
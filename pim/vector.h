@@ -1,11 +1,21 @@
 #ifndef CUDAPIM_VECTOR_H
 #define CUDAPIM_VECTOR_H
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include "constants.h"
+#include "bigint.h"
 #include "memory.h"
 #include "driver.h"
+#include "fixed.h"
+#include "floating.h"
+#include "mask.h"
+#include "packed.h"
 
 namespace pim {
 
@@ -21,44 +31,178 @@ namespace pim {
         /** The total length of the vector */
         size_t n;
 
-        /** The memory address of the vector */
+        /** The memory address of the vector (of the first words, for the elements wider than a word) */
         address vec;
 
+        /** The memory addresses of the following words of the elements wider than a word (otherwise, empty), e.g., of
+         * the high words of int64_t */
+        std::vector<address> upper;
+
         /** The current row mask */
         RangeMask curr_mask = ALL_ROWS;
 
+        /** Whether the elements are narrower than the words (and are thus stored extended, see pim/generator.h), except
+         * for the masks (which are stored in a single partition) */
+        static constexpr bool narrow = sizeof(T) < sizeof(dtype) && !isMask<T>::value;
+
+        /** Whether the elements are wider than the words (and are thus stored in register pairs, see pim/constants.h),
+         * except for the big integers (whose words are stored in consecutive rows) */
+        static constexpr bool wide = sizeof(T) > sizeof(dtype) && !isBigInt<T>::value;
+
+        /** The number of words (co-located registers) of every element */
+        static constexpr size_t words = wide ? sizeof(T) / sizeof(dtype) : 1;
+
+        /** The number of consecutive rows of every element (the words of the big integers, see pim::RegisterRows) */
+        static constexpr size_t height = isBigInt<T>::value ? sizeof(T) / sizeof(dtype) : 1;
+
+        /** The rows between consecutive elements: the height of the elements, or that of the compared elements for
+         * their masks (whose predicates are stored at the first row of every element) */
+        size_t stride = height;
+
+        /** The type of the results of sign and zero (the masks of the lanes of packed elements, and masks for the big
+         * integers) */
+        typedef typename std::conditional<isPacked<T>::value, T,
+                typename std::conditional<isBigInt<T>::value, mask, int>::type>::type mask_t;
+
+        /** The type of the comparisons (fixed-point numbers are compared through their extension, while narrow integers
+         * are compared by routines of their width) */
+        typedef typename std::conditional<isFixed<T>::value, int, T>::type comparison_t;
+
+        /**
+         * Returns the word that stores the given element (the given word of the elements wider than a word)
+         * @param x
+         * @param word
+         * @return
+         */
+        static dtype toWord(T x, size_t word = 0){
+            if constexpr (narrow && std::is_integral<T>::value) return (dtype) x;
+            else if constexpr (isFixed<T>::value) return (dtype) (int32_t) x.raw;
+            else if constexpr (isNarrowFloat<T>::value) return (dtype) x.bits;
+            else if constexpr (isBigInt<T>::value) return x.word[word];
+            else if constexpr (wide){
+                dtype result;
+                std::memcpy(&result, (const char*) &x + sizeof(dtype) * word, sizeof(dtype));
+                return result;
+            }
+            else{
+                dtype result = 0;
+                std::memcpy(&result, &x, sizeof(T));
+                return result;
+            }
+        }
+
+        /**
+         * Returns the element stored in the given word (in the given words, the first word first, for the elements wider
+         * than a word and the big integers)
+         * @param word
+         * @param following the following words (of the elements wider than a word and of the big integers)
+         * @return
+         */
+        static T fromWord(dtype word, const dtype* following = nullptr){
+            if constexpr (narrow && std::is_integral<T>::value) return (T) word;
+            else if constexpr (isFixed<T>::value){
+                T x;
+                x.raw = (decltype(x.raw)) word;
+                return x;
+            }
+            else if constexpr (isNarrowFloat<T>::value){
+                T x;
+                x.bits = (decltype(x.bits)) word;
+                return x;
+            }
+            else if constexpr (isBigInt<T>::value){
+                T x;
+                x.word[0] = word;
+                for(size_t k = 1; k < height; k++) x.word[k] = following[k - 1];
+                return x;
+            }
+            else if constexpr (wide){
+                T x;
+                std::memcpy(&x, &word, sizeof(dtype));
+                std::memcpy((char*) &x + sizeof(dtype), following, sizeof(T) - sizeof(dtype));
+                return x;
+            }
+            else{
+                T x;
+                std::memcpy(&x, &word, sizeof(T));
+                return x;
+            }
+        }
+
         /**
          * Constructs and allocates an empty vector
          * @param n
          */
-        explicit vector(size_t n, T val = T()) : n(n), vec(malloc(n)){
-            write({vec.startArray, vec.endArray, 1}, vec.reg, curr_mask, val);
+        explicit vector(size_t n, T val = T()) : vector(n, allocate(n)){
+            if constexpr (isMask<T>::value){
+                maskInit(registers(), val.value, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return;
+            }
+            if constexpr (isBigInt<T>::value){
+                // Word k of every element in turn (the step of a single element is arbitrary)
+                RangeMask rows = rowMask();
+                size_t step = rows.stop - rows.start + 1 > height ? height : 1;
+                for(size_t k = 0; k < height; k++){
+                    write({vec.startArray, vec.endArray - 1, 1}, vec.reg, {rows.start + k, rows.stop + 1 - height + k, step},
+                          toWord(val, k));
+                }
+                return;
+            }
+            write({vec.startArray, vec.endArray - 1, 1}, vec.reg, rowMask(), toWord(val));
+            for(size_t k = 1; k < words; k++) write({vec.startArray, vec.endArray - 1, 1}, upper[k - 1].reg, rowMask(), toWord(val, k));
         }
 
         /**
          * Constructs the vector as a copy of the given std::vector
          * @param other
          */
-        vector(const vector& other) : n(other.n), vec(malloc(n)) {
-            copy(other.vec.reg, vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+        vector(const vector& other) : vector(other.n, allocate(other.n, other.stride), other.stride) {
+            if constexpr (isMask<T>::value){
+                maskCopy(other.registers(), registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return;
+            }
+            copy(other.vec.reg, vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            for(size_t k = 1; k < words; k++) copy(other.upper[k - 1].reg, upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
         }
 
         /**
          * Constructs the vector as a copy of the given vector
          * @param other
          */
-        vector(const std::vector<T>& other) : n(other.size()), vec(malloc(n)) {
+        vector(const std::vector<T>& other) : vector(other.size(), allocate(other.size())) {
             for(size_t i = 0; i < n; i++){
                 (*this)[i] = other[i];
             }
         }
 
+        /**
+         * Constructs the vector as the conversion of the given vector of another floating-point type (e.g., float to
+         * half)
+         * @param other
+         */
+        template <class S, class = typename std::enable_if<!isMask<S>::value>::type>
+        explicit vector(const vector<S>& other) : vector(other.n, allocate(other.n)) {
+            convert<T, S>(other.registers(), registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+        }
+
+        /**
+         * Constructs the vector as the expansion of the given vector of masks (all-one if set, and zero otherwise, as
+         * the results of the comparisons of int)
+         * @param other
+         */
+        template <class M, typename std::enable_if<isMask<M>::value && std::is_same<T, int>::value, int>::type = 0>
+        vector(const vector<M>& other) : vector(other.n, allocate(other.n)) {
+            if(other.stride != 1) throw std::runtime_error("pim::vector: masks of elements of several rows are not expanded.");
+            maskExpand(other.registers(), vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+        }
+
         /**
          * Move constructor
          * @param other
          */
-        vector(vector&& other)  noexcept : n(other.n), vec(other.vec) {
+        vector(vector&& other)  noexcept : n(other.n), vec(other.vec), upper(std::move(other.upper)), stride(other.stride) {
             other.vec.reg = -1;
+            other.upper.clear();
         }
 
         /**
@@ -69,7 +213,12 @@ namespace pim {
         vector& operator=(const vector& other){
             if(this == &other)
                 return *this;
-            copy(other.vec.reg, vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            if constexpr (isMask<T>::value){
+                maskCopy(other.registers(), registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return *this;
+            }
+            copy(other.vec.reg, vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            for(size_t k = 1; k < words; k++) copy(other.upper[k - 1].reg, upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return *this;
         }
 
@@ -90,6 +239,7 @@ namespace pim {
          */
         ~vector(){
             free(vec);
+            for(address word : upper) free(word);
         }
 
         /**
@@ -100,6 +250,59 @@ namespace pim {
             return n;
         }
 
+        /**
+         * Returns the registers of the vector (a register pair for the elements wider than a word, the rows of a
+         * register for the big integers, and a partition of a register for the masks)
+         * @return
+         */
+        auto registers() const{
+            if constexpr (isMask<T>::value) return RegisterBit{vec.reg, vec.partition};
+            else if constexpr (isBigInt<T>::value) return RegisterRows{vec.reg, height};
+            else if constexpr (wide) return RegisterPair{vec.reg, upper[0].reg};
+            else return vec.reg;
+        }
+
+        /**
+         * Writes the given element to the given position
+         * @param pos
+         * @param x
+         */
+        void store(size_t pos, T x){
+            size_t crossbar = vec.startArray + pos * stride / pim::warpSize(), row = pos * stride % pim::warpSize();
+            if constexpr (isMask<T>::value){
+                // Only the partition of the vector is written, as the other partitions store other vectors
+                dtype word = read(crossbar, vec.reg, row);
+                word = (word & ~((dtype) 1 << vec.partition)) | ((dtype) (bool) x << vec.partition);
+                write(crossbar, vec.reg, row, word);
+                return;
+            }
+            write(crossbar, vec.reg, row, toWord(x));
+            for(size_t k = 1; k < words; k++) write(crossbar, upper[k - 1].reg, row, toWord(x, k));
+            for(size_t k = 1; k < height; k++) write(crossbar, vec.reg, row + k, toWord(x, k));
+        }
+
+        /**
+         * Reads the element at the given position
+         * @param pos
+         * @return
+         */
+        T load(size_t pos) const{
+            size_t crossbar = vec.startArray + pos * stride / pim::warpSize(), row = pos * stride % pim::warpSize();
+            dtype res = read(crossbar, vec.reg, row);
+            if constexpr (isMask<T>::value) return T((res >> vec.partition) & 1);
+            else if constexpr (isBigInt<T>::value){
+                dtype following[height - 1];
+                for(size_t k = 1; k < height; k++) following[k - 1] = read(crossbar, vec.reg, row + k);
+                return fromWord(res, following);
+            }
+            else if constexpr (wide){
+                dtype following[words - 1];
+                for(size_t k = 1; k < words; k++) following[k - 1] = read(crossbar, upper[k - 1].reg, row);
+                return fromWord(res, following);
+            }
+            else return fromWord(res);
+        }
+
         /**
          * A reference to an element in the vector (used to support vec[x] = y)
          */
@@ -122,7 +325,7 @@ namespace pim {
              * @return
              */
             reference& operator=(T x){
-                write(vec.vec.startArray + pos / pim::warpSize(), vec.vec.reg, pos % pim::warpSize(), reinterpret_cast<dtype &>(x));
+                vec.store(pos, x);
                 return *this;
             }
 
@@ -132,8 +335,7 @@ namespace pim {
              * @return
              */
             reference& operator=(const reference& other){
-                T val = *other;
-                write(vec.vec.startArray + pos / pim::warpSize(), vec.vec.reg, pos % pim::warpSize(), reinterpret_cast<dtype &>(val));
+                vec.store(pos, *other);
                 return *this;
             }
 
@@ -142,8 +344,7 @@ namespace pim {
              * @return
              */
             operator T() const{
-                dtype res = read(vec.vec.startArray + pos / pim::warpSize(), vec.vec.reg, pos % pim::warpSize());
-                return reinterpret_cast<T &>(res);
+                return vec.load(pos);
             }
 
             reference& operator++(){
@@ -151,8 +352,7 @@ namespace pim {
                 return *this;
             }
             T operator*() const{
-                dtype res = read(vec.vec.startArray + pos / pim::warpSize(), vec.vec.reg, pos % pim::warpSize());
-                return reinterpret_cast<T &>(res);
+                return vec.load(pos);
             }
 
             friend bool operator== (const reference& a, const reference& b) { return a.pos == b.pos; };
@@ -174,8 +374,7 @@ namespace pim {
          * @return
          */
         T operator[](size_t pos) const{
-            dtype res = read(vec.startArray + pos / pim::warpSize(), vec.reg, pos % pim::warpSize());
-            return reinterpret_cast<T &>(res);
+            return load(pos);
         }
 
         reference begin() {
@@ -192,7 +391,7 @@ namespace pim {
          */
         vector operator+(const vector& other) const{
             vector res(n);
-            add<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            add<T>(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -202,7 +401,7 @@ namespace pim {
          */
         vector operator-() const{
             vector res(n);
-            negate<T>(vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            negate<T>(registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -212,7 +411,7 @@ namespace pim {
          */
         vector abs() const{
             vector res(n);
-            absolute<T>(vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            absolute<T>(registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -223,7 +422,7 @@ namespace pim {
          */
         vector operator-(const vector& other) const{
             vector res(n);
-            subtract<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            subtract<T>(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -234,7 +433,21 @@ namespace pim {
          */
         vector operator*(const vector& other) const{
             vector res(n);
-            multiply<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            multiply<T>(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            return std::move(res);
+        }
+
+        /**
+         * Performs element-parallel multiplication with another vector, returning the high halves of the (double-width)
+         * products
+         * @param other
+         * @return
+         */
+        vector mulhi(const vector& other) const{
+            static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value && !wide,
+                    "pim::vector: the high half of the product requires unsigned integers.");
+            vector res(n);
+            multiplyHigh<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -244,8 +457,11 @@ namespace pim {
          * @return
          */
         vector operator/(const vector& other) const{
+            static_assert(!isPacked<T>::value, "pim::vector: division of packed elements is not supported.");
+            static_assert(!isFixed<T>::value, "pim::vector: division of fixed-point elements is not supported.");
+            static_assert(!isBigInt<T>::value, "pim::vector: division of big integers is not supported.");
             vector res(n);
-            divide<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            divide<T>(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -255,8 +471,11 @@ namespace pim {
          * @return
          */
         vector operator%(const vector& other) const{
+            static_assert(!isPacked<T>::value, "pim::vector: division of packed elements is not supported.");
+            static_assert(!isFixed<T>::value, "pim::vector: division of fixed-point elements is not supported.");
+            static_assert(!isBigInt<T>::value, "pim::vector: division of big integers is not supported.");
             vector res(n);
-            modulo<T>(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            modulo<T>(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -266,8 +485,23 @@ namespace pim {
          * @return
          */
         vector operator~() const{
+            if constexpr (isMask<T>::value){
+                vector res = like();
+                maskNot(registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
             vector res(n);
-            bitwiseNot(vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            if constexpr (narrow && std::is_unsigned<T>::value){
+                // Complement only the bits of the elements, so that they remain zero-extended
+                vector ones(n, std::numeric_limits<T>::max());
+                bitwiseXor(vec.reg, ones.vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            }
+            else{
+                bitwiseNot(vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                for(size_t k = 1; k < words; k++){
+                    bitwiseNot(upper[k - 1].reg, res.upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                }
+            }
             return std::move(res);
         }
 
@@ -278,8 +512,19 @@ namespace pim {
          */
         template <class O>
         vector operator|(const vector<O>& other) const{
+            if constexpr (isMask<T>::value){
+                static_assert(isMask<O>::value, "pim::vector: masks are only combined with masks.");
+                vector res = like();
+                maskOr(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
             vector res(n);
-            bitwiseOr(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            bitwiseOr(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            if constexpr (wide){
+                for(size_t k = 1; k < words; k++){
+                    bitwiseOr(upper[k - 1].reg, other.upper[k - 1].reg, res.upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                }
+            }
             return std::move(res);
         }
 
@@ -290,8 +535,19 @@ namespace pim {
          */
         template <class O>
         vector operator&(const vector<O>& other) const{
+            if constexpr (isMask<T>::value){
+                static_assert(isMask<O>::value, "pim::vector: masks are only combined with masks.");
+                vector res = like();
+                maskAnd(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
             vector res(n);
-            bitwiseAnd(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            bitwiseAnd(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            if constexpr (wide){
+                for(size_t k = 1; k < words; k++){
+                    bitwiseAnd(upper[k - 1].reg, other.upper[k - 1].reg, res.upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                }
+            }
             return std::move(res);
         }
 
@@ -302,8 +558,19 @@ namespace pim {
          */
         template <class O>
         vector operator^(const vector<O>& other) const{
+            if constexpr (isMask<T>::value){
+                static_assert(isMask<O>::value, "pim::vector: masks are only combined with masks.");
+                vector res = like();
+                maskXor(registers(), other.registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
             vector res(n);
-            bitwiseXor(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+            bitwiseXor(vec.reg, other.vec.reg, res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+            if constexpr (wide){
+                for(size_t k = 1; k < words; k++){
+                    bitwiseXor(upper[k - 1].reg, other.upper[k - 1].reg, res.upper[k - 1].reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                }
+            }
             return std::move(res);
         }
 
@@ -312,9 +579,9 @@ namespace pim {
          * @param other
          * @return
          */
-        vector<int> sign() const{
-            vector<int> res(n);
-            pim::sign<T>(vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
+        vector<mask_t> sign() const{
+            vector<mask_t> res(n);
+            pim::sign<T>(registers(), res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
             return std::move(res);
         }
 
@@ -323,65 +590,67 @@ namespace pim {
          * @param other
          * @return
          */
-        vector<int> zero() const{
-            vector<int> res(n);
-            pim::zero<T>(vec.reg, res.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return std::move(res);
+        vector<mask_t> zero() const{
+            if constexpr (isBigInt<T>::value){
+                vector<mask> res = masks();
+                pim::zero<T>(registers(), res.registers(), {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
+            else{
+                vector<mask_t> res(n);
+                pim::zero<T>(registers(), res.vec.reg, {vec.startArray, vec.endArray - 1, 1}, rowMask());
+                return std::move(res);
+            }
         }
 
         /**
-         * Performs element-parallel comparison with another vector
+         * Performs element-parallel comparison with another vector (the result is undefined for NaN elements of
+         * floating-point vectors)
          * @param other
          * @return
          */
-        vector<int> operator<(const vector& other) const{
-            vector temp(n);
-            subtract<T>(vec.reg, other.vec.reg, temp.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return temp.sign();
+        vector<mask> operator<(const vector& other) const{
+            return compare(other, false, Predicate::NEGATIVE);
         }
 
         /**
-         * Performs element-parallel comparison with another vector
+         * Performs element-parallel comparison with another vector, as the negation of other < *this (the result is
+         * undefined for NaN elements of floating-point vectors, e.g., true)
          * @param other
          * @return
          */
-        vector<int> operator<=(const vector& other) const{
-            vector temp(n);
-            subtract<T>(vec.reg, other.vec.reg, temp.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return temp.sign() | temp.zero();
+        vector<mask> operator<=(const vector& other) const{
+            return compare(other, false, Predicate::NON_POSITIVE);
         }
 
         /**
-         * Performs element-parallel comparison with another vector
+         * Performs element-parallel comparison with another vector (the result is undefined for NaN elements of
+         * floating-point vectors)
          * @param other
          * @return
          */
-        vector<int> operator>(const vector& other) const{
-            vector temp(n);
-            subtract<T>(other.vec.reg, vec.reg, temp.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return temp.sign();
+        vector<mask> operator>(const vector& other) const{
+            return compare(other, true, Predicate::NEGATIVE);
         }
 
         /**
-         * Performs element-parallel comparison with another vector
+         * Performs element-parallel comparison with another vector, as the negation of *this < other (the result is
+         * undefined for NaN elements of floating-point vectors, e.g., true)
          * @param other
          * @return
          */
-        vector<int> operator>=(const vector& other) const{
-            vector temp(n);
-            subtract<T>(other.vec.reg, vec.reg, temp.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return temp.sign() | temp.zero();
+        vector<mask> operator>=(const vector& other) const{
+            return compare(other, true, Predicate::NON_POSITIVE);
         }
 
         /**
-         * Performs element-parallel comparison with another vector
+         * Performs element-parallel comparison with another vector (the result is undefined for NaN elements of
+         * floating-point vectors)
          * @param other
          * @return
          */
-        vector<int> operator==(const vector& other) const{
-            vector temp(n);
-            subtract<T>(vec.reg, other.vec.reg, temp.vec.reg, {vec.startArray, vec.endArray, 1}, curr_mask);
-            return temp.zero();
+        vector<mask> operator==(const vector& other) const{
+            return compare(other, false, Predicate::ZERO);
         }
 
         /**
@@ -390,7 +659,10 @@ namespace pim {
          * @param outputThread
          */
         void warpMove(size_t inputThread, size_t outputThread){
-            pim::warpMove(inputThread, outputThread, vec.reg, {vec.startArray, vec.endArray, 1});
+            static_assert(!isMask<T>::value, "pim::vector: warp moves of masks are not supported (as they share their registers).");
+            static_assert(!isBigInt<T>::value, "pim::vector: warp moves of big integers are not supported (as they span several rows).");
+            pim::warpMove(inputThread, outputThread, vec.reg, {vec.startArray, vec.endArray - 1, 1});
+            for(address word : upper) pim::warpMove(inputThread, outputThread, word.reg, {vec.startArray, vec.endArray - 1, 1});
         }
 
         /**
@@ -400,6 +672,88 @@ namespace pim {
             curr_mask = mask;
         }
 
+    private:
+
+        /**
+         * Performs element-parallel comparison with another vector (with the operands swapped, if required), as the given
+         * predicate of their difference x - y (without forming the difference), where x <= y is the negation of y < x
+         * @param other
+         * @param swap
+         * @param predicate
+         * @return
+         */
+        vector<mask> compare(const vector& other, bool swap, Predicate predicate) const{
+            static_assert(!isPacked<T>::value, "pim::vector: comparison of packed elements is not supported.");
+            vector<mask> res = masks();
+            const vector& x = swap ? other : *this;
+            const vector& y = swap ? *this : other;
+            RangeMask crossbars(vec.startArray, vec.endArray - 1, 1);
+            if(predicate == Predicate::ZERO){
+                equal<comparison_t>(x.registers(), y.registers(), res.registers(), false, crossbars, rowMask());
+            }
+            else{
+                bool negate = predicate == Predicate::NON_POSITIVE;
+                less<comparison_t>((negate ? y : x).registers(), (negate ? x : y).registers(), res.registers(), negate,
+                                   crossbars, rowMask());
+            }
+            return std::move(res);
+        }
+
+        /** The vectors of the masks of the comparisons are constructed with the stride of the compared elements */
+        template <typename> friend class vector;
+
+        /**
+         * Constructs the vector at the given addresses (the following are of the following words of the wide elements)
+         * @param n
+         * @param addresses
+         * @param stride
+         */
+        vector(size_t n, const std::vector<address>& addresses, size_t stride = height) : n(n), vec(addresses[0]),
+                upper(addresses.begin() + 1, addresses.end()), stride(stride) {}
+
+        /**
+         * Allocates the addresses of a vector of size n (co-located registers for the elements wider than a word, and
+         * consecutive rows for the big integers)
+         * @param n
+         * @param stride
+         * @return
+         */
+        static std::vector<address> allocate(size_t n, size_t stride = height){
+            if constexpr (isMask<T>::value) return {mallocPartition(n * stride)};
+            else if constexpr (wide) return malloc(n, words);
+            else return {malloc(n * stride)};
+        }
+
+        /**
+         * Returns the row mask of the routines of the vector: the current row mask, or the rows of the elements that it
+         * selects for the elements of several rows (which requires a contiguous mask)
+         * @return
+         */
+        RangeMask rowMask() const{
+            if(stride == 1) return curr_mask;
+            if(curr_mask.step != 1) throw std::runtime_error("pim::vector: the row masks of elements of several rows must be contiguous.");
+            size_t last = std::min(curr_mask.stop, CROSSBAR_HEIGHT / stride - 1);
+            return {curr_mask.start * stride, last * stride + stride - 1, 1};
+        }
+
+        /**
+         * Allocates an uninitialized vector of the size and the stride of the vector (e.g., for the results of masks)
+         * @return
+         */
+        vector like() const{
+            return vector(n, allocate(n, stride), stride);
+        }
+
+        /**
+         * Constructs a vector of masks of the elements of the vector (cleared, at the first row of every element)
+         * @return
+         */
+        vector<mask> masks() const{
+            vector<mask> res(n, vector<mask>::allocate(n, stride), stride);
+            maskInit(res.registers(), false, {res.vec.startArray, res.vec.endArray - 1, 1}, res.rowMask());
+            return std::move(res);
+        }
+
     };
 
 }
@@ -1,7 +1,19 @@
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <sys/stat.h>
 #include "../pim/vector.h"
+#include "../pim/algorithm.h"
+#include "../pim/simulator.cuh"
+#include "../pim/async.h"
+#include "../pim/context.h"
+#include "../pim/shard.h"
+#include "../pim/trace.h"
 
 constexpr long NUM_ITERATIONS = 64 * 1024;
 
@@ -11,6 +23,12 @@ int randInt(){
 float randFloat(){
     return (float(rand()) / float(RAND_MAX)) - 0.5f;
 }
+int64_t randLong(){
+    return (int64_t) (((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand());
+}
+double randDouble(){
+    return (double(randLong()) / double(std::numeric_limits<int64_t>::max())) - 0.5;
+}
 
 void testIntegerAddition(){
 
@@ -352,6 +370,876 @@ void testBitwiseXOR(){
 
 }
 
+/**
+ * Tests the routines of the given narrow integer type against the host
+ * @tparam T
+ */
+template <class T>
+void testNarrowIntegers(){
+
+    // Initialize the vectors (with non-zero divisors, avoiding the overflow of the division)
+    pim::vector<T> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<T> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = (T) randInt(); ys[i] = (T) randInt();
+        if(ys[i] == 0 || (ys[i] == (T) -1 && xs[i] == std::numeric_limits<T>::min())) ys[i] = 1;
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Perform the computation
+    pim::vector<T> sum = x + y, difference = x - y, product = x * y, quotient = x / y, remainder = x % y;
+    pim::vector<T> negation = -x, abs = x.abs(), complement = ~x;
+    pim::vector<int> lt = x < y, ge = x >= y, eq = x == y;
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        T a = xs[i], b = ys[i];
+        assert(sum[i] == (T) (a + b));
+        assert(difference[i] == (T) (a - b));
+        assert(product[i] == (T) (a * b));
+        assert(quotient[i] == (T) (a / b));
+        assert(remainder[i] == (T) (a % b));
+        assert(negation[i] == (T) (-a));
+        assert(abs[i] == (T) (a < 0 ? -a : a));
+        assert(complement[i] == (T) (~a));
+        assert(lt[i] == (a < b ? -1 : 0));
+        assert(ge[i] == (a >= b ? -1 : 0));
+        assert(eq[i] == (a == b ? -1 : 0));
+    }
+
+    std::cout << "Passed testNarrowIntegers<" << (std::is_signed<T>::value ? "int" : "uint") << 8 * sizeof(T) << ">!" << std::endl;
+
+}
+
+void testUnsignedIntegers(){
+
+    // Initialize the vectors (with non-zero divisors of several magnitudes, and some equal elements)
+    pim::vector<uint32_t> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<uint32_t> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = ((uint32_t) randInt() << 16) ^ (uint32_t) randInt(); ys[i] = (((uint32_t) randInt() << 16) ^ (uint32_t) randInt()) >> (i % 32);
+        if(i % 8 == 0) ys[i] = xs[i];
+        if(ys[i] == 0) ys[i] = 1;
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Perform the computation
+    pim::vector<uint32_t> quotient = x / y, remainder = x % y, high = x.mulhi(y);
+    pim::vector<int> lt = x < y, le = x <= y, gt = x > y, eq = x == y;
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        uint32_t a = xs[i], b = ys[i];
+        assert(quotient[i] == a / b);
+        assert(remainder[i] == a % b);
+        assert(high[i] == (uint32_t) (((uint64_t) a * b) >> 32));
+        assert(lt[i] == (a < b ? -1 : 0));
+        assert(le[i] == (a <= b ? -1 : 0));
+        assert(gt[i] == (a > b ? -1 : 0));
+        assert(eq[i] == (a == b ? -1 : 0));
+    }
+
+    std::cout << "Passed testUnsignedIntegers!" << std::endl;
+
+}
+
+/**
+ * Tests the routines of the given fixed-point type against the host (saturating the exact results)
+ * @tparam T
+ */
+template <class T>
+void testFixed(){
+
+    // Initialize the vectors (with some extreme and equal elements)
+    pim::vector<T> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<T> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i].raw = (decltype(xs[i].raw)) randInt(); ys[i].raw = (decltype(ys[i].raw)) randInt();
+        if(i % 8 == 0) xs[i].raw = T::minRaw;
+        if(i % 8 == 1) ys[i].raw = T::maxRaw;
+        if(i % 8 == 2) ys[i] = xs[i];
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Perform the computation
+    pim::vector<T> sum = x + y, difference = x - y, product = x * y, negation = -x, abs = x.abs();
+    pim::vector<int> lt = x < y, eq = x == y;
+
+    // Verify the results
+    auto saturate = [](int64_t raw){ return std::min<int64_t>(std::max<int64_t>(raw, T::minRaw), T::maxRaw); };
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        int64_t a = xs[i].raw, b = ys[i].raw;
+        T s = sum[i], d = difference[i], p = product[i], ng = negation[i], ab = abs[i];
+        assert(s.raw == saturate(a + b));
+        assert(d.raw == saturate(a - b));
+        assert(p.raw == saturate((a * b) >> T::fraction));
+        assert(ng.raw == saturate(-a));
+        assert(ab.raw == saturate(a < 0 ? -a : a));
+        assert(lt[i] == (a < b ? -1 : 0));
+        assert(eq[i] == (a == b ? -1 : 0));
+    }
+
+    std::cout << "Passed testFixed<Q" << T::integer << "." << T::fraction << ">!" << std::endl;
+
+}
+
+/**
+ * Tests the routines of the given narrow floating-point type against the host (rounding the float results)
+ * @tparam T
+ */
+template <class T>
+void testNarrowFloats(){
+
+    // Initialize the vectors (with non-zero divisors, and some equal elements)
+    pim::vector<T> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    pim::vector<float> f(NUM_ITERATIONS);
+    std::vector<T> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    std::vector<float> fs(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = T(randFloat()); ys[i] = T(randFloat() * 100.0f); fs[i] = randFloat() * 1000.0f;
+        if(i % 8 == 0) ys[i] = xs[i];
+        if((float) ys[i] == 0.0f) ys[i] = T(1.0f);
+        x[i] = xs[i]; y[i] = ys[i]; f[i] = fs[i];
+    }
+
+    // Perform the computation
+    pim::vector<T> sum = x + y, difference = x - y, product = x * y, quotient = x / y, negation = -x, abs = x.abs();
+    pim::vector<int> lt = x < y, eq = x == y;
+    pim::vector<T> narrowed(f);
+    pim::vector<float> widened(x);
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        float a = xs[i], b = ys[i];
+        T s = sum[i], d = difference[i], p = product[i], q = quotient[i], ng = negation[i], ab = abs[i], nw = narrowed[i];
+        assert(s.bits == T(a + b).bits);
+        assert(d.bits == T(a - b).bits);
+        assert(p.bits == T(a * b).bits);
+        assert(q.bits == T(a / b).bits);
+        assert((float) ng == -a);
+        assert((float) ab == std::abs(a));
+        assert(lt[i] == (a < b ? -1 : 0));
+        assert(eq[i] == (xs[i].bits == ys[i].bits ? -1 : 0));
+        assert(nw.bits == T(fs[i]).bits);
+        assert(widened[i] == a);
+    }
+
+    std::cout << "Passed testNarrowFloats<E" << T::exponent << "M" << T::mantissa << ">!" << std::endl;
+
+}
+
+/**
+ * Tests the routines of the given packed integer type against the host (lane-wise)
+ * @tparam T
+ * @tparam L
+ */
+template <class T, pim::size_t L>
+void testPackedIntegers(){
+
+    // Initialize the vectors
+    typedef pim::packed<T, L> P;
+    pim::vector<P> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<P> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        for(int k = 0; k < L; k++){
+            xs[i][k] = (T) randInt(); ys[i][k] = (T) randInt();
+        }
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Perform the computation
+    pim::vector<P> sum = x + y, difference = x - y, product = x * y, negation = -x, abs = x.abs(), sign = x.sign();
+    pim::vector<P> zero = (x - x).zero();
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        P s = sum[i], d = difference[i], p = product[i], ng = negation[i], ab = abs[i], sg = sign[i], z = zero[i];
+        for(int k = 0; k < L; k++){
+            T a = xs[i][k], b = ys[i][k];
+            assert(s[k] == (T) (a + b));
+            assert(d[k] == (T) (a - b));
+            assert(p[k] == (T) (a * b));
+            assert(ng[k] == (T) (-a));
+            assert(ab[k] == (T) (a < 0 ? -a : a));
+            assert(sg[k] == (T) (a < 0 ? -1 : 0));
+            assert(z[k] == (T) -1);
+        }
+    }
+
+    std::cout << "Passed testPackedIntegers<" << (std::is_signed<T>::value ? "int" : "uint") << 8 * sizeof(T) << "x" << L << ">!" << std::endl;
+
+}
+
+void testInt64(){
+
+    // Initialize the vectors (with non-zero divisors of several magnitudes, avoiding the overflow of the division)
+    pim::vector<int64_t> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<int64_t> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = randLong(); ys[i] = randLong() >> (i % 64);
+        if(i % 8 == 0) ys[i] = xs[i];
+        if(ys[i] == 0 || (ys[i] == -1 && xs[i] == std::numeric_limits<int64_t>::min())) ys[i] = 1;
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Verify the arithmetic (few results are live at once, as every vector takes two registers)
+    {
+        pim::vector<int64_t> sum = x + y, difference = x - y, product = x * y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            uint64_t a = xs[i], b = ys[i];
+            assert(sum[i] == (int64_t) (a + b));
+            assert(difference[i] == (int64_t) (a - b));
+            assert(product[i] == (int64_t) (a * b));
+        }
+    }
+    {
+        pim::vector<int64_t> quotient = x / y, remainder = x % y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(quotient[i] == xs[i] / ys[i]);
+            assert(remainder[i] == xs[i] % ys[i]);
+        }
+    }
+    {
+        pim::vector<int64_t> negation = -x, abs = x.abs(), complement = ~x;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            uint64_t a = xs[i];
+            assert(negation[i] == (int64_t) (0 - a));
+            assert(abs[i] == (int64_t) (xs[i] < 0 ? 0 - a : a));
+            assert(complement[i] == ~xs[i]);
+        }
+    }
+    {
+        pim::vector<int> lt = x < y, eq = x == y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(lt[i] == (xs[i] < ys[i] ? -1 : 0));
+            assert(eq[i] == (xs[i] == ys[i] ? -1 : 0));
+        }
+    }
+
+    // Verify the reduction (through the moves of both words)
+    uint64_t total = 0;
+    for(int i = 0; i < NUM_ITERATIONS; i++) total += (uint64_t) xs[i];
+    assert(pim::sum(x) == (int64_t) total);
+
+    std::cout << "Passed testInt64!" << std::endl;
+
+}
+
+void testDouble(){
+
+    // Initialize the vectors (with non-zero divisors, and some equal elements)
+    pim::vector<double> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    pim::vector<float> f(NUM_ITERATIONS);
+    std::vector<double> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    std::vector<float> fs(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = randDouble(); ys[i] = randDouble() * 1e6; fs[i] = randFloat() * 1000.0f;
+        if(i % 8 == 0) ys[i] = xs[i];
+        if(ys[i] == 0.0) ys[i] = 1.0;
+        x[i] = xs[i]; y[i] = ys[i]; f[i] = fs[i];
+    }
+
+    // Verify the arithmetic (few results are live at once, as every vector takes two registers)
+    {
+        pim::vector<double> sum = x + y, difference = x - y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(sum[i] == xs[i] + ys[i]);
+            assert(difference[i] == xs[i] - ys[i]);
+        }
+    }
+    {
+        pim::vector<double> product = x * y, quotient = x / y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(product[i] == xs[i] * ys[i]);
+            assert(quotient[i] == xs[i] / ys[i]);
+        }
+    }
+    {
+        pim::vector<double> negation = -x, abs = x.abs();
+        pim::vector<int> lt = x < y, eq = x == y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(negation[i] == -xs[i]);
+            assert(abs[i] == std::abs(xs[i]));
+            assert(lt[i] == (xs[i] < ys[i] ? -1 : 0));
+            assert(eq[i] == (xs[i] == ys[i] ? -1 : 0));
+        }
+    }
+
+    // Verify the conversions
+    {
+        pim::vector<double> widened(f);
+        pim::vector<float> narrowed(x);
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(widened[i] == (double) fs[i]);
+            assert(narrowed[i] == (float) xs[i]);
+        }
+    }
+
+    std::cout << "Passed testDouble!" << std::endl;
+
+}
+
+/**
+ * Tests the routines of the given big-integer type against a word-by-word reference on the host
+ * @tparam T
+ */
+template <class T>
+void testBigIntegers(){
+
+    // Initialize the vectors (with some equal and nearly-equal elements, and some elements of a single word), of as
+    // many rows as the vectors of words
+    constexpr long n = NUM_ITERATIONS / T::words;
+    pim::vector<T> x(n), y(n);
+    std::vector<T> xs(n), ys(n);
+    for(int i = 0; i < n; i++){
+        for(uint32_t k = 0; k < T::words; k++){
+            xs[i].word[k] = ((uint32_t) randInt() << 16) ^ (uint32_t) randInt();
+            ys[i].word[k] = ((uint32_t) randInt() << 16) ^ (uint32_t) randInt();
+        }
+        if(i % 8 == 0) ys[i] = xs[i];
+        if(i % 8 == 1){
+            ys[i] = xs[i];
+            ys[i].word[i % T::words] ^= 1;
+        }
+        if(i % 8 == 2) ys[i] = T(ys[i].word[0]);
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Compute the reference results word by word
+    std::vector<T> ss(n), ds(n), ps(n);
+    std::vector<bool> less(n);
+    for(int i = 0; i < n; i++){
+        const T &a = xs[i], &b = ys[i];
+        uint64_t carry = 0, borrow = 0;
+        for(uint32_t k = 0; k < T::words; k++){
+            carry += (uint64_t) a.word[k] + b.word[k];
+            ss[i].word[k] = (uint32_t) carry;
+            carry >>= 32;
+            uint64_t diff = (uint64_t) a.word[k] - b.word[k] - borrow;
+            ds[i].word[k] = (uint32_t) diff;
+            borrow = diff >> 63;
+        }
+        for(uint32_t k = 0; k < T::words; k++){
+            carry = 0;
+            for(uint32_t j = 0; j + k < T::words; j++){
+                carry += (uint64_t) a.word[k] * b.word[j] + ps[i].word[j + k];
+                ps[i].word[j + k] = (uint32_t) carry;
+                carry >>= 32;
+            }
+        }
+        less[i] = borrow != 0;
+    }
+
+    // Perform the computation (the masks are stored at the first row of every element)
+    pim::vector<T> sum = x + y, difference = x - y, product = x * y;
+    pim::vector<pim::mask> lt = x < y, le = x <= y, gt = x > y, ge = x >= y, eq = x == y;
+    pim::vector<pim::mask> zero = difference.zero(), band = lt & ge, bnot = ~eq;
+
+    // Verify the results
+    for(int i = 0; i < n; i++){
+        assert(sum[i] == ss[i]);
+        assert(difference[i] == ds[i]);
+        assert(product[i] == ps[i]);
+        bool below = less[i], same = xs[i] == ys[i];
+        assert(lt[i] == below);
+        assert(le[i] == (below || same));
+        assert(gt[i] == (!below && !same));
+        assert(ge[i] == !below);
+        assert(eq[i] == same);
+        assert(zero[i] == same);
+        assert(band[i] == false);
+        assert(bnot[i] == !same);
+    }
+
+    // Perform and verify the addition in a range of the elements of every crossbar (given by their slots)
+    constexpr long slots = pim::CROSSBAR_HEIGHT / T::words;
+    x.setMask({1, slots - 2, 1});
+    pim::vector<T> range = x + y;
+    x.setMask({0, pim::CROSSBAR_HEIGHT - 1, 1});
+    for(int i = 0; i < n; i++) assert(range[i] == (i % slots == 0 || i % slots == slots - 1 ? T() : ss[i]));
+
+    std::cout << "Passed testBigIntegers<" << T::bits << ">!" << std::endl;
+
+}
+
+void testMasks(){
+
+    // Initialize the vectors
+    pim::vector<float> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<float> xs(NUM_ITERATIONS), ys(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xs[i] = randFloat(); ys[i] = i % 4 == 0 ? xs[i] : randFloat();
+        x[i] = xs[i]; y[i] = ys[i];
+    }
+
+    // Perform the computation (the masks share the partitions of their registers)
+    pim::vector<pim::mask> lt = x < y, le = x <= y, gt = x > y, ge = x >= y, eq = x == y;
+    pim::vector<pim::mask> band = lt & ge, bor = lt | eq, bxor = le ^ ge, bnot = ~gt, copy = le;
+    pim::vector<pim::mask> ones(NUM_ITERATIONS, true);
+    eq = eq ^ ones;
+    copy[0] = !copy[0];
+    pim::vector<int> expanded = lt;
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        float a = xs[i], b = ys[i];
+        assert(lt[i] == (a < b));
+        assert(le[i] == (a <= b));
+        assert(gt[i] == (a > b));
+        assert(ge[i] == (a >= b));
+        assert(eq[i] == (a != b));
+        assert(band[i] == false);
+        assert(bor[i] == (a <= b));
+        assert(bxor[i] == (a != b));
+        assert(bnot[i] == (a <= b));
+        assert(copy[i] == ((a <= b) != (i == 0)));
+        assert(ones[i] == true);
+        assert(expanded[i] == (a < b ? -1 : 0));
+    }
+
+    std::cout << "Passed testMasks!" << std::endl;
+
+}
+
+void testBitplaneStorage(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = randInt(); y[i] = randInt();
+    }
+
+    // Perform the computation with the bit-plane storage engine
+    pim::setStorageEngine(pim::StorageEngine::BITPLANES);
+    pim::vector<int> z = x * y + x;
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == (x[i] * y[i] + x[i]));
+    }
+    pim::setStorageEngine(pim::StorageEngine::WORDS);
+
+    // Verify the results after converting back
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == (x[i] * y[i] + x[i]));
+    }
+
+    std::cout << "Passed testBitplaneStorage!" << std::endl;
+
+}
+
+void testFunctionalBackend(){
+
+    // Initialize the vectors
+    pim::vector<float> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = randFloat(); y[i] = randFloat();
+    }
+
+    // Perform the computation at the gate level
+    pim::resetStatistics();
+    pim::vector<float> z = x * y + x;
+    std::map<std::string, pim::RoutineStatistics> gateStatistics = pim::getStatistics();
+
+    // Perform the computation natively, verifying every other call against the gate level (the first calls of the
+    // routines are sampled, and the second calls are only executed natively)
+    pim::setBackend(pim::Backend::FUNCTIONAL, 2);
+    pim::resetStatistics();
+    pim::vector<float> sampled = x * y + x;
+    std::map<std::string, pim::RoutineStatistics> sampledStatistics = pim::getStatistics();
+    pim::vector<float> native = x * y + x;
+    std::map<std::string, pim::RoutineStatistics> functionalStatistics = pim::getStatistics();
+    pim::setBackend(pim::Backend::GATE_LEVEL);
+
+    // Verify the results and the cycle counts of both calls
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(sampled[i] == z[i]);
+        assert(native[i] == z[i]);
+    }
+    for(const char *name : {"multiply<float>", "add<float>"}){
+        assert(sampledStatistics[name].calls == 1 && functionalStatistics[name].calls == 2);
+        assert(sampledStatistics[name].cycles == gateStatistics[name].cycles);
+        assert(functionalStatistics[name].cycles - sampledStatistics[name].cycles == gateStatistics[name].cycles);
+    }
+
+    // The overflowing integer division is undefined (as the division by zero), and thus not compared by the samples
+    pim::vector<int> minimum(NUM_ITERATIONS, std::numeric_limits<int>::min()), negativeOne(NUM_ITERATIONS, -1);
+    pim::setBackend(pim::Backend::FUNCTIONAL, 1);
+    pim::vector<int> quotient = minimum / negativeOne, remainder = minimum % negativeOne;
+    pim::setBackend(pim::Backend::GATE_LEVEL);
+
+    std::cout << "Passed testFunctionalBackend!" << std::endl;
+
+}
+
+void testDryRunBackend(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = rand(); y[i] = rand();
+    }
+
+    // Perform the computation at the gate level
+    pim::resetStatistics();
+    pim::vector<int> z = x * y;
+    std::map<std::string, pim::RoutineStatistics> gateStatistics = pim::getStatistics();
+
+    // Count the micro-operations of the same computation without simulating it
+    pim::setBackend(pim::Backend::DRY_RUN);
+    pim::setReadPlaceholder(42);
+    pim::resetStatistics();
+    pim::vector<int> w = x * y;
+    assert(w[0] == 42);
+    std::map<std::string, pim::RoutineStatistics> dryRunStatistics = pim::getStatistics();
+    pim::DryRunStatistics counts = pim::getDryRunStatistics();
+    x[0] = 0;
+    pim::setBackend(pim::Backend::GATE_LEVEL);
+
+    // Verify the counts
+    assert(dryRunStatistics["multiply<int>"].microoperations == gateStatistics["multiply<int>"].microoperations);
+    assert(dryRunStatistics["multiply<int>"].cycles == gateStatistics["multiply<int>"].cycles);
+    assert(counts.types[pim::MicrooperationType::READ] == 1);
+    assert(counts.types[pim::MicrooperationType::LOGIC] ==
+        counts.horizontalGates[pim::GateType::INIT0] + counts.horizontalGates[pim::GateType::INIT1] +
+        counts.horizontalGates[pim::GateType::NOT] + counts.horizontalGates[pim::GateType::NOR] +
+        counts.verticalGates[pim::GateType::INIT0] + counts.verticalGates[pim::GateType::INIT1] +
+        counts.verticalGates[pim::GateType::NOT] + counts.verticalGates[pim::GateType::NOR]);
+
+    // Verify that the memory state was not modified
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == x[i] * y[i]);
+    }
+
+    std::cout << "Passed testDryRunBackend!" << std::endl;
+
+}
+
+void testTrace(){
+
+    // Record the initialization and the computation
+    pim::startTrace("testTrace.trace");
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = rand(); y[i] = rand();
+    }
+    pim::resetStatistics();
+    pim::vector<int> z = x + y;
+    std::map<std::string, pim::RoutineStatistics> statistics = pim::getStatistics();
+    int result = z[7];
+    pim::stopTrace();
+
+    // Replay the trace, verifying the routine markers and the results of the reads
+    pim::size_t additions = 0, operations = 0, reads = 0;
+    pim::dtype lastResult = 0;
+    bool inAddition = false;
+    {
+        pim::TraceReader trace("testTrace.trace");
+        pim::TraceEntry entry = {};
+        while(trace.next(entry)){
+            if(entry.type == pim::TraceRecord::OPERATION){
+                lastResult = pim::perform(entry.operation);
+                if(inAddition) operations++;
+            }
+            else if(entry.type == pim::TraceRecord::READ_RESULT){
+                assert(lastResult == entry.result);
+                reads++;
+            }
+            else if(entry.type == pim::TraceRecord::BEGIN_ROUTINE){
+                inAddition = std::string(entry.routine.name) == "add<int>";
+                additions += inAddition;
+            }
+            else{
+                inAddition = false;
+            }
+        }
+    }
+    std::remove("testTrace.trace");
+
+    assert(additions == 1);
+    assert(operations == statistics["add<int>"].microoperations);
+    assert(reads == 1 && (int)lastResult == result);
+
+    std::cout << "Passed testTrace!" << std::endl;
+
+}
+
+void testGraph(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS), z(NUM_ITERATIONS);
+    pim::vector<int> a(NUM_ITERATIONS), b(NUM_ITERATIONS), c(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = rand(); y[i] = rand();
+        a[i] = rand(); b[i] = rand();
+    }
+
+    // Capture z = x * y + x
+    pim::beginCapture();
+    pim::multiply<int>(x.vec.reg, y.vec.reg, z.vec.reg, {x.vec.startArray, x.vec.endArray - 1, 1}, x.curr_mask);
+    pim::add<int>(z.vec.reg, x.vec.reg, z.vec.reg, {x.vec.startArray, x.vec.endArray - 1, 1}, x.curr_mask);
+    pim::Graph graph = pim::endCapture();
+
+    // Launch the graph as c = a * b + a
+    pim::resetStatistics();
+    pim::launch(graph, {{x.vec.reg, a.vec.reg}, {y.vec.reg, b.vec.reg}, {z.vec.reg, c.vec.reg}},
+                {a.vec.startArray, a.vec.endArray - 1, 1});
+    std::map<std::string, pim::RoutineStatistics> statistics = pim::getStatistics();
+
+    // Verify the results
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == x[i] * y[i] + x[i]);
+        assert(c[i] == a[i] * b[i] + a[i]);
+    }
+    assert(statistics["multiply<int>"].calls == 1 && statistics["add<int>"].calls == 1);
+    assert(statistics["multiply<int>"].cycles == graph.statistics["multiply<int>"].cycles);
+
+    std::cout << "Passed testGraph!" << std::endl;
+
+}
+
+void testSnapshot(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS), z(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = rand(); y[i] = rand();
+    }
+    int x0 = x[0];
+
+    pim::size_t handle = pim::snapshot();
+
+    // Branch z = x + y (with a modified input) from the snapshot
+    x[0] = x0 + 1;
+    z = x + y;
+    pim::address allocated = pim::malloc(NUM_ITERATIONS);
+    assert(z[0] == (x0 + 1) + y[0]);
+    pim::restore(handle);
+    assert(x[0] == x0 && z[0] == 0);
+
+    // Branch z = x - y from the same snapshot
+    z = x - y;
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == x[i] - y[i]);
+    }
+    pim::restore(handle);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == 0);
+    }
+
+    // Verify that the allocator state was restored
+    pim::address reallocated = pim::malloc(NUM_ITERATIONS);
+    assert(reallocated.reg == allocated.reg && reallocated.startArray == allocated.startArray);
+    pim::free(reallocated);
+
+    pim::releaseSnapshot(handle);
+
+    std::cout << "Passed testSnapshot!" << std::endl;
+
+}
+
+void testMemoryFile(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = rand(); y[i] = rand();
+    }
+
+    // Map the memory from a new file (initialized with the current state) and compute within it
+    const char *path = "testMemoryFile.state";
+    std::remove(path);
+    pim::mapMemoryFile(path);
+    pim::vector<int> z = x + y;
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert(z[i] == x[i] + y[i]);
+    }
+
+    // The file is sparse: only the crossbars that were written occupy its blocks (all of them in small geometries)
+    struct stat st = {};
+    assert(stat(path, &st) == 0);
+    if(pim::NUM_CROSSBARS >= 1024) assert((pim::size_t)st.st_blocks * 512 < (pim::size_t)st.st_size / 2);
+    int x0 = x[0];
+    pim::unmapMemoryFile();
+    assert(z[0] == x0 + y[0]);
+
+    // Resume from the existing file, which replaces the current state
+    x[0] = x0 + 1;
+    pim::mapMemoryFile(path);
+    assert(x[0] == x0 && z[0] == x0 + y[0]);
+    pim::unmapMemoryFile();
+    std::remove(path);
+
+    std::cout << "Passed testMemoryFile!" << std::endl;
+
+}
+
+void testShards(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    std::vector<int> xHost(NUM_ITERATIONS), yHost(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        xHost[i] = randInt(); yHost[i] = randInt();
+        x[i] = xHost[i]; y[i] = yHost[i];
+    }
+
+    for(pim::ShardTransport transport : {pim::ShardTransport::SHARED_MEMORY, pim::ShardTransport::SOCKET}){
+
+        // Hand the memory state over to the shards (bound to NUMA nodes, with huge-page rings), and compute within them
+        pim::setShardPlacement(true, transport == pim::ShardTransport::SHARED_MEMORY);
+        pim::startShards(3, transport);
+        pim::vector<int> z = x + y;
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(z[i] == xHost[i] + yHost[i]);
+        }
+
+        // Gather the memory state back
+        pim::stopShards();
+        for(int i = 0; i < NUM_ITERATIONS; i++){
+            assert(z[i] == xHost[i] + yHost[i]);
+        }
+
+    }
+
+    std::cout << "Passed testShards!" << std::endl;
+
+}
+
+void testAsync(){
+
+    // Initialize the vectors
+    pim::vector<int> x(NUM_ITERATIONS), y(NUM_ITERATIONS);
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        x[i] = randInt(); y[i] = randInt();
+    }
+
+    // Queue the computation, and read the results through futures
+    pim::setAsync(true);
+    pim::vector<int> z = x + y;
+    std::vector<std::future<pim::dtype>> results;
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        results.push_back(pim::readAsync(z.vec.startArray + i / pim::warpSize(), z.vec.reg, i % pim::warpSize()));
+    }
+    for(int i = 0; i < NUM_ITERATIONS; i++){
+        assert((int)results[i].get() == x[i] + y[i]);
+    }
+
+    // Errors of queued micro-operations are thrown by the next drain (an invalid crossbar mask), while the masks of the
+    // following routines are still applied (the element write is discarded, but its masks are those of the next read)
+    int first = x[0];
+    x[NUM_ITERATIONS - 1] = first + 2;
+    pim::perform(((((((pim::otype)1 << pim::LOG_NUM_CROSSBARS) | 0) << pim::LOG_NUM_CROSSBARS) | 1) << 3) |
+                 pim::MicrooperationType::MASK);
+    x[0] = first + 1;
+    bool thrown = false;
+    try{
+        pim::synchronize();
+    } catch(const std::runtime_error&){
+        thrown = true;
+    }
+    assert(thrown);
+    assert(x[0] == first);
+    pim::setAsync(false);
+
+    std::cout << "Passed testAsync!" << std::endl;
+
+}
+
+void testContexts(){
+
+    // Initialize the inputs of both threads
+    const long n = NUM_ITERATIONS / 2;
+    std::vector<int> xHost(2 * n), yHost(2 * n);
+    for(int i = 0; i < 2 * n; i++){
+        xHost[i] = randInt(); yHost[i] = randInt();
+    }
+
+    // Every thread computes concurrently within a context that owns half of the crossbars
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 2; t++){
+        threads.emplace_back([&, t]{
+
+            pim::context ctx(t * (pim::NUM_CROSSBARS / 2), pim::NUM_CROSSBARS / 2);
+            pim::setContext(ctx);
+
+            pim::vector<int> x(n), y(n);
+            for(int i = 0; i < n; i++){
+                x[i] = xHost[t * n + i]; y[i] = yHost[t * n + i];
+            }
+            pim::vector<int> z = x + y;
+            pim::vector<int> w = z - y;
+            for(int i = 0; i < n; i++){
+                assert(z[i] == xHost[t * n + i] + yHost[t * n + i]);
+                assert(w[i] == xHost[t * n + i]);
+            }
+            assert(z.vec.startArray >= t * (pim::NUM_CROSSBARS / 2) && z.vec.endArray <= (t + 1) * (pim::NUM_CROSSBARS / 2));
+
+            // The crossbars of the other context may not be accessed
+            bool thrown = false;
+            try{
+                pim::write((1 - t) * (pim::NUM_CROSSBARS / 2), z.vec.reg, 0, 0);
+            } catch(const std::runtime_error&){
+                thrown = true;
+            }
+            assert(thrown);
+
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    std::cout << "Passed testContexts!" << std::endl;
+
+}
+
+void testIssueQueues(){
+
+    // Two issue queues bound to the halves of the crossbars, driven alternately by a single thread
+    const long n = NUM_ITERATIONS / 2;
+    pim::context a(0, pim::NUM_CROSSBARS / 2), b(pim::NUM_CROSSBARS / 2, pim::NUM_CROSSBARS / 2);
+    pim::vector<int> scratch(1);
+    pim::setContext(a);
+    pim::vector<int> xa(n), ya(n), scratchA(1);
+    pim::setContext(b);
+    pim::vector<int> xb(n), yb(n);
+    for(int i = 0; i < n; i++){
+        pim::setContext(a);
+        xa[i] = randInt(); ya[i] = randInt();
+        pim::setContext(b);
+        xb[i] = randInt(); yb[i] = randInt();
+    }
+
+    // The queues proceed concurrently, so the elapsed cycles are the maximum across them
+    pim::resetStatistics();
+    pim::setContext(a);
+    pim::vector<int> za = xa + ya;
+    pim::setContext(b);
+    pim::vector<int> zb = xb + yb;
+    pim::vector<int> wb = zb - yb;
+    pim::IssueStatistics statistics = pim::getIssueStatistics();
+    assert(statistics.issuedCycles[a.handle] > 0 && statistics.issuedCycles[b.handle] > statistics.issuedCycles[a.handle]);
+    assert(statistics.elapsedCycles == statistics.issuedCycles[b.handle]);
+
+    // The process context waits for both queues, and the queues wait for it
+    pim::setContext(pim::processContext());
+    pim::write(scratch.vec.startArray, scratch.vec.reg, 0, 0);
+    assert(pim::getIssueStatistics().elapsedCycles == statistics.elapsedCycles + 1);
+    pim::setContext(a);
+    pim::write(scratchA.vec.startArray, scratchA.vec.reg, 0, 0);
+    assert(pim::getIssueStatistics().elapsedCycles == statistics.elapsedCycles + 2);
+
+    // Verify the results
+    for(int i = 0; i < n; i++){
+        pim::setContext(a);
+        int xaValue = xa[i], yaValue = ya[i], zaValue = za[i];
+        assert(zaValue == xaValue + yaValue);
+        pim::setContext(b);
+        assert(wb[i] == xb[i]);
+    }
+    pim::setContext(pim::processContext());
+
+    std::cout << "Passed testIssueQueues!" << std::endl;
+
+}
+
 void (*tests[])() = {
 
         testIntegerAddition,
@@ -374,6 +1262,41 @@ void (*tests[])() = {
         testBitwiseAND,
         testBitwiseXOR,
 
+        testNarrowIntegers<int8_t>,
+        testNarrowIntegers<int16_t>,
+        testNarrowIntegers<uint8_t>,
+        testNarrowIntegers<uint16_t>,
+        testUnsignedIntegers,
+        testFixed<pim::fixed<1, 7>>,
+        testFixed<pim::fixed<1, 15>>,
+        testFixed<pim::fixed<8, 8>>,
+        testPackedIntegers<int8_t, 4>,
+        testPackedIntegers<int16_t, 2>,
+        testPackedIntegers<uint8_t, 4>,
+        testPackedIntegers<uint16_t, 2>,
+        testNarrowFloats<pim::half>,
+        testNarrowFloats<pim::bfloat16>,
+        testNarrowFloats<pim::float_t<4, 3>>,
+        testNarrowFloats<pim::float_t<5, 2>>,
+        testInt64,
+        testDouble,
+        testBigIntegers<pim::uint_t<128>>,
+        testBigIntegers<pim::uint_t<256>>,
+        testBigIntegers<pim::uint_t<1024>>,
+        testMasks,
+
+        testBitplaneStorage,
+        testFunctionalBackend,
+        testDryRunBackend,
+        testTrace,
+        testGraph,
+        testSnapshot,
+        testMemoryFile,
+        testShards,
+        testAsync,
+        testContexts,
+        testIssueQueues,
+
 };
 
 int main(){
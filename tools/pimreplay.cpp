@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../pim/simulator.cuh"
+#include "../pim/trace.h"
+
+/**
+ * Replays a micro-operation trace (recorded with pim::startTrace) through the selected backend
+ *
+ * Usage: pimreplay <trace> [--backend gate|functional|dry-run] [--sampling <period>] [--engine words|bitplanes] [--verify]
+ *  --verify compares the results of the reads to the recorded results
+ */
+int main(int argc, char **argv) {
+
+    if(argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <trace> [--backend gate|functional|dry-run] [--sampling <period>] "
+                  << "[--engine words|bitplanes] [--verify]" << std::endl;
+        return 1;
+    }
+
+    // Parse the arguments
+    std::string path = argv[1];
+    pim::Backend backend = pim::Backend::GATE_LEVEL;
+    pim::StorageEngine engine = pim::StorageEngine::WORDS;
+    pim::size_t samplingPeriod = 0;
+    bool verify = false;
+    for(int i = 2; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--backend" && i + 1 < argc){
+            std::string value = argv[++i];
+            if(value == "gate") backend = pim::Backend::GATE_LEVEL;
+            else if(value == "functional") backend = pim::Backend::FUNCTIONAL;
+            else if(value == "dry-run") backend = pim::Backend::DRY_RUN;
+            else { std::cerr << "Unknown backend: " << value << std::endl; return 1; }
+        }
+        else if(arg == "--sampling" && i + 1 < argc){
+            samplingPeriod = std::stoll(argv[++i]);
+        }
+        else if(arg == "--engine" && i + 1 < argc){
+            std::string value = argv[++i];
+            if(value == "words") engine = pim::StorageEngine::WORDS;
+            else if(value == "bitplanes") engine = pim::StorageEngine::BITPLANES;
+            else { std::cerr << "Unknown storage engine: " << value << std::endl; return 1; }
+        }
+        else if(arg == "--verify"){
+            verify = true;
+        }
+        else{
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    pim::TraceReader trace(path);
+    pim::setStorageEngine(engine);
+    pim::setBackend(backend, samplingPeriod);
+    pim::resetStatistics();
+
+    // Stream the trace through the backend
+    pim::size_t operations = 0, mismatches = 0;
+    pim::dtype lastResult = 0;
+    pim::TraceEntry entry = {};
+    auto start = std::chrono::steady_clock::now();
+    while(trace.next(entry)){
+        switch(entry.type){
+            case pim::TraceRecord::OPERATION:
+                lastResult = pim::perform(entry.operation);
+                operations++;
+                break;
+            case pim::TraceRecord::READ_RESULT:
+                if(verify && lastResult != entry.result) mismatches++;
+                break;
+            case pim::TraceRecord::BEGIN_ROUTINE:
+                pim::beginRoutine(entry.routine);
+                break;
+            case pim::TraceRecord::END_ROUTINE:
+                pim::endRoutine();
+                break;
+        }
+    }
+    pim::synchronize();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Print the summary
+    std::cout << "Replayed " << operations << " micro-operations (" << trace.size() << " bytes) in " << seconds
+              << " s (" << (double)operations / seconds << " micro-operations/s)" << std::endl;
+    for(const auto& routine : pim::getStatistics()){
+        std::cout << routine.first << ": " << routine.second.calls << " calls, " << routine.second.microoperations
+                  << " micro-operations, " << routine.second.cycles << " cycles" << std::endl;
+    }
+    if(verify){
+        std::cout << mismatches << " read mismatches" << std::endl;
+        return mismatches == 0 ? 0 : 2;
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,29 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../pim/shard.h"
+
+/**
+ * A shard worker, launched by pim::startShards to simulate a contiguous range of crossbars
+ *
+ * Usage: pimshard shm|socket <endpoint> <first crossbar> <number of crossbars> [<NUMA node>]
+ */
+int main(int argc, char **argv) {
+
+    if(argc != 5 && argc != 6){
+        std::cerr << "Usage: " << argv[0] << " shm|socket <endpoint> <first crossbar> <number of crossbars> [<NUMA node>]" << std::endl;
+        return 1;
+    }
+
+    std::string transport = argv[1];
+    try{
+        pim::serveShard(transport == "socket" ? pim::ShardTransport::SOCKET : pim::ShardTransport::SHARED_MEMORY,
+                        argv[2], std::stoll(argv[3]), std::stoll(argv[4]), argc == 6 ? std::stoi(argv[5]) : -1);
+    } catch(const std::exception& e){
+        std::cerr << "pimshard: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+
+}